@@ -8,15 +8,17 @@
 # include <ctime>
 # include <string>
 # include "ResponseData.hpp"
+# include "RequestBody.hpp"
+# include "TimerWheel.hpp"
 
 struct CGIData
 {
     pid_t pid = -1;
     int fd_stdin = -1;
     int fd_stdout = -1;
-    time_t start_time;
+    TimerNode timer; // cgi_timeout, armed by the Server
     bool addedToEpoll = false;
-    std::string input;
+    RequestBody input; // spliced in if it was spooled to disk
     std::string output;
     size_t input_sent = 0;
     ResponseData* response = nullptr;
@@ -1,6 +1,6 @@
 #include "CGIManager.hpp"
 
-CGIData CGIManager::startCGI(const RequestData& req, Client& client,
+CGIData CGIManager::startCGI(RequestData& req, Client& client,
                              const std::string& interpreter,
                              const std::string& scriptPath)
 {
@@ -8,47 +8,56 @@ CGIData CGIManager::startCGI(const RequestData& req, Client& client,
     DBG("[CGIManager] scriptPath = " << scriptPath
                                      << ", interpreter = " << interpreter);
 
+    // Everything the child needs is prepared before fork: with several
+    // reactor threads only async-signal-safe calls are allowed in the child
+    std::vector<char*> c_args;
+    c_args.push_back(const_cast<char*>(interpreter.c_str()));
+    c_args.push_back(const_cast<char*>(scriptPath.c_str()));
+    c_args.push_back(nullptr);
+
+    std::vector<std::string> envVec
+        = buildEnvFromRequest(req, client, scriptPath);
+    std::vector<char*> c_env;
+    for (auto& e : envVec)
+        c_env.push_back(const_cast<char*>(e.c_str()));
+    c_env.push_back(nullptr);
+
     int pipe_in[2], pipe_out[2];
 
-    if (pipe(pipe_out) == -1)
+    // O_CLOEXEC so CGIs forked by other threads don't inherit these pipes
+    if (pipe2(pipe_out, O_CLOEXEC) == -1)
         throw std::runtime_error("Failed to create pipes");
 
-    if (pipe(pipe_in) == -1)
+    if (pipe2(pipe_in, O_CLOEXEC) == -1)
+    {
+        close(pipe_out[0]);
+        close(pipe_out[1]);
         throw std::runtime_error("Failed to create pipes");
+    }
 
     pid_t pid = fork();
     if (pid < 0)
+    {
+        close(pipe_in[0]);
+        close(pipe_in[1]);
+        close(pipe_out[0]);
+        close(pipe_out[1]);
         throw std::runtime_error("fork failed for CGI");
+    }
 
     if (pid == 0)
     {
         if (dup2(pipe_in[0], STDIN_FILENO) == -1
             || dup2(pipe_out[1], STDOUT_FILENO) == -1
             || dup2(pipe_out[1], STDERR_FILENO) == -1)
-        {
-            std::cerr << "dup2 failed" << std::endl;
             _exit(1);
-        }
 
         close(pipe_in[0]);
         close(pipe_in[1]);
         close(pipe_out[0]);
         close(pipe_out[1]);
 
-        std::vector<char*> c_args;
-        c_args.push_back(const_cast<char*>(interpreter.c_str()));
-        c_args.push_back(const_cast<char*>(scriptPath.c_str()));
-        c_args.push_back(nullptr);
-
-        std::vector<std::string> envVec
-            = buildEnvFromRequest(req, client, scriptPath);
-        std::vector<char*> c_env;
-        for (auto& e : envVec)
-            c_env.push_back(const_cast<char*>(e.c_str()));
-        c_env.push_back(nullptr);
-
         execve(interpreter.c_str(), c_args.data(), c_env.data());
-        std::cerr << "execve failed" << std::endl;
         _exit(1);
     }
     else
@@ -62,25 +71,8 @@ CGIData CGIManager::startCGI(const RequestData& req, Client& client,
         flags = fcntl(pipe_out[0], F_GETFL, 0);
         fcntl(pipe_out[0], F_SETFL, flags | O_NONBLOCK);
 
-        epoll_event ev_out;
-        ev_out.data.fd = pipe_out[0];
-        ev_out.events = EPOLLIN | EPOLLRDHUP;
-
-        if (epoll_ctl(client.getEpollFd(), EPOLL_CTL_ADD, pipe_out[0], &ev_out)
-            == -1)
-            std::cerr << "epoll_ctl ADD pipe_out failed" << std::endl;
-
-        if (req.method == HttpMethod::POST)
-        {
-            epoll_event ev_in;
-            ev_in.data.fd = pipe_in[1];
-            ev_in.events = EPOLLOUT;
-            if (epoll_ctl(client.getEpollFd(), EPOLL_CTL_ADD, pipe_in[1],
-                          &ev_in)
-                == -1)
-                std::cerr << "epoll_ctl ADD pipe_in failed" << std::endl;
-        }
-        else
+        // The pipes are registered for events by the Server
+        if (req.method != HttpMethod::POST)
         {
             close(pipe_in[1]);
             pipe_in[1] = -1;
@@ -91,8 +83,7 @@ CGIData CGIManager::startCGI(const RequestData& req, Client& client,
         cgi.pid = pid;
         cgi.fd_stdin = pipe_in[1];
         cgi.fd_stdout = pipe_out[0];
-        cgi.start_time = std::time(nullptr);
-        cgi.input = req.body;
+        cgi.input = std::move(req.body);
 
         return cgi;
     }
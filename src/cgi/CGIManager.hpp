@@ -9,7 +9,6 @@
 # include <cstring>
 # include <stdexcept>
 # include <arpa/inet.h>
-# include <sys/epoll.h>
 
 # include "Client.hpp"
 # include "RequestData.hpp"
@@ -24,7 +23,7 @@ class CGIManager
     ~CGIManager() = delete;
 
     // Methods
-    static CGIData startCGI(const RequestData& req, Client& client,
+    static CGIData startCGI(RequestData& req, Client& client,
                             const std::string& interpreter,
                             const std::string& scriptPath);
 
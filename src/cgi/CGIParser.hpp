@@ -7,10 +7,12 @@
 # include <string_view>
 # include <unordered_map>
 
+# include "HeaderMap.hpp"
+
 struct ParsedCGI
 {
     int status = 200;
-    std::unordered_map<std::string, std::string> headers;
+    HeaderMap headers;
     std::string body;
     bool is_redirect = false;
 };
@@ -10,13 +10,17 @@ Config::Config(std::unique_ptr<Directive> ast)
     if (!mainNode)
         throw std::invalid_argument("AST root node is not a block directive");
 
-    m_httpBlock = buildHttpBlock(mainNode->directives()[0]);
+    m_globalBlock = buildGlobalBlock(mainNode);
+    m_httpBlock = buildHttpBlock(findHttpNode(mainNode));
     Validator::validate(m_httpBlock);
+    m_errorPages = buildErrorPages(m_httpBlock);
 }
 
 // Move constructor
 Config::Config(Config&& other) noexcept
-  : m_httpBlock(std::move(other.m_httpBlock))
+  : m_globalBlock(std::move(other.m_globalBlock))
+  , m_httpBlock(std::move(other.m_httpBlock))
+  , m_errorPages(std::move(other.m_errorPages))
 {
 }
 
@@ -25,7 +29,9 @@ Config& Config::operator=(Config&& other) noexcept
 {
     if (this != &other)
     {
+        m_globalBlock = std::move(other.m_globalBlock);
         m_httpBlock = std::move(other.m_httpBlock);
+        m_errorPages = std::move(other.m_errorPages);
     }
     return (*this);
 }
@@ -60,6 +66,78 @@ std::vector<NetworkEndpoint> Config::getAllEndpoints() const
     return {endpoints.begin(), endpoints.end()};
 }
 
+size_t Config::workerThreads() const
+{
+    if (!m_globalBlock.workerThreads.isSet())
+        return GlobalBlock::DEFAULT_WORKER_THREADS;
+    return m_globalBlock.workerThreads;
+}
+
+// 0 when the directive is absent: everything runs in the main process
+size_t Config::workerProcesses() const
+{
+    if (!m_globalBlock.workerProcesses.isSet())
+        return 0;
+    return m_globalBlock.workerProcesses;
+}
+
+bool Config::edgeTriggered() const
+{
+    return m_globalBlock.edgeTriggered.isSet() && m_globalBlock.edgeTriggered;
+}
+
+EventBackend Config::eventBackend() const
+{
+    if (!m_globalBlock.eventBackend.isSet())
+        return EventBackend::Epoll;
+    return m_globalBlock.eventBackend;
+}
+
+Timeouts Config::timeouts() const
+{
+    Timeouts timeouts;
+
+    if (m_httpBlock.clientHeaderTimeout.isSet())
+        timeouts.clientHeader = m_httpBlock.clientHeaderTimeout;
+    if (m_httpBlock.clientBodyTimeout.isSet())
+        timeouts.clientBody = m_httpBlock.clientBodyTimeout;
+    if (m_httpBlock.sendTimeout.isSet())
+        timeouts.send = m_httpBlock.sendTimeout;
+    if (m_httpBlock.keepaliveTimeout.isSet())
+        timeouts.keepalive = m_httpBlock.keepaliveTimeout;
+    if (m_httpBlock.cgiTimeout.isSet())
+        timeouts.cgi = m_httpBlock.cgiTimeout;
+    return timeouts;
+}
+
+// Off (no entries) unless 'open_file_cache' is given
+OpenFileCache::Settings Config::openFileCache() const
+{
+    OpenFileCache::Settings settings;
+
+    if (m_httpBlock.openFileCache.isSet())
+        settings.maxEntries = m_httpBlock.openFileCache;
+    if (m_httpBlock.openFileCacheValid.isSet())
+        settings.validMs = m_httpBlock.openFileCacheValid;
+    if (m_httpBlock.openFileCacheMinUses.isSet())
+        settings.minUses = m_httpBlock.openFileCacheMinUses;
+    if (m_httpBlock.openFileCacheErrors.isSet())
+        settings.cacheErrors = m_httpBlock.openFileCacheErrors;
+    return settings;
+}
+
+// Off (no budget) unless 'response_cache' is given
+ResponseCache::Settings Config::responseCache() const
+{
+    ResponseCache::Settings settings;
+
+    if (m_httpBlock.responseCache.isSet())
+        settings.maxBytes = m_httpBlock.responseCache;
+    if (m_httpBlock.responseCacheMaxFile.isSet())
+        settings.maxFileSize = m_httpBlock.responseCacheMaxFile;
+    return settings;
+}
+
 RequestContext Config::createRequestContext(const NetworkEndpoint& endpoint,
                                             const std::string& host,
                                             const std::string& uri) const
@@ -67,10 +145,58 @@ RequestContext Config::createRequestContext(const NetworkEndpoint& endpoint,
     return RequestResolver::resolve(m_httpBlock, endpoint, host, uri);
 }
 
+BodySettings Config::bodySettings(const NetworkEndpoint& endpoint,
+                                  const std::string& host,
+                                  const std::string& uri) const
+{
+    return RequestResolver::resolveBodySettings(m_httpBlock, endpoint, host, uri);
+}
+
+// Empty when the page wasn't preloaded, it is served like a request then
+CachedResponse Config::errorPage(const NetworkEndpoint& endpoint,
+                                 const std::string& host,
+                                 const std::string& uri) const
+{
+    const ServerBlock& server = RequestResolver::matchServerBlock(
+        m_httpBlock.servers, endpoint, host);
+    return m_errorPages.customPage(&server - m_httpBlock.servers->data(), uri);
+}
+
 ///----------------------------///
 ///----------------------------///
 ///----------------------------///
 
+GlobalBlock Config::buildGlobalBlock(const BlockDirective* mainNode)
+{
+    GlobalBlock globalBlock;
+
+    for (const auto& directive : mainNode->directives())
+    {
+        const std::string& name = directive->name();
+        const std::vector<Argument>& args = directive->args();
+        if (name == Directives::WORKER_THREADS)
+            globalBlock.workerThreads = Converter::toWorkerCount(args[0]);
+        else if (name == Directives::WORKER_PROCESSES)
+            globalBlock.workerProcesses = Converter::toWorkerCount(args[0]);
+        else if (name == Directives::EDGE_TRIGGERED)
+            assign(globalBlock.edgeTriggered, args);
+        else if (name == Directives::EVENT_BACKEND)
+            globalBlock.eventBackend = Converter::toEventBackend(args[0]);
+    }
+
+    return globalBlock;
+}
+
+const std::unique_ptr<Directive>& Config::findHttpNode(
+    const BlockDirective* mainNode)
+{
+    for (const auto& directive : mainNode->directives())
+        if (directive->name() == Directives::HTTP)
+            return directive;
+
+    throw std::invalid_argument("AST has no 'http' block");
+}
+
 HttpBlock Config::buildHttpBlock(const std::unique_ptr<Directive>& httpNode)
 {
     HttpBlock httpBlock;
@@ -87,6 +213,10 @@ HttpBlock Config::buildHttpBlock(const std::unique_ptr<Directive>& httpNode)
         }
         else if (name == Directives::CLIENT_MAX_BODY_SIZE)
             assign(httpBlock.clientMaxBodySize, args);
+        else if (name == Directives::CLIENT_BODY_BUFFER_SIZE)
+            assign(httpBlock.clientBodyBufferSize, args);
+        else if (name == Directives::CLIENT_BODY_TEMP_PATH)
+            assign(httpBlock.clientBodyTempPath, args);
         else if (name == Directives::ERROR_PAGE)
             assign(httpBlock.errorPages, args);
         else if (name == Directives::ROOT)
@@ -95,6 +225,38 @@ HttpBlock Config::buildHttpBlock(const std::unique_ptr<Directive>& httpNode)
             assign(httpBlock.index, args);
         else if (name == Directives::AUTOINDEX)
             assign(httpBlock.autoindex, args);
+        else if (name == Directives::GZIP_STATIC)
+            httpBlock.gzipStatic = Converter::toGzipStatic(args[0]);
+        else if (name == Directives::GZIP)
+            assign(httpBlock.gzip, args);
+        else if (name == Directives::GZIP_TYPES)
+            assign(httpBlock.gzipTypes, args);
+        else if (name == Directives::GZIP_MIN_LENGTH)
+            assign(httpBlock.gzipMinLength, args);
+        else if (name == Directives::GZIP_COMP_LEVEL)
+            httpBlock.gzipCompLevel = Converter::toCompressionLevel(args[0]);
+        else if (name == Directives::CLIENT_HEADER_TIMEOUT)
+            httpBlock.clientHeaderTimeout = Converter::toDuration(args[0]);
+        else if (name == Directives::CLIENT_BODY_TIMEOUT)
+            httpBlock.clientBodyTimeout = Converter::toDuration(args[0]);
+        else if (name == Directives::SEND_TIMEOUT)
+            httpBlock.sendTimeout = Converter::toDuration(args[0]);
+        else if (name == Directives::KEEPALIVE_TIMEOUT)
+            httpBlock.keepaliveTimeout = Converter::toDuration(args[0]);
+        else if (name == Directives::CGI_TIMEOUT)
+            httpBlock.cgiTimeout = Converter::toDuration(args[0]);
+        else if (name == Directives::OPEN_FILE_CACHE)
+            httpBlock.openFileCache = Converter::toCount(args[0]);
+        else if (name == Directives::OPEN_FILE_CACHE_VALID)
+            httpBlock.openFileCacheValid = Converter::toDuration(args[0]);
+        else if (name == Directives::OPEN_FILE_CACHE_MIN_USES)
+            httpBlock.openFileCacheMinUses = Converter::toCount(args[0]);
+        else if (name == Directives::OPEN_FILE_CACHE_ERRORS)
+            assign(httpBlock.openFileCacheErrors, args);
+        else if (name == Directives::RESPONSE_CACHE)
+            assign(httpBlock.responseCache, args);
+        else if (name == Directives::RESPONSE_CACHE_MAX_FILE)
+            assign(httpBlock.responseCacheMaxFile, args);
     }
 
     return httpBlock;
@@ -125,10 +287,24 @@ ServerBlock Config::buildServerBlock(
             assign(serverBlock.errorPages, args);
         else if (name == Directives::CLIENT_MAX_BODY_SIZE)
             assign(serverBlock.clientMaxBodySize, args);
+        else if (name == Directives::CLIENT_BODY_BUFFER_SIZE)
+            assign(serverBlock.clientBodyBufferSize, args);
+        else if (name == Directives::CLIENT_BODY_TEMP_PATH)
+            assign(serverBlock.clientBodyTempPath, args);
         else if (name == Directives::INDEX)
             assign(serverBlock.index, args);
         else if (name == Directives::AUTOINDEX)
             assign(serverBlock.autoindex, args);
+        else if (name == Directives::GZIP_STATIC)
+            serverBlock.gzipStatic = Converter::toGzipStatic(args[0]);
+        else if (name == Directives::GZIP)
+            assign(serverBlock.gzip, args);
+        else if (name == Directives::GZIP_TYPES)
+            assign(serverBlock.gzipTypes, args);
+        else if (name == Directives::GZIP_MIN_LENGTH)
+            assign(serverBlock.gzipMinLength, args);
+        else if (name == Directives::GZIP_COMP_LEVEL)
+            serverBlock.gzipCompLevel = Converter::toCompressionLevel(args[0]);
         else if (name == Directives::RETURN)
             assign(serverBlock.httpRedirection, args);
         else if (name == Directives::UPLOAD_STORE)
@@ -165,6 +341,16 @@ LocationBlock Config::buildLocationBlock(
             assign(locationBlock.alias, args);
         else if (name == Directives::AUTOINDEX)
             assign(locationBlock.autoindex, args);
+        else if (name == Directives::GZIP_STATIC)
+            locationBlock.gzipStatic = Converter::toGzipStatic(args[0]);
+        else if (name == Directives::GZIP)
+            assign(locationBlock.gzip, args);
+        else if (name == Directives::GZIP_TYPES)
+            assign(locationBlock.gzipTypes, args);
+        else if (name == Directives::GZIP_MIN_LENGTH)
+            assign(locationBlock.gzipMinLength, args);
+        else if (name == Directives::GZIP_COMP_LEVEL)
+            locationBlock.gzipCompLevel = Converter::toCompressionLevel(args[0]);
         else if (name == Directives::INDEX)
             assign(locationBlock.index, args);
         else if (name == Directives::LIMIT_EXCEPT)
@@ -175,6 +361,10 @@ LocationBlock Config::buildLocationBlock(
             assign(locationBlock.httpRedirection, args);
         else if (name == Directives::CLIENT_MAX_BODY_SIZE)
             assign(locationBlock.clientMaxBodySize, args);
+        else if (name == Directives::CLIENT_BODY_BUFFER_SIZE)
+            assign(locationBlock.clientBodyBufferSize, args);
+        else if (name == Directives::CLIENT_BODY_TEMP_PATH)
+            assign(locationBlock.clientBodyTempPath, args);
         else if (name == Directives::UPLOAD_STORE)
             assign(locationBlock.uploadStore, args);
         else if (name == Directives::CGI_PASS)
@@ -184,6 +374,44 @@ LocationBlock Config::buildLocationBlock(
     return locationBlock;
 }
 
+// Every error_page target a server can redirect to, resolved as a GET
+// from that server would be. Targets that a GET wouldn't simply read
+// from disk are left to the regular request path.
+ErrorPages Config::buildErrorPages(const HttpBlock& httpBlock)
+{
+    ErrorPages pages;
+
+    for (size_t i = 0; i < httpBlock.servers->size(); ++i)
+    {
+        const ServerBlock& server = (*httpBlock.servers)[i];
+
+        std::set<std::string> uris;
+        for (const ErrorPage& page : httpBlock.errorPages)
+            uris.insert(page.filePath);
+        for (const ErrorPage& page : server.errorPages)
+            uris.insert(page.filePath);
+        for (const LocationBlock& location : server.locations)
+            for (const ErrorPage& page : location.errorPages)
+                uris.insert(page.filePath);
+
+        for (const std::string& uri : uris)
+        {
+            RequestContext ctx = RequestResolver::resolve(httpBlock, server, uri);
+            const std::vector<HttpMethod>& methods = ctx.allowed_methods;
+            if (ctx.redirection.isSet
+                || std::find(methods.begin(), methods.end(), HttpMethod::GET)
+                       == methods.end()
+                || ctx.cgi_pass.count(FileUtils::getFileExtension(uri)))
+                continue;
+
+            pages.add(i, uri, ctx.resolved_path,
+                      FileUtils::detectMimeType(ctx.resolved_path));
+        }
+    }
+
+    return pages;
+}
+
 ///----------------///
 ///----------------///
 ///----------------///
@@ -3,6 +3,8 @@
 #ifndef CONFIG_HPP
 # define CONFIG_HPP
 
+# include <algorithm>
+# include <set>
 # include <utility>
 # include <vector>
 # include <memory>
@@ -17,9 +19,15 @@
 # include "Validator.hpp"
 # include "Converter.hpp"
 
+# include "GlobalBlock.hpp"
 # include "HttpBlock.hpp"
 # include "ServerBlock.hpp"
 # include "LocationBlock.hpp"
+# include "Timeouts.hpp"
+# include "OpenFileCache.hpp"
+# include "ResponseCache.hpp"
+# include "ErrorPages.hpp"
+# include "FileUtils.hpp"
 
 # include "RequestResolver.hpp"
 
@@ -40,20 +48,39 @@ class Config
     // Methods
     static Config fromFile(const std::string& filepath);
     std::vector<NetworkEndpoint> getAllEndpoints() const;
+    size_t workerThreads() const;
+    size_t workerProcesses() const;
+    bool edgeTriggered() const;
+    EventBackend eventBackend() const;
+    Timeouts timeouts() const;
+    OpenFileCache::Settings openFileCache() const;
+    ResponseCache::Settings responseCache() const;
     RequestContext createRequestContext(const NetworkEndpoint& endpoint,
                                         const std::string& host,
                                         const std::string& uri) const;
+    BodySettings bodySettings(const NetworkEndpoint& endpoint,
+                              const std::string& host,
+                              const std::string& uri) const;
+    CachedResponse errorPage(const NetworkEndpoint& endpoint,
+                             const std::string& host,
+                             const std::string& uri) const;
 
   private:
     // Properties
+    GlobalBlock m_globalBlock;
     HttpBlock m_httpBlock;
+    ErrorPages m_errorPages;
 
     // Methods
+    static GlobalBlock buildGlobalBlock(const BlockDirective* mainNode);
+    static const std::unique_ptr<Directive>& findHttpNode(
+        const BlockDirective* mainNode);
     static HttpBlock buildHttpBlock(const std::unique_ptr<Directive>& httpNode);
     static ServerBlock buildServerBlock(
         const std::unique_ptr<Directive>& serverNode);
     static LocationBlock buildLocationBlock(
         const std::unique_ptr<Directive>& locationNode);
+    static ErrorPages buildErrorPages(const HttpBlock& httpBlock);
 
     static void assign(Property<std::string>& property,
                        const std::vector<Argument>& args);
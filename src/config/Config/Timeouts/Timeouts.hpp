@@ -0,0 +1,19 @@
+#pragma once
+
+#ifndef TIMEOUTS_HPP
+# define TIMEOUTS_HPP
+
+# include <cstddef>
+
+// Per-phase connection and CGI timeouts in milliseconds,
+// with nginx's defaults for the directives that are absent
+struct Timeouts
+{
+    size_t clientHeader = 60 * 1000;
+    size_t clientBody = 60 * 1000;
+    size_t send = 60 * 1000;
+    size_t keepalive = 75 * 1000;
+    size_t cgi = 20 * 1000;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#ifndef GLOBALBLOCK_HPP
+# define GLOBALBLOCK_HPP
+
+# include <cstddef>
+
+# include "Property.hpp"
+# include "Poller.hpp"
+
+// Process-wide settings that live outside of the 'http' block
+// and don't take part in request resolution
+struct GlobalBlock
+{
+    // Constants
+    static constexpr size_t DEFAULT_WORKER_THREADS = 1;
+    // Properties
+    Property<size_t> workerThreads{};
+    Property<size_t> workerProcesses{};
+    Property<bool> edgeTriggered{};
+    Property<EventBackend> eventBackend{};
+};
+
+#endif
@@ -19,9 +19,30 @@ struct HttpBlock : public ConfigBlock
     Property<std::vector<ServerBlock>> servers;
     Property<std::vector<ErrorPage>> errorPages;
     Property<size_t> clientMaxBodySize{};
+    Property<size_t> clientBodyBufferSize{};
+    Property<std::string> clientBodyTempPath;
     Property<std::string> root;
     Property<bool> autoindex{};
+    Property<GzipStatic> gzipStatic{};
+    Property<bool> gzip{};
+    Property<std::vector<std::string>> gzipTypes;
+    Property<size_t> gzipMinLength{};
+    Property<size_t> gzipCompLevel{};
     Property<std::vector<std::string>> index;
+    // Connection and CGI timeouts in milliseconds
+    Property<size_t> clientHeaderTimeout{};
+    Property<size_t> clientBodyTimeout{};
+    Property<size_t> sendTimeout{};
+    Property<size_t> keepaliveTimeout{};
+    Property<size_t> cgiTimeout{};
+    // Open file cache
+    Property<size_t> openFileCache{};
+    Property<size_t> openFileCacheValid{};
+    Property<size_t> openFileCacheMinUses{};
+    Property<bool> openFileCacheErrors{};
+    // Response cache
+    Property<size_t> responseCache{};
+    Property<size_t> responseCacheMaxFile{};
     // Methods
     void applyTo(EffectiveConfig& config) const override;
 };
@@ -10,10 +10,17 @@ void LocationBlock::applyTo(EffectiveConfig& config) const
 
     applyIfSet(errorPages, config.error_pages, AppendTail{});
     applyIfSet(clientMaxBodySize, config.client_max_body_size, Replace{});
+    applyIfSet(clientBodyBufferSize, config.client_body_buffer_size, Replace{});
+    applyIfSet(clientBodyTempPath, config.client_body_temp_path, Replace{});
     applyIfSet(acceptedHttpMethods, config.allowed_methods, Replace{});
     applyIfSet(root, config.root, Replace{});
     applyIfSet(alias, config.alias, Replace{});
     applyIfSet(autoindex, config.autoindex_enabled, Replace{});
+    applyIfSet(gzipStatic, config.gzip_static, Replace{});
+    applyIfSet(gzip, config.gzip.enabled, Replace{});
+    applyIfSet(gzipTypes, config.gzip.types, Replace{});
+    applyIfSet(gzipMinLength, config.gzip.minLength, Replace{});
+    applyIfSet(gzipCompLevel, config.gzip.level, Replace{});
     applyIfSet(index, config.index_files, Replace{});
     applyIfSet(uploadStore, config.upload_store, Replace{});
     applyIfSet(cgiPass, config.cgi_pass, MergeMap{});
@@ -7,10 +7,17 @@ void ServerBlock::applyTo(EffectiveConfig& config) const
     using namespace DirectiveAppliers;
 
     applyIfSet(clientMaxBodySize, config.client_max_body_size, Replace{});
+    applyIfSet(clientBodyBufferSize, config.client_body_buffer_size, Replace{});
+    applyIfSet(clientBodyTempPath, config.client_body_temp_path, Replace{});
     applyIfSet(errorPages, config.error_pages, AppendTail{});
     applyIfSet(root, config.root, Replace{});
     applyIfSet(alias, config.alias, Replace{});
     applyIfSet(autoindex, config.autoindex_enabled, Replace{});
+    applyIfSet(gzipStatic, config.gzip_static, Replace{});
+    applyIfSet(gzip, config.gzip.enabled, Replace{});
+    applyIfSet(gzipTypes, config.gzip.types, Replace{});
+    applyIfSet(gzipMinLength, config.gzip.minLength, Replace{});
+    applyIfSet(gzipCompLevel, config.gzip.level, Replace{});
     applyIfSet(index, config.index_files, Replace{});
     applyIfSet(uploadStore, config.upload_store, Replace{});
     applyIfSet(cgiPass, config.cgi_pass, MergeMap{});
@@ -30,8 +30,15 @@ struct ServerBlock : public ConfigBlock
     Property<std::string> alias;
     Property<std::vector<ErrorPage>> errorPages;
     Property<size_t> clientMaxBodySize{};
+    Property<size_t> clientBodyBufferSize{};
+    Property<std::string> clientBodyTempPath;
     Property<HttpRedirection> httpRedirection;
     Property<bool> autoindex{};
+    Property<GzipStatic> gzipStatic{};
+    Property<bool> gzip{};
+    Property<std::vector<std::string>> gzipTypes;
+    Property<size_t> gzipMinLength{};
+    Property<size_t> gzipCompLevel{};
     Property<std::vector<std::string>> index;
     Property<std::string> uploadStore;
     Property<std::map<std::string, std::string>> cgiPass;
@@ -10,15 +10,21 @@
 # include "HttpMethod.hpp"
 # include "HttpRedirection.hpp"
 # include "ErrorPage.hpp"
+# include "GzipStatic.hpp"
+# include "GzipSettings.hpp"
 
 struct EffectiveConfig
 {
     std::string matched_location = "/";
     size_t client_max_body_size = 1024 * 1024;
+    size_t client_body_buffer_size = 16 * 1024;
+    std::string client_body_temp_path = "/tmp";
     std::vector<ErrorPage> error_pages{};
     std::string root = "/var/www";
     std::string alias{};
     bool autoindex_enabled = false;
+    GzipStatic gzip_static = GzipStatic::Off;
+    GzipSettings gzip{};
     std::vector<std::string> index_files = {"index.html"};
     std::string upload_store{};
     std::map<std::string, std::string> cgi_pass{};
@@ -11,6 +11,8 @@
 # include "HttpRedirection.hpp"
 # include "HttpStatusCode.hpp"
 # include "ErrorPage.hpp"
+# include "GzipStatic.hpp"
+# include "GzipSettings.hpp"
 
 struct RequestContext
 {
@@ -20,6 +22,8 @@ struct RequestContext
     std::string resolved_path{};
     std::vector<std::string> index_files{};
     bool autoindex_enabled{};
+    GzipStatic gzip_static{};
+    GzipSettings gzip{};
     std::map<HttpStatusCode, std::string> error_pages{};
     std::string upload_store{};
     std::map<std::string, std::string> cgi_pass{};
@@ -7,20 +7,72 @@ RequestContext RequestResolver::resolve(const HttpBlock& httpBlock,
                                         const std::string& host,
                                         const std::string& uri)
 {
-    EffectiveConfig config
-        = createEffectiveConfig(httpBlock, endpoint, host, uri);
+    const ServerBlock& serverBlock
+        = matchServerBlock(httpBlock.servers, endpoint, host);
+    return resolve(httpBlock, serverBlock, uri);
+}
+
+// For a server that is already known, e.g. when preloading its error pages
+RequestContext RequestResolver::resolve(const HttpBlock& httpBlock,
+                                        const ServerBlock& serverBlock,
+                                        const std::string& uri)
+{
+    EffectiveConfig config = createEffectiveConfig(httpBlock, serverBlock, uri);
     return createContext(config, uri);
 }
 
-EffectiveConfig RequestResolver::createEffectiveConfig(
-    const HttpBlock& httpBlock, const NetworkEndpoint& endpoint,
-    const std::string& host, const std::string& uri)
+namespace
 {
-    EffectiveConfig config;
+    // The value of the innermost block that sets it
+    template <typename T>
+    const T& mostSpecific(const Property<T>& http, const Property<T>& server,
+                          const Property<T>* location, const T& fallback)
+    {
+        if (location && location->isSet())
+            return *location;
+        if (server.isSet())
+            return *server;
+        if (http.isSet())
+            return *http;
+        return fallback;
+    }
+}
 
+// What is needed to receive the body, as soon as the headers are in:
+// nothing else of the context is built for it
+BodySettings RequestResolver::resolveBodySettings(const HttpBlock& httpBlock,
+                                                  const NetworkEndpoint& endpoint,
+                                                  const std::string& host,
+                                                  const std::string& uri)
+{
     const ServerBlock& serverBlock
         = matchServerBlock(httpBlock.servers, endpoint, host);
     const LocationBlock* locationBlock = matchLocationBlock(serverBlock, uri);
+    const EffectiveConfig defaults;
+
+    BodySettings settings;
+    settings.maxSize = mostSpecific(httpBlock.clientMaxBodySize,
+        serverBlock.clientMaxBodySize,
+        locationBlock ? &locationBlock->clientMaxBodySize : nullptr,
+        defaults.client_max_body_size);
+    settings.bufferSize = mostSpecific(httpBlock.clientBodyBufferSize,
+        serverBlock.clientBodyBufferSize,
+        locationBlock ? &locationBlock->clientBodyBufferSize : nullptr,
+        defaults.client_body_buffer_size);
+    settings.tempPath = mostSpecific(httpBlock.clientBodyTempPath,
+        serverBlock.clientBodyTempPath,
+        locationBlock ? &locationBlock->clientBodyTempPath : nullptr,
+        defaults.client_body_temp_path);
+    return settings;
+}
+
+EffectiveConfig RequestResolver::createEffectiveConfig(
+    const HttpBlock& httpBlock, const ServerBlock& serverBlock,
+    const std::string& uri)
+{
+    EffectiveConfig config;
+
+    const LocationBlock* locationBlock = matchLocationBlock(serverBlock, uri);
 
     httpBlock.applyTo(config);
     serverBlock.applyTo(config);
@@ -102,6 +154,8 @@ RequestContext RequestResolver::createContext(const EffectiveConfig& config,
 
     context.allowed_methods = config.allowed_methods;
     context.autoindex_enabled = config.autoindex_enabled;
+    context.gzip_static = config.gzip_static;
+    context.gzip = config.gzip;
     context.cgi_pass = config.cgi_pass;
     context.client_max_body_size = config.client_max_body_size;
     context.error_pages = constructErrorPages(config.error_pages);
@@ -12,6 +12,7 @@
 # include "NetworkEndpoint.hpp"
 # include "ErrorPage.hpp"
 # include "HttpBlock.hpp"
+# include "BodySettings.hpp"
 
 class RequestResolver
 {
@@ -31,17 +32,24 @@ class RequestResolver
                                   const NetworkEndpoint& endpoint,
                                   const std::string& host,
                                   const std::string& uri);
+    static RequestContext resolve(const HttpBlock& httpBlock,
+                                  const ServerBlock& serverBlock,
+                                  const std::string& uri);
+    static BodySettings resolveBodySettings(const HttpBlock& httpBlock,
+                                            const NetworkEndpoint& endpoint,
+                                            const std::string& host,
+                                            const std::string& uri);
+    static const ServerBlock& matchServerBlock(
+        const std::vector<ServerBlock>& servers,
+        const NetworkEndpoint& endpoint, const std::string& host);
 
   private:
     // Methods
-    static EffectiveConfig createEffectiveConfig(
-        const HttpBlock& httpBlock, const NetworkEndpoint& endpoint,
-        const std::string& host, const std::string& uri);
+    static EffectiveConfig createEffectiveConfig(const HttpBlock& httpBlock,
+                                                 const ServerBlock& serverBlock,
+                                                 const std::string& uri);
     static RequestContext createContext(const EffectiveConfig& config,
                                         const std::string& uri);
-    static const ServerBlock& matchServerBlock(
-        const std::vector<ServerBlock>& servers,
-        const NetworkEndpoint& endpoint, const std::string& host);
     static std::vector<const ServerBlock*> tryMatchByEndpoint(
         const std::vector<ServerBlock>& servers,
         const NetworkEndpoint& endpoint);
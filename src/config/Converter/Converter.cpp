@@ -30,6 +30,11 @@ BodySize toBodySize(const std::string& value)
     return BodySize(value);
 }
 
+Duration toDuration(const std::string& value)
+{
+    return Duration(value);
+}
+
 HttpStatusCode toHttpStatusCode(const std::string& value)
 {
     return static_cast<HttpStatusCode>(std::stoi(value));
@@ -100,4 +105,59 @@ int toNetworkPort(const std::string& value)
     return (port);
 }
 
+size_t toCount(const std::string& value)
+{
+    if (value.empty())
+        throw std::invalid_argument("value can not be empty");
+
+    if (value.find_first_not_of("1234567890") != std::string::npos)
+        throw std::invalid_argument("count has to consist only from digits");
+
+    size_t count = std::stoul(value);
+    if (count == 0)
+        throw std::invalid_argument("count has to be greater than 0");
+
+    return (count);
+}
+
+// 'auto' means one worker per available CPU core
+size_t toWorkerCount(const std::string& value)
+{
+    if (value != "auto")
+        return toCount(value);
+
+    size_t cores = std::thread::hardware_concurrency();
+    return (cores > 0) ? cores : 1;
+}
+
+EventBackend toEventBackend(const std::string& value)
+{
+    if (value == "epoll")
+        return EventBackend::Epoll;
+    if (value == "io_uring")
+        return EventBackend::IoUring;
+    throw std::invalid_argument("Expected 'epoll' or 'io_uring', got: "
+                                + value);
+}
+
+GzipStatic toGzipStatic(const std::string& value)
+{
+    if (value == "off")
+        return GzipStatic::Off;
+    if (value == "on")
+        return GzipStatic::On;
+    if (value == "always")
+        return GzipStatic::Always;
+    throw std::invalid_argument("Expected 'on', 'off' or 'always', got: "
+                                + value);
+}
+
+size_t toCompressionLevel(const std::string& value)
+{
+    size_t level = toCount(value);
+    if (level > 9)
+        throw std::invalid_argument("Compression level must be from 1 to 9");
+    return level;
+}
+
 } // namespace Converter
\ No newline at end of file
@@ -5,11 +5,15 @@
 
 # include <string>
 # include <map>
+# include <thread>
 
 # include "HttpMethod.hpp"
 # include "BodySize.hpp"
+# include "Duration.hpp"
 # include "HttpStatusCode.hpp"
 # include "NetworkEndpoint.hpp"
+# include "Poller.hpp"
+# include "GzipStatic.hpp"
 
 namespace Converter
 {
@@ -17,9 +21,15 @@ namespace Converter
 HttpMethod toHttpMethod(const std::string& value);
 bool toBool(const std::string& value);
 BodySize toBodySize(const std::string& value);
+Duration toDuration(const std::string& value);
 HttpStatusCode toHttpStatusCode(const std::string& value);
 NetworkEndpoint toNetworkEndpoint(const std::string& value);
 int toNetworkPort(const std::string& value);
+size_t toCount(const std::string& value);
+size_t toWorkerCount(const std::string& value);
+EventBackend toEventBackend(const std::string& value);
+GzipStatic toGzipStatic(const std::string& value);
+size_t toCompressionLevel(const std::string& value);
 
 }; // namespace Converter
 
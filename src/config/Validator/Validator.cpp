@@ -275,7 +275,13 @@ Validator::validators()
             {ArgumentType::File, validateFile},
             {ArgumentType::FileExtension, validateFileExtension},
             {ArgumentType::BinaryPath, validateBinaryPath},
-            {ArgumentType::ReturnStatusCode, validateReturnStatusCode}
+            {ArgumentType::ReturnStatusCode, validateReturnStatusCode},
+            {ArgumentType::Count, validateCount},
+            {ArgumentType::Auto, validateAuto},
+            {ArgumentType::EventBackend, validateEventBackend},
+            {ArgumentType::Time, validateTime},
+            {ArgumentType::GzipStatic, validateGzipStatic},
+            {ArgumentType::CompressionLevel, validateCompressionLevel}
         };
     return map;
 }
@@ -367,6 +373,11 @@ void Validator::validateDataSize(const std::string& s)
     Converter::toBodySize(s);
 }
 
+void Validator::validateTime(const std::string& s)
+{
+    Converter::toDuration(s);
+}
+
 void Validator::validateNetworkEndpoint(const std::string& s)
 {
     if (s.empty())
@@ -471,6 +482,32 @@ void Validator::validateBinaryPath(const std::string& s)
     (void)s;
 }
 
+void Validator::validateCount(const std::string& s)
+{
+    Converter::toCount(s);
+}
+
+void Validator::validateAuto(const std::string& s)
+{
+    if (s != "auto")
+        throw std::invalid_argument("Expected 'auto', got: " + s);
+}
+
+void Validator::validateEventBackend(const std::string& s)
+{
+    Converter::toEventBackend(s);
+}
+
+void Validator::validateGzipStatic(const std::string& s)
+{
+    Converter::toGzipStatic(s);
+}
+
+void Validator::validateCompressionLevel(const std::string& s)
+{
+    Converter::toCompressionLevel(s);
+}
+
 //-------------------------THOUGHTS-------------------------------
 
 // Create a map <directive_name, args_validation_function>
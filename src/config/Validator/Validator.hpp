@@ -72,6 +72,7 @@ class Validator
     static void validateStatusCode(const std::string& s);
     static void validateReturnStatusCode(const std::string& s);
     static void validateDataSize(const std::string& s);
+    static void validateTime(const std::string& s);
     static void validateOnOff(const std::string& s);
     static void validateFolderPath(const std::string& s);
     static void validateFilePath(const std::string& s);
@@ -84,6 +85,11 @@ class Validator
     static void validateFile(const std::string& s);
     static void validateFileExtension(const std::string& s);
     static void validateBinaryPath(const std::string& s);
+    static void validateCount(const std::string& s);
+    static void validateAuto(const std::string& s);
+    static void validateEventBackend(const std::string& s);
+    static void validateGzipStatic(const std::string& s);
+    static void validateCompressionLevel(const std::string& s);
     // Accessors
     static const std::map<ArgumentType,
                           std::function<void(const std::string&)>>&
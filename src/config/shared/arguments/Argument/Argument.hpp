@@ -25,7 +25,13 @@ enum class ArgumentType
     File,            // index.html
     FileExtension,   // .php
     BinaryPath,      // /usr/bin/php-cgi
-    ReturnStatusCode // only 30X status codes
+    ReturnStatusCode, // only 30X status codes
+    Count,            // 1, 4, 32 (strictly positive)
+    Auto,             // 'auto'
+    EventBackend,     // 'epoll' or 'io_uring'
+    Time,             // 500ms, 30s, 5m
+    GzipStatic,       // 'on', 'off' or 'always'
+    CompressionLevel  // 1 to 9
 };
 
 class Argument
@@ -5,5 +5,6 @@
 
 # include "Argument.hpp"
 # include "BodySize.hpp"
+# include "Duration.hpp"
 
 #endif
@@ -0,0 +1,104 @@
+#include "Duration.hpp"
+
+// -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
+
+// Default constructor
+Duration::Duration() {}
+
+Duration::Duration(const std::string& value)
+{
+    m_milliseconds = parseValue(value);
+}
+
+// Copy constructor
+Duration::Duration(const Duration& other)
+  : m_milliseconds(other.m_milliseconds)
+{
+}
+
+// Copy assignment operator
+Duration& Duration::operator=(const Duration& other)
+{
+    if (this != &other)
+    {
+        m_milliseconds = other.m_milliseconds;
+    }
+    return (*this);
+}
+
+// Move constructor
+Duration::Duration(Duration&& other) noexcept
+  : m_milliseconds(other.m_milliseconds)
+{
+}
+
+// Move assignment operator
+Duration& Duration::operator=(Duration&& other) noexcept
+{
+    if (this != &other)
+    {
+        m_milliseconds = other.m_milliseconds;
+    }
+    return (*this);
+}
+
+// Destructor
+Duration::~Duration() {}
+
+// ---------------------------ACCESSORS-----------------------------
+
+size_t Duration::milliseconds() const
+{
+    return (m_milliseconds);
+}
+
+// ---------------------------METHODS-----------------------------
+
+size_t Duration::parseValue(const std::string& s)
+{
+    auto unitStart = std::find_if(s.begin(), s.end(),
+                                  [](char c) { return !std::isdigit(c); });
+
+    // At least one digit, and nothing but a unit after them
+    if (unitStart == s.begin())
+        throw std::invalid_argument(s);
+
+    size_t numLength = unitStart - s.begin();
+    if (numLength > 9)
+        throw std::invalid_argument(s);
+
+    size_t number = std::stoul(s.substr(0, numLength));
+    return (number * unitMultiplier(s.substr(numLength)));
+}
+
+size_t Duration::unitMultiplier(const std::string& unit)
+{
+    if (unit == "ms")
+        return (1);
+    if (unit.empty() || unit == "s")
+        return (1000);
+    if (unit == "m")
+        return (60 * 1000);
+    if (unit == "h")
+        return (60 * 60 * 1000);
+    if (unit == "d")
+        return (24 * 60 * 60 * 1000);
+    throw std::invalid_argument(unit);
+}
+
+// --------------------------OPERATORS----------------------------
+
+Duration::operator size_t() const
+{
+    return m_milliseconds;
+}
+
+bool Duration::operator==(const size_t& other) const
+{
+    return m_milliseconds == other;
+}
+
+bool Duration::operator!=(const size_t& other) const
+{
+    return m_milliseconds != other;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifndef DURATION_HPP
+# define DURATION_HPP
+
+# include <utility>
+# include <string>
+# include <algorithm>
+# include <stdexcept>
+
+// Time span written as in nginx: 500ms, 30s, 5m, 1h, 1d.
+// A number without a unit means seconds. Stored in milliseconds.
+class Duration
+{
+    // Construction and destruction
+  public:
+    Duration();
+    explicit Duration(const std::string& value);
+    Duration(const Duration& other);
+    Duration& operator=(const Duration& other);
+    Duration(Duration&& other) noexcept;
+    Duration& operator=(Duration&& other) noexcept;
+    ~Duration();
+
+    // Class specific features
+  public:
+    // Accessors
+    size_t milliseconds() const;
+    // Operators
+    operator size_t() const;
+    bool operator==(const size_t& other) const;
+    bool operator!=(const size_t& other) const;
+
+  private:
+    // Properties
+    size_t m_milliseconds = 0;
+    // Methods
+    static size_t parseValue(const std::string& s);
+    static size_t unitMultiplier(const std::string& unit);
+};
+
+#endif
@@ -22,15 +22,37 @@ constexpr const char* SERVER_NAME = "server_name";
 constexpr const char* LISTEN = "listen";
 constexpr const char* ERROR_PAGE = "error_page";
 constexpr const char* CLIENT_MAX_BODY_SIZE = "client_max_body_size";
+constexpr const char* CLIENT_BODY_BUFFER_SIZE = "client_body_buffer_size";
+constexpr const char* CLIENT_BODY_TEMP_PATH = "client_body_temp_path";
 constexpr const char* LOCATION = "location";
 constexpr const char* LIMIT_EXCEPT = "limit_except";
 constexpr const char* RETURN = "return";
 constexpr const char* ROOT = "root";
 constexpr const char* ALIAS = "alias";
 constexpr const char* AUTOINDEX = "autoindex";
+constexpr const char* GZIP_STATIC = "gzip_static";
+constexpr const char* GZIP = "gzip";
+constexpr const char* GZIP_TYPES = "gzip_types";
+constexpr const char* GZIP_MIN_LENGTH = "gzip_min_length";
+constexpr const char* GZIP_COMP_LEVEL = "gzip_comp_level";
 constexpr const char* INDEX = "index";
 constexpr const char* UPLOAD_STORE = "upload_store";
 constexpr const char* CGI_PASS = "cgi_pass";
+constexpr const char* WORKER_THREADS = "worker_threads";
+constexpr const char* WORKER_PROCESSES = "worker_processes";
+constexpr const char* EDGE_TRIGGERED = "edge_triggered";
+constexpr const char* EVENT_BACKEND = "event_backend";
+constexpr const char* CLIENT_HEADER_TIMEOUT = "client_header_timeout";
+constexpr const char* CLIENT_BODY_TIMEOUT = "client_body_timeout";
+constexpr const char* SEND_TIMEOUT = "send_timeout";
+constexpr const char* KEEPALIVE_TIMEOUT = "keepalive_timeout";
+constexpr const char* CGI_TIMEOUT = "cgi_timeout";
+constexpr const char* OPEN_FILE_CACHE = "open_file_cache";
+constexpr const char* OPEN_FILE_CACHE_VALID = "open_file_cache_valid";
+constexpr const char* OPEN_FILE_CACHE_MIN_USES = "open_file_cache_min_uses";
+constexpr const char* OPEN_FILE_CACHE_ERRORS = "open_file_cache_errors";
+constexpr const char* RESPONSE_CACHE = "response_cache";
+constexpr const char* RESPONSE_CACHE_MAX_FILE = "response_cache_max_file";
 
 constexpr size_t UNLIMITED = std::numeric_limits<size_t>::max();
 
@@ -115,6 +137,20 @@ const std::map<std::string, DirectiveSpec> directives = {
         {},
         false
     }},
+    {CLIENT_BODY_BUFFER_SIZE, {
+        Type::SIMPLE,
+        {HTTP, SERVER, LOCATION},
+        {{{ArgumentType::DataSize}, 1, 1}},
+        {},
+        false
+    }},
+    {CLIENT_BODY_TEMP_PATH, {
+        Type::SIMPLE,
+        {HTTP, SERVER, LOCATION},
+        {{{ArgumentType::String}, 1, 1}},
+        {},
+        false
+    }},
     {LOCATION, {
         Type::BLOCK,
         {SERVER},
@@ -160,6 +196,41 @@ const std::map<std::string, DirectiveSpec> directives = {
         {},
         false
     }},
+    {GZIP_STATIC, {
+        Type::SIMPLE,
+        {HTTP, SERVER, LOCATION},
+        {{{ArgumentType::GzipStatic}, 1, 1}},
+        {},
+        false
+    }},
+    {GZIP, {
+        Type::SIMPLE,
+        {HTTP, SERVER, LOCATION},
+        {{{ArgumentType::OnOff}, 1, 1}},
+        {},
+        false
+    }},
+    {GZIP_TYPES, {
+        Type::SIMPLE,
+        {HTTP, SERVER, LOCATION},
+        {{{ArgumentType::String}, 1, UNLIMITED}},
+        {},
+        false
+    }},
+    {GZIP_MIN_LENGTH, {
+        Type::SIMPLE,
+        {HTTP, SERVER, LOCATION},
+        {{{ArgumentType::DataSize}, 1, 1}},
+        {},
+        false
+    }},
+    {GZIP_COMP_LEVEL, {
+        Type::SIMPLE,
+        {HTTP, SERVER, LOCATION},
+        {{{ArgumentType::CompressionLevel}, 1, 1}},
+        {},
+        false
+    }},
     {INDEX, {
         Type::SIMPLE,
         {HTTP, SERVER, LOCATION},
@@ -183,6 +254,111 @@ const std::map<std::string, DirectiveSpec> directives = {
         },
         {},
         true
+    }},
+    {WORKER_THREADS, {
+        Type::SIMPLE,
+        {GLOBAL_CONTEXT},
+        {{{ArgumentType::Count, ArgumentType::Auto}, 1, 1}},
+        {},
+        false
+    }},
+    {WORKER_PROCESSES, {
+        Type::SIMPLE,
+        {GLOBAL_CONTEXT},
+        {{{ArgumentType::Count, ArgumentType::Auto}, 1, 1}},
+        {},
+        false
+    }},
+    {EDGE_TRIGGERED, {
+        Type::SIMPLE,
+        {GLOBAL_CONTEXT},
+        {{{ArgumentType::OnOff}, 1, 1}},
+        {},
+        false
+    }},
+    {EVENT_BACKEND, {
+        Type::SIMPLE,
+        {GLOBAL_CONTEXT},
+        {{{ArgumentType::EventBackend}, 1, 1}},
+        {},
+        false
+    }},
+    {CLIENT_HEADER_TIMEOUT, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::Time}, 1, 1}},
+        {},
+        false
+    }},
+    {CLIENT_BODY_TIMEOUT, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::Time}, 1, 1}},
+        {},
+        false
+    }},
+    {SEND_TIMEOUT, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::Time}, 1, 1}},
+        {},
+        false
+    }},
+    {KEEPALIVE_TIMEOUT, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::Time}, 1, 1}},
+        {},
+        false
+    }},
+    {CGI_TIMEOUT, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::Time}, 1, 1}},
+        {},
+        false
+    }},
+    {OPEN_FILE_CACHE, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::Count}, 1, 1}},
+        {},
+        false
+    }},
+    {OPEN_FILE_CACHE_VALID, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::Time}, 1, 1}},
+        {},
+        false
+    }},
+    {OPEN_FILE_CACHE_MIN_USES, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::Count}, 1, 1}},
+        {},
+        false
+    }},
+    {OPEN_FILE_CACHE_ERRORS, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::OnOff}, 1, 1}},
+        {},
+        false
+    }},
+    {RESPONSE_CACHE, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::DataSize}, 1, 1}},
+        {},
+        false
+    }},
+    {RESPONSE_CACHE_MAX_FILE, {
+        Type::SIMPLE,
+        {HTTP},
+        {{{ArgumentType::DataSize}, 1, 1}},
+        {},
+        false
     }}
 };
 
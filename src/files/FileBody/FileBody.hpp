@@ -0,0 +1,23 @@
+#pragma once
+
+#ifndef FILEBODY_HPP
+# define FILEBODY_HPP
+
+# include <memory>
+# include <sys/types.h>
+
+# include "FdGuard.hpp"
+
+// A response body that stays on disk: an open file and the region of it
+// to send. The fd is shared by the copies a response goes through and is
+// closed with the last of them.
+struct FileBody
+{
+    std::shared_ptr<FdGuard> fd;
+    off_t offset = 0;
+    size_t length = 0;
+
+    bool isSet() const { return fd != nullptr; }
+};
+
+#endif
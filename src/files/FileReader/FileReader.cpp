@@ -22,3 +22,21 @@ std::string FileReader::readFile(const std::string& path)
 
     return contents;
 }
+
+// The whole file as a body that is sent without being read into memory
+FileBody FileReader::openFile(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        throw std::runtime_error("Could not open file: " + path);
+
+    FileBody body;
+    body.fd = std::make_shared<FdGuard>(fd);
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode))
+        throw std::runtime_error("Failed to determine file size: " + path);
+    body.length = static_cast<size_t>(st.st_size);
+
+    return body;
+}
@@ -6,6 +6,10 @@
 # include <fstream>
 # include <string>
 # include <vector>
+# include <fcntl.h>
+# include <sys/stat.h>
+
+# include "FileBody.hpp"
 
 class FileReader
 {
@@ -22,6 +26,7 @@ class FileReader
   public:
     // Methods
     static std::string readFile(const std::string& path);
+    static FileBody openFile(const std::string& path);
 };
 
 #endif
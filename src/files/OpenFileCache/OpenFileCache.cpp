@@ -0,0 +1,180 @@
+#include "OpenFileCache.hpp"
+
+// ---------------------------ACCESSORS-----------------------------
+
+OpenFileCache& OpenFileCache::local()
+{
+    static thread_local OpenFileCache cache;
+    return cache;
+}
+
+size_t OpenFileCache::size() const
+{
+    return m_entries.size();
+}
+
+// ---------------------------METHODS-----------------------------
+
+void OpenFileCache::configure(const Settings& settings)
+{
+    m_settings = settings;
+    clear();
+}
+
+// Same answer as FileUtils::getFileInfo
+FileInfo OpenFileCache::stat(const std::string& path)
+{
+    if (m_settings.maxEntries == 0)
+        return FileUtils::getFileInfo(path);
+
+    if (Entry* entry = lookup(path))
+        return entry->info;
+
+    struct stat s;
+    if (::stat(path.c_str(), &s) != 0)
+    {
+        if (errno == ENOENT && m_settings.cacheErrors)
+            insertMissing(path);
+        return FileInfo{};
+    }
+    return insert(path, s)->info;
+}
+
+// Same answer as FileReader::openFile, with the fd shared
+// between all the responses that send the file
+FileBody OpenFileCache::open(const std::string& path)
+{
+    if (m_settings.maxEntries == 0)
+        return FileReader::openFile(path);
+
+    Entry* entry = lookup(path);
+    if (!entry)
+    {
+        stat(path);
+        entry = lookup(path);
+    }
+    if (!entry || !entry->info.isFile)
+        return FileReader::openFile(path); // throws
+
+    if (entry->body.isSet())
+        return entry->body;
+
+    FileBody body = FileReader::openFile(path);
+    if (++entry->uses >= m_settings.minUses)
+        entry->body = body;
+    return body;
+}
+
+// For the changes this process makes itself (uploads, DELETE)
+void OpenFileCache::invalidate(const std::string& path)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+        return;
+
+    m_lru.erase(it->second.lruPos);
+    m_entries.erase(it);
+}
+
+void OpenFileCache::clear()
+{
+    m_entries.clear();
+    m_lru.clear();
+}
+
+// An entry that has outlived its validity is checked again,
+// and dropped if the file behind the path isn't the same anymore
+OpenFileCache::Entry* OpenFileCache::lookup(const std::string& path)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+        return nullptr;
+
+    Entry& entry = it->second;
+    uint64_t now = nowMs();
+    if (now - entry.validatedAt >= m_settings.validMs)
+    {
+        struct stat s;
+        bool exists = (::stat(path.c_str(), &s) == 0);
+        if (exists != entry.info.exists || (exists && !sameFile(entry, s)))
+        {
+            invalidate(path);
+            return nullptr;
+        }
+        entry.validatedAt = now;
+    }
+
+    m_lru.splice(m_lru.begin(), m_lru, entry.lruPos);
+    return &entry;
+}
+
+OpenFileCache::Entry* OpenFileCache::insert(const std::string& path,
+                                            const struct stat& s)
+{
+    evict();
+
+    m_lru.push_front(path);
+    Entry& entry = m_entries[path];
+    entry.info = toFileInfo(s);
+    entry.dev = s.st_dev;
+    entry.ino = s.st_ino;
+    entry.size = s.st_size;
+    entry.mtime = s.st_mtim;
+    entry.ctime = s.st_ctim; // changes with the permissions too
+    entry.validatedAt = nowMs();
+    entry.lruPos = m_lru.begin();
+    return &entry;
+}
+
+void OpenFileCache::insertMissing(const std::string& path)
+{
+    evict();
+
+    m_lru.push_front(path);
+    Entry& entry = m_entries[path];
+    entry.validatedAt = nowMs();
+    entry.lruPos = m_lru.begin();
+}
+
+// Makes room for one more entry
+void OpenFileCache::evict()
+{
+    while (!m_lru.empty() && m_entries.size() >= m_settings.maxEntries)
+    {
+        m_entries.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+}
+
+bool OpenFileCache::sameFile(const Entry& entry, const struct stat& s)
+{
+    return entry.dev == s.st_dev && entry.ino == s.st_ino
+        && entry.size == s.st_size && entry.mtime.tv_sec == s.st_mtim.tv_sec
+        && entry.mtime.tv_nsec == s.st_mtim.tv_nsec
+        && entry.ctime.tv_sec == s.st_ctim.tv_sec
+        && entry.ctime.tv_nsec == s.st_ctim.tv_nsec;
+}
+
+FileInfo OpenFileCache::toFileInfo(const struct stat& s)
+{
+    FileInfo info{};
+
+    info.exists = true;
+    info.isFile = S_ISREG(s.st_mode);
+    info.isDir = S_ISDIR(s.st_mode);
+    info.readable = (s.st_mode & S_IRUSR);
+    info.writable = (s.st_mode & S_IWUSR);
+    info.executable = (s.st_mode & S_IXUSR);
+    info.device = s.st_dev;
+    info.inode = s.st_ino;
+    info.size = s.st_size;
+    info.mtime = s.st_mtim;
+    return info;
+}
+
+uint64_t OpenFileCache::nowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch())
+        .count();
+}
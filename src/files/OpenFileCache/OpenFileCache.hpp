@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef OPENFILECACHE_HPP
+# define OPENFILECACHE_HPP
+
+# include <chrono>
+# include <list>
+# include <string>
+# include <unordered_map>
+# include <fcntl.h>
+# include <sys/stat.h>
+
+# include "FileBody.hpp"
+# include "FileUtils.hpp"
+# include "FileReader.hpp"
+
+// Remembers what stat and open told about the files that are served,
+// so a hot file costs no syscall but the send. Entries are checked
+// against the disk again once they are older than the validity period.
+// One cache per reactor thread, nothing is shared or locked.
+class OpenFileCache
+{
+    // Construction and destruction
+  public:
+    OpenFileCache() = default;
+    OpenFileCache(const OpenFileCache& other) = delete;
+    OpenFileCache& operator=(const OpenFileCache& other) = delete;
+    OpenFileCache(OpenFileCache&& other) noexcept = delete;
+    OpenFileCache& operator=(OpenFileCache&& other) noexcept = delete;
+    ~OpenFileCache() = default;
+
+    // Class specific features
+  public:
+    struct Settings
+    {
+        size_t maxEntries = 0; // 0: the cache is off
+        size_t validMs = 60 * 1000;
+        size_t minUses = 1; // lookups before the fd is kept open
+        bool cacheErrors = false; // remember missing files too
+    };
+
+    // Accessors
+    static OpenFileCache& local();
+    size_t size() const;
+    // Methods
+    void configure(const Settings& settings);
+    FileInfo stat(const std::string& path);
+    FileBody open(const std::string& path);
+    void invalidate(const std::string& path);
+    void clear();
+
+  private:
+    struct Entry
+    {
+        FileInfo info{};
+        dev_t dev = 0;
+        ino_t ino = 0;
+        off_t size = 0;
+        timespec mtime{};
+        timespec ctime{};
+        FileBody body; // set once the file has been used minUses times
+        size_t uses = 0;
+        uint64_t validatedAt = 0;
+        std::list<std::string>::iterator lruPos;
+    };
+
+    // Properties
+    Settings m_settings;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru; // most recently used first
+    // Methods
+    Entry* lookup(const std::string& path);
+    Entry* insert(const std::string& path, const struct stat& s);
+    void insertMissing(const std::string& path);
+    void evict();
+    static bool sameFile(const Entry& entry, const struct stat& s);
+    static FileInfo toFileInfo(const struct stat& s);
+    static uint64_t nowMs();
+};
+
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+
+#ifndef BODYSETTINGS_HPP
+# define BODYSETTINGS_HPP
+
+# include <cstdint>
+# include <string>
+
+// How a request body is received (client_max_body_size,
+// client_body_buffer_size, client_body_temp_path)
+struct BodySettings
+{
+    size_t maxSize = 0; // 0: no limit
+    size_t bufferSize = SIZE_MAX; // kept in memory up to this size
+    std::string tempPath{}; // directory of the temp files past it
+};
+
+#endif
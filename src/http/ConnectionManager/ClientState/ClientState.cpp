@@ -63,16 +63,55 @@ const ResponseData& ClientState::frontResponse() const
 	return  m_responses.front();
 }
 
+ResponseData& ClientState::frontResponse()
+{
+	if ( m_responses.empty())
+		throw std::runtime_error("No pending responses");
+	return  m_responses.front();
+}
+
 const std::queue<ResponseData>& ClientState::responses() const
 {
 	return  m_responses;
 }
 
-std::vector<CGIData>& ClientState::activeCGIs()
+std::list<CGIData>& ClientState::activeCGIs()
 {
 	return m_activeCGIs;
 }
 
+// Complete requests are popped as soon as they are parsed,
+// so only the last one can still be waiting for bytes
+ClientState::ReceivePhase ClientState::receivePhase() const
+{
+	if (m_requests.empty())
+		return ReceivePhase::Idle;
+
+	const RawRequest& rawReq = m_requests.back();
+	if (rawReq.isRequestDone())
+		return ReceivePhase::Idle;
+	if (rawReq.isHeadersDone())
+		return ReceivePhase::Body;
+	if (rawReq.tempBuffer().empty())
+		return ReceivePhase::Idle;
+	return ReceivePhase::Headers;
+}
+
+bool ClientState::isQueuedReady() const
+{
+	return m_queuedReady;
+}
+
+void ClientState::setQueuedReady(bool queued)
+{
+	m_queuedReady = queued;
+}
+
+bool ClientState::isInputClosed() const
+{
+	return m_inputClosed;
+}
+
 // ---------------------------METHODS-----------------------------
 
 RawRequest& ClientState::addRequest()
@@ -131,11 +170,7 @@ CGIData* ClientState::findCgiByPid(pid_t pid)
 
 void ClientState::removeCgi(pid_t pid)
 {
-	auto it
-		= std::remove_if(m_activeCGIs.begin(), m_activeCGIs.end(),
-						 [pid](const CGIData& cgi) { return cgi.pid == pid; });
-	if (it != m_activeCGIs.end())
-		m_activeCGIs.erase(it, m_activeCGIs.end());
+	m_activeCGIs.remove_if([pid](const CGIData& cgi) { return cgi.pid == pid; });
 }
 
 void ClientState::clearActiveCGIs()
@@ -143,13 +178,9 @@ void ClientState::clearActiveCGIs()
 	m_activeCGIs.clear();
 }
 
-std::vector<CGIData*> ClientState::getTimedOutCGIs(time_t now, time_t timeout)
+// After a request that ended the connection, e.g. with a body that was
+// too large, the rest of the input isn't a request of its own
+void ClientState::closeInput()
 {
-    std::vector<CGIData*> result;
-
-    for (auto& cgi : m_activeCGIs)
-        if (now - cgi.start_time > timeout)
-            result.push_back(&cgi);
-
-    return result;
+	m_inputClosed = true;
 }
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <stdexcept>
 #include <queue>
+#include <list>
 
 #include "RawRequest.hpp"
 #include "RequestData.hpp"
@@ -16,11 +17,22 @@
 
 class ClientState
 {
+  public:
+    // How far the request that is being received has got
+    enum class ReceivePhase
+    {
+        Idle,
+        Headers,
+        Body
+    };
+
   private:
     // Properties
     std::queue<RawRequest> m_requests;
     std::queue<ResponseData> m_responses;
-    std::vector<CGIData> m_activeCGIs;
+    std::list<CGIData> m_activeCGIs; // list: the Server keeps pointers
+    bool m_queuedReady = false; // in the ConnectionManager's ready list
+    bool m_inputClosed = false; // what the client still sends is dropped
 
   public:
     // Construction and destruction
@@ -37,8 +49,13 @@ class ClientState
     RawRequest& backRequest();
     ResponseData& backResponse(); // the connection header is changed by CGI
     const ResponseData& frontResponse() const;
+    ResponseData& frontResponse(); // its body is moved out when sent
     const std::queue<ResponseData>& responses() const;
-    std::vector<CGIData>& activeCGIs();
+    std::list<CGIData>& activeCGIs();
+    ReceivePhase receivePhase() const;
+    bool isQueuedReady() const;
+    void setQueuedReady(bool queued);
+    bool isInputClosed() const;
 
     // Methods
     RawRequest& addRequest();
@@ -51,7 +68,7 @@ class ClientState
     CGIData* findCgiByPid(pid_t pid);
     void removeCgi(pid_t pid);
     void clearActiveCGIs();
-    std::vector<CGIData*> getTimedOutCGIs(time_t now, time_t timeout);
+    void closeInput();
 };
 
 #endif
@@ -28,7 +28,7 @@ void ConnectionManager::removeClient(int clientId)
 	m_clients.erase(clientId);
 }
 
-void ConnectionManager::processData(Client& client, const std::string& tcpData)
+void ConnectionManager::processData(Client& client, std::string_view tcpData)
 {
 	// 1. Parse incoming TCP data
 	size_t reqsNum = processReqs(client, tcpData);
@@ -38,7 +38,7 @@ void ConnectionManager::processData(Client& client, const std::string& tcpData)
 		genResps(client);
 }
 
-size_t ConnectionManager::processReqs(Client& client, const std::string& data)
+size_t ConnectionManager::processReqs(Client& client, std::string_view data)
 {
 	DBG("DEBUG: processReqs: ");
 	auto it = m_clients.find(client.socket());
@@ -46,9 +46,11 @@ size_t ConnectionManager::processReqs(Client& client, const std::string& data)
 		return 0;
 
 	ClientState& clientState = it->second;
+	if (clientState.isInputClosed())
+		return 0;
 	RawRequest& rawReq = clientState.backRequest();
 
-	// Append all incoming bytes to temp buffer
+	// Body bytes go straight into the body, the rest into the temp buffer
 	rawReq.appendTempBuffer(data);
 	DBG("[processReqs] tempBuffer is |" << rawReq.getTempBuffer() << "|");
 
@@ -57,6 +59,8 @@ size_t ConnectionManager::processReqs(Client& client, const std::string& data)
 	while (true)
 	{
 		RawRequest& rawReq = clientState.backRequest();
+		if (!rawReq.isHeadersDone() && rawReq.parseHeaderPart())
+			onHeadersDone(client, clientState, rawReq);
 		bool done = rawReq.parse();
 
 		if (!done)
@@ -67,14 +71,20 @@ size_t ConnectionManager::processReqs(Client& client, const std::string& data)
 
 		parsedCount++;
 
+		if (rawReq.isBodyTooLarge() || rawReq.isServerError())
+		{
+			clientState.closeInput();
+			break;
+		}
+
 		// Check for leftovers (data after a complete request)
-		std::string leftovers = rawReq.tempBuffer();
+		std::string leftovers = rawReq.takeTempBuffer();
 		if (!leftovers.empty())
 		{
 			DBG("[processReqs]: leftovers exist, adding new RawRequest: |"
 				<< leftovers << "|");
 			RawRequest& newReq = clientState.addRequest();
-			newReq.setTempBuffer(leftovers);
+			newReq.setTempBuffer(std::move(leftovers));
 			continue; // process the new request in the same loop
 		}
 		else
@@ -86,6 +96,43 @@ size_t ConnectionManager::processReqs(Client& client, const std::string& data)
 	return parsedCount;
 }
 
+// The body is checked against client_max_body_size before and while
+// it's read, not once it's all in memory. A client waiting for a
+// 100 Continue only gets it if the body is going to be accepted.
+void ConnectionManager::onHeadersDone(const Client& client, ClientState& clientState,
+									  RawRequest& rawReq)
+{
+	if (rawReq.isBadRequest() || rawReq.bodyType() == BodyType::NO_BODY)
+		return;
+
+	rawReq.setBodySettings(m_config.bodySettings(
+		client.getListeningEndpoint(), rawReq.host(), rawReq.uri()));
+
+	// A multipart upload is written to upload_store as it arrives
+	std::string_view contentType = rawReq.header("Content-Type");
+	if (!rawReq.isRequestDone() && rawReq.method() == HttpMethod::POST
+		&& UploadModule::isMultipartFormData(contentType))
+	{
+		RequestContext ctx = m_config.createRequestContext(
+			client.getListeningEndpoint(), rawReq.host(), rawReq.uri());
+		if (ResponseGenerator::isUpload(rawReq.method(), rawReq.uri(), ctx))
+			rawReq.streamBodyTo(UploadModule::createMultipartParser(
+				contentType, ctx.upload_store));
+	}
+
+	// Queued behind the responses to earlier requests, and pointless
+	// once the body has started to arrive
+	if (rawReq.expectsContinue() && !rawReq.isRequestDone()
+		&& rawReq.tempBuffer().empty())
+	{
+		ResponseData interim;
+		interim.statusCode = static_cast<int>(HttpStatusCode::Continue);
+		interim.statusText = "Continue";
+		clientState.enqueueResponse(interim);
+		markReady(client.socket());
+	}
+}
+
 void ConnectionManager::genResps(Client& client)
 {
 	auto it = m_clients.find(client.socket());
@@ -111,7 +158,13 @@ void ConnectionManager::genResps(Client& client)
 		ResponseData data = rawResp.toResponseData();
 
 		if (rawReq.method() == HttpMethod::HEAD)
+		{
 			data.body.clear();
+			data.file = FileBody();
+			data.cachedBody.reset();
+			data.parts.clear();
+			data.stream.reset();
+		}
 
 		if (cgiResult.spawnCgi)
 		{
@@ -120,9 +173,11 @@ void ConnectionManager::genResps(Client& client)
 
 			ResponseData& stored = clientState.backResponse();
 
-			clientState.createActiveCgi(cgiResult.requestData, client,
-										cgiResult.cgiInterpreter,
-										cgiResult.cgiScriptPath, &stored);
+			CGIData& cgi = clientState.createActiveCgi(
+				cgiResult.requestData, client, cgiResult.cgiInterpreter,
+				cgiResult.cgiScriptPath, &stored);
+			m_cgiOwners[cgi.pid] = client.socket();
+			m_startedCgis.push_back(cgi.pid);
 			continue;
 		}
 		else
@@ -130,38 +185,76 @@ void ConnectionManager::genResps(Client& client)
 			clientState.enqueueResponse(data);
 		}
 	}
+
+	if (clientState.hasPendingResponse())
+		markReady(client.socket());
 }
 
-CGIData* ConnectionManager::findCgiByStdoutFd(int fd)
+// CGIs that were started since the last call and are still running
+std::vector<CGIData*> ConnectionManager::takeStartedCgis()
 {
-	for (auto& pair : m_clients)
+	std::vector<CGIData*> started;
+
+	for (pid_t pid : m_startedCgis)
 	{
-		ClientState& state = pair.second;
-		for (auto& cgi : state.activeCGIs())
-		{
-			if (cgi.fd_stdout == fd)
-				return &cgi;
-		}
+		auto owner = m_cgiOwners.find(pid);
+		if (owner == m_cgiOwners.end())
+			continue;
+
+		auto client = m_clients.find(owner->second);
+		if (client == m_clients.end())
+			continue;
+
+		if (CGIData* cgi = client->second.findCgiByPid(pid))
+			started.push_back(cgi);
 	}
-	return nullptr;
+	m_startedCgis.clear();
+
+	return started;
 }
 
-CGIData* ConnectionManager::findCgiByStdinFd(int fd)
+// A client is queued at most once, however many responses it gets
+void ConnectionManager::markReady(int clientId)
 {
-	for (auto& pair : m_clients)
+	auto it = m_clients.find(clientId);
+	if (it == m_clients.end() || it->second.isQueuedReady())
+		return;
+
+	it->second.setQueuedReady(true);
+	m_readyClients.push_back(clientId);
+}
+
+// Clients that may have responses to send since the last call
+std::vector<int> ConnectionManager::takeReadyClients()
+{
+	std::vector<int> ready;
+	ready.swap(m_readyClients);
+
+	for (int clientId : ready)
 	{
-		ClientState& state = pair.second;
-		for (auto& cgi : state.activeCGIs())
-		{
-			if (cgi.fd_stdin == fd)
-				return &cgi;
-		}
+		auto it = m_clients.find(clientId);
+		if (it != m_clients.end())
+			it->second.setQueuedReady(false);
 	}
-	return nullptr;
+
+	return ready;
+}
+
+int ConnectionManager::cgiOwner(pid_t pid) const
+{
+	return m_cgiOwners.at(pid);
 }
 
+// The owner entry is kept until the process is actually reaped, it
+// leads straight to the client whose response the output becomes
 void ConnectionManager::onCgiExited(Server& server, pid_t pid, int status)
 {
+	auto owner = m_cgiOwners.find(pid);
+	if (owner == m_cgiOwners.end())
+		return;
+	int clientId = owner->second;
+	m_cgiOwners.erase(owner);
+
 	if (WIFEXITED(status))
 	{
 		int exitCode = WEXITSTATUS(status);
@@ -176,28 +269,34 @@ void ConnectionManager::onCgiExited(Server& server, pid_t pid, int status)
 				  << "\n";
 	}
 
-	for (auto& it : m_clients)
-	{
-		ClientState& state = it.second;
+	// Gone with its client, or already answered by the timeout
+	auto client = m_clients.find(clientId);
+	if (client == m_clients.end())
+		return;
+	ClientState& state = client->second;
+	CGIData* cgi = state.findCgiByPid(pid);
+	if (!cgi)
+		return;
 
-		CGIData* cgi = state.findCgiByPid(pid);
-		if (!cgi)
-			continue;
-
-		RawResponse raw;
-		if (!raw.parseFromCgiOutput(cgi->output))
-			raw.addDefaultError(HttpStatusCode::InternalServerError);
+	// What is still in the pipe belongs to the output
+	server.handleCgiTermination(*cgi);
 
-		raw.setMimeType(raw.header("Content-Type"));
+	RawResponse raw;
+	if (!raw.parseFromCgiOutput(cgi->output))
+		raw.addDefaultError(HttpStatusCode::InternalServerError);
 
-		*cgi->response = raw.toResponseData();
-		// for ab test connection should be closed after CGI
-		cgi->response->shouldClose = true;
+	raw.setMimeType(raw.header("Content-Type"));
+	raw.setGzip(cgi->response->gzip);
 
-		state.removeCgi(pid);
+	*cgi->response = raw.toResponseData();
+	// for ab test connection should be closed after CGI
+	cgi->response->shouldClose = true;
 
-		server.cleanupCgiFds(*cgi);
+	state.removeCgi(pid);
+	markReady(clientId);
+}
 
-		break;
-	}
+void ConnectionManager::forgetCgi(pid_t pid)
+{
+	m_cgiOwners.erase(pid);
 }
@@ -3,11 +3,11 @@
 
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <cstdint>
 #include <sstream>
 #include <filesystem>
-#include <sys/epoll.h>
 
 #include "RawRequest.hpp"
 #include "ClientState.hpp"
@@ -29,9 +29,14 @@ class ConnectionManager
     // Properties
     const Config& m_config;
     std::unordered_map<int, ClientState> m_clients;
+    std::unordered_map<pid_t, int> m_cgiOwners; // CGI pid -> client id
+    std::vector<pid_t> m_startedCgis; // not yet registered for events
+    std::vector<int> m_readyClients; // have responses to hand to the Server
 
     // Methods
-    size_t processReqs(Client& client, const std::string& tcpData);
+    size_t processReqs(Client& client, std::string_view tcpData);
+    void onHeadersDone(const Client& client, ClientState& clientState,
+                       RawRequest& rawReq);
     void genResps(Client& client);
 
   public:
@@ -50,10 +55,13 @@ class ConnectionManager
     // Methods
     void addClient(int clientId);
     void removeClient(int clientId);
-    void processData(Client& client, const std::string& tcpData);
-    CGIData* findCgiByStdoutFd(int fd);
-    CGIData* findCgiByStdinFd(int fd);
+    void processData(Client& client, std::string_view tcpData);
+    std::vector<CGIData*> takeStartedCgis();
+    void markReady(int clientId);
+    std::vector<int> takeReadyClients();
+    int cgiOwner(pid_t pid) const;
     void onCgiExited(Server& server, pid_t pid, int status);
+    void forgetCgi(pid_t pid);
 };
 
 #endif
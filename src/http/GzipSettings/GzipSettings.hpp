@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef GZIPSETTINGS_HPP
+# define GZIPSETTINGS_HPP
+
+# include <string>
+# include <vector>
+
+// On-the-fly compression of responses (gzip, gzip_types, ...)
+struct GzipSettings
+{
+    bool enabled = false;
+    size_t level = 1;
+    size_t minLength = 20;
+    std::vector<std::string> types{}; // text/html is always compressed
+
+    // Parameters such as "; charset=utf-8" don't matter
+    bool compresses(const std::string& mimeType) const
+    {
+        const std::string type = mimeType.substr(0, mimeType.find(';'));
+        if (type == "text/html")
+            return true;
+        for (const std::string& t : types)
+            if (t == "*" || t == type)
+                return true;
+        return false;
+    }
+
+    // Whether a body of this type and length goes out compressed
+    bool appliesTo(const std::string& mimeType, size_t length) const
+    {
+        return enabled && length >= minLength && compresses(mimeType);
+    }
+};
+
+#endif
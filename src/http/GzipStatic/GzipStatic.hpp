@@ -0,0 +1,14 @@
+#pragma once
+
+#ifndef GZIPSTATIC_HPP
+# define GZIPSTATIC_HPP
+
+// Whether precompressed siblings (.br, .gz) of static files are sent
+enum class GzipStatic
+{
+    Off,
+    On,    // when the client accepts the encoding
+    Always // .gz whatever the client accepts
+};
+
+#endif
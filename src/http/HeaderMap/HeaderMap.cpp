@@ -0,0 +1,197 @@
+#include "HeaderMap.hpp"
+
+namespace
+{
+    constexpr unsigned char lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+            if (lower(a[i]) != lower(b[i]))
+                return false;
+        return true;
+    }
+
+    // Length, first and last byte tell all the known names apart
+    constexpr size_t TABLE_SIZE = 64;
+
+    constexpr size_t hashOf(std::string_view name)
+    {
+        return (name.size() * 2 + lower(name.front()) * 17
+                + lower(name.back()) * 5) % TABLE_SIZE;
+    }
+
+    constexpr std::array<HeaderNames::Id, TABLE_SIZE> buildTable()
+    {
+        std::array<HeaderNames::Id, TABLE_SIZE> table{};
+        for (size_t i = 0; i < TABLE_SIZE; ++i)
+            table[i] = HeaderNames::Id::Other;
+        for (size_t i = 0; i < HeaderNames::KNOWN; ++i)
+            table[hashOf(HeaderNames::NAMES[i])] = static_cast<HeaderNames::Id>(i);
+        return table;
+    }
+
+    constexpr std::array<HeaderNames::Id, TABLE_SIZE> TABLE = buildTable();
+
+    constexpr bool isPerfect()
+    {
+        for (size_t i = 0; i < HeaderNames::KNOWN; ++i)
+            if (TABLE[hashOf(HeaderNames::NAMES[i])] != static_cast<HeaderNames::Id>(i))
+                return false;
+        return true;
+    }
+
+    static_assert(isPerfect(), "two well-known header names share a slot");
+}
+
+template <typename Str>
+const Str BasicHeaderMap<Str>::EMPTY{};
+
+// ---------------------------ACCESSORS-----------------------------
+
+HeaderNames::Id HeaderNames::idOf(std::string_view name)
+{
+    if (name.empty())
+        return Id::Other;
+
+    Id id = TABLE[hashOf(name)];
+    if (id != Id::Other
+        && !equalsIgnoreCase(NAMES[static_cast<size_t>(id)], name))
+        return Id::Other;
+    return id;
+}
+
+template <typename Str>
+bool BasicHeaderMap<Str>::empty() const
+{
+    return m_entries.empty();
+}
+
+template <typename Str>
+size_t BasicHeaderMap<Str>::size() const
+{
+    return m_entries.size();
+}
+
+template <typename Str>
+typename BasicHeaderMap<Str>::const_iterator BasicHeaderMap<Str>::begin() const
+{
+    return m_entries.begin();
+}
+
+template <typename Str>
+typename BasicHeaderMap<Str>::const_iterator BasicHeaderMap<Str>::end() const
+{
+    return m_entries.end();
+}
+
+template <typename Str>
+typename BasicHeaderMap<Str>::iterator BasicHeaderMap<Str>::begin()
+{
+    return m_entries.begin();
+}
+
+template <typename Str>
+typename BasicHeaderMap<Str>::iterator BasicHeaderMap<Str>::end()
+{
+    return m_entries.end();
+}
+
+template <typename Str>
+typename BasicHeaderMap<Str>::const_iterator BasicHeaderMap<Str>::find(std::string_view name) const
+{
+    size_t index = indexOf(name, idOf(name));
+    return index == std::string::npos ? end() : begin() + index;
+}
+
+template <typename Str>
+typename BasicHeaderMap<Str>::iterator BasicHeaderMap<Str>::find(std::string_view name)
+{
+    size_t index = indexOf(name, idOf(name));
+    return index == std::string::npos ? end() : begin() + index;
+}
+
+template <typename Str>
+size_t BasicHeaderMap<Str>::count(std::string_view name) const
+{
+    return indexOf(name, idOf(name)) == std::string::npos ? 0 : 1;
+}
+
+template <typename Str>
+const Str& BasicHeaderMap<Str>::get(std::string_view name) const
+{
+    size_t index = indexOf(name, idOf(name));
+    return index == std::string::npos ? EMPTY : m_entries[index].second;
+}
+
+// ---------------------------METHODS-----------------------------
+
+template <typename Str>
+Str& BasicHeaderMap<Str>::operator[](std::string_view name)
+{
+    Id id = idOf(name);
+    size_t index = indexOf(name, id);
+    if (index != std::string::npos)
+        return m_entries[index].second;
+
+    if (id != Id::Other)
+    {
+        m_entries.emplace_back(NAMES[static_cast<size_t>(id)], Str());
+        m_slots[static_cast<size_t>(id)] = m_entries.size();
+    }
+    else
+        m_entries.emplace_back(name, Str());
+    m_ids.push_back(id);
+    return m_entries.back().second;
+}
+
+template <typename Str>
+size_t BasicHeaderMap<Str>::erase(std::string_view name)
+{
+    Id id = idOf(name);
+    size_t index = indexOf(name, id);
+    if (index == std::string::npos)
+        return 0;
+
+    m_entries.erase(m_entries.begin() + index);
+    m_ids.erase(m_ids.begin() + index);
+    if (id != Id::Other)
+        m_slots[static_cast<size_t>(id)] = 0;
+
+    // The entries behind it moved one place up
+    for (uint32_t& slot : m_slots)
+        if (slot > index + 1)
+            --slot;
+    return 1;
+}
+
+template <typename Str>
+void BasicHeaderMap<Str>::clear()
+{
+    m_entries.clear();
+    m_ids.clear();
+    m_slots.fill(0);
+}
+
+template <typename Str>
+size_t BasicHeaderMap<Str>::indexOf(std::string_view name, Id id) const
+{
+    if (id != Id::Other)
+    {
+        uint32_t slot = m_slots[static_cast<size_t>(id)];
+        return slot ? slot - 1 : std::string::npos;
+    }
+
+    for (size_t i = 0; i < m_entries.size(); ++i)
+        if (m_ids[i] == Id::Other && equalsIgnoreCase(m_entries[i].first, name))
+            return i;
+    return std::string::npos;
+}
+
+template class BasicHeaderMap<std::string>;
+template class BasicHeaderMap<std::string_view>;
@@ -0,0 +1,147 @@
+#pragma once
+
+#ifndef HEADERMAP_HPP
+# define HEADERMAP_HPP
+
+# include <array>
+# include <cstdint>
+# include <string>
+# include <string_view>
+# include <utility>
+# include <vector>
+
+// The well-known header names. Each has a fixed slot in a header map,
+// found through a perfect hash of the lowercased name, so looking them
+// up neither allocates nor scans.
+class HeaderNames
+{
+  public:
+    // The well-known names, in the order of NAMES
+    enum class Id : uint8_t
+    {
+        Accept,
+        AcceptEncoding,
+        AcceptLanguage,
+        AcceptRanges,
+        Allow,
+        Authorization,
+        CacheControl,
+        Connection,
+        ContentDisposition,
+        ContentEncoding,
+        ContentLength,
+        ContentRange,
+        ContentType,
+        Cookie,
+        Date,
+        ETag,
+        Expect,
+        Host,
+        IfModifiedSince,
+        IfNoneMatch,
+        IfRange,
+        KeepAlive,
+        LastModified,
+        Location,
+        Origin,
+        Range,
+        Referer,
+        Server,
+        SetCookie,
+        TransferEncoding,
+        Upgrade,
+        UserAgent,
+        Vary,
+        Other // not a well-known name
+    };
+
+    // Constants
+    static constexpr size_t KNOWN = static_cast<size_t>(Id::Other);
+    static constexpr std::array<std::string_view, KNOWN> NAMES = {{
+        "Accept", "Accept-Encoding", "Accept-Language", "Accept-Ranges",
+        "Allow", "Authorization", "Cache-Control", "Connection",
+        "Content-Disposition", "Content-Encoding", "Content-Length",
+        "Content-Range", "Content-Type", "Cookie", "Date", "ETag", "Expect",
+        "Host", "If-Modified-Since", "If-None-Match", "If-Range",
+        "Keep-Alive", "Last-Modified", "Location", "Origin", "Range",
+        "Referer", "Server", "Set-Cookie", "Transfer-Encoding", "Upgrade",
+        "User-Agent", "Vary"
+    }};
+
+    // Accessors
+    static Id idOf(std::string_view name);
+};
+
+// Header fields, with case-insensitive names. Fields are kept in a flat
+// vector, in the order they were added. The well-known names are found
+// through their slot; other names are searched for in the vector. A
+// known name is stored in its usual spelling, any other one as it was
+// first added.
+// Str is std::string, or std::string_view when the names and values
+// point into a buffer that outlives the map (a received header block).
+template <typename Str>
+class BasicHeaderMap : public HeaderNames
+{
+    // Construction and destruction
+  public:
+    BasicHeaderMap() = default;
+    BasicHeaderMap(const BasicHeaderMap& other) = default;
+    BasicHeaderMap& operator=(const BasicHeaderMap& other) = default;
+    BasicHeaderMap(BasicHeaderMap&& other) noexcept = default;
+    BasicHeaderMap& operator=(BasicHeaderMap&& other) noexcept = default;
+    ~BasicHeaderMap() = default;
+
+    // Copies the fields of a map with another string type
+    template <typename OtherStr>
+    explicit BasicHeaderMap(const BasicHeaderMap<OtherStr>& other)
+      : m_ids(other.m_ids), m_slots(other.m_slots)
+    {
+        m_entries.reserve(other.m_entries.size());
+        for (const auto& [name, value] : other.m_entries)
+            m_entries.emplace_back(Str(name), Str(value));
+    }
+
+    // Class specific features
+  public:
+    using Entry = std::pair<Str, Str>;
+    using iterator = typename std::vector<Entry>::iterator;
+    using const_iterator = typename std::vector<Entry>::const_iterator;
+
+    // Accessors
+    bool empty() const;
+    size_t size() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    iterator begin();
+    iterator end();
+    const_iterator find(std::string_view name) const;
+    iterator find(std::string_view name);
+    size_t count(std::string_view name) const;
+    const Str& get(std::string_view name) const; // "" if absent
+
+    // Methods
+    Str& operator[](std::string_view name); // added if absent
+    size_t erase(std::string_view name);
+    void clear();
+
+  private:
+    template <typename OtherStr>
+    friend class BasicHeaderMap;
+
+    // Properties
+    static const Str EMPTY;
+    std::vector<Entry> m_entries;
+    std::vector<Id> m_ids; // parallel to m_entries
+    std::array<uint32_t, KNOWN> m_slots{}; // entry index + 1, 0: absent
+
+    // Methods
+    size_t indexOf(std::string_view name, Id id) const;
+};
+
+extern template class BasicHeaderMap<std::string>;
+extern template class BasicHeaderMap<std::string_view>;
+
+using HeaderMap = BasicHeaderMap<std::string>;
+using HeaderViewMap = BasicHeaderMap<std::string_view>;
+
+#endif
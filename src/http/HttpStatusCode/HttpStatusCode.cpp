@@ -1,5 +1,8 @@
 #include "HttpStatusCode.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 std::string codeToText(HttpStatusCode code)
 {
 	switch (code)
@@ -69,4 +72,89 @@ std::string codeToText(HttpStatusCode code)
 		case HttpStatusCode::NetworkAuthenticationRequired: return "Network Authentication Required";
 		default: return "Unknown";
 	}
-}
\ No newline at end of file
+}
+
+namespace
+{
+	struct StatusLine
+	{
+		HttpStatusCode code;
+		std::string_view line;
+	};
+
+	// Sorted by code, rendered at compile time
+	constexpr StatusLine STATUS_LINES[] = {
+	{HttpStatusCode::Continue, "HTTP/1.1 100 Continue\r\n"},
+	{HttpStatusCode::SwitchingProtocols, "HTTP/1.1 101 Switching Protocols\r\n"},
+	{HttpStatusCode::Processing, "HTTP/1.1 102 Processing\r\n"},
+	{HttpStatusCode::EarlyHints, "HTTP/1.1 103 Early Hints\r\n"},
+	{HttpStatusCode::OK, "HTTP/1.1 200 OK\r\n"},
+	{HttpStatusCode::Created, "HTTP/1.1 201 Created\r\n"},
+	{HttpStatusCode::Accepted, "HTTP/1.1 202 Accepted\r\n"},
+	{HttpStatusCode::NonAuthoritativeInformation, "HTTP/1.1 203 Non-Authoritative Information\r\n"},
+	{HttpStatusCode::NoContent, "HTTP/1.1 204 No Content\r\n"},
+	{HttpStatusCode::ResetContent, "HTTP/1.1 205 Reset Content\r\n"},
+	{HttpStatusCode::PartialContent, "HTTP/1.1 206 Partial Content\r\n"},
+	{HttpStatusCode::MultiStatus, "HTTP/1.1 207 Multi Status\r\n"},
+	{HttpStatusCode::AlreadyReported, "HTTP/1.1 208 Already Reported\r\n"},
+	{HttpStatusCode::ImUsed, "HTTP/1.1 226 IM Used\r\n"},
+	{HttpStatusCode::MultipleChoices, "HTTP/1.1 300 Multiple Choices\r\n"},
+	{HttpStatusCode::MovedPermanently, "HTTP/1.1 301 Moved Permanently\r\n"},
+	{HttpStatusCode::Found, "HTTP/1.1 302 Found\r\n"},
+	{HttpStatusCode::SeeOther, "HTTP/1.1 303 See Other\r\n"},
+	{HttpStatusCode::NotModified, "HTTP/1.1 304 Not Modified\r\n"},
+	{HttpStatusCode::UseProxy, "HTTP/1.1 305 Use Proxy\r\n"},
+	{HttpStatusCode::TemporaryRedirect, "HTTP/1.1 307 Temporary Redirect\r\n"},
+	{HttpStatusCode::PermanentRedirect, "HTTP/1.1 308 Permanent Redirect\r\n"},
+	{HttpStatusCode::BadRequest, "HTTP/1.1 400 Bad Request\r\n"},
+	{HttpStatusCode::Unauthorized, "HTTP/1.1 401 Unauthorized\r\n"},
+	{HttpStatusCode::PaymentRequired, "HTTP/1.1 402 Payment Required\r\n"},
+	{HttpStatusCode::Forbidden, "HTTP/1.1 403 Forbidden\r\n"},
+	{HttpStatusCode::NotFound, "HTTP/1.1 404 Not Found\r\n"},
+	{HttpStatusCode::MethodNotAllowed, "HTTP/1.1 405 Method Not Allowed\r\n"},
+	{HttpStatusCode::NotAcceptable, "HTTP/1.1 406 Not Acceptable\r\n"},
+	{HttpStatusCode::ProxyAuthenticationRequired, "HTTP/1.1 407 Proxy Authentication Required\r\n"},
+	{HttpStatusCode::RequestTimeout, "HTTP/1.1 408 Request Timeout\r\n"},
+	{HttpStatusCode::Conflict, "HTTP/1.1 409 Conflict\r\n"},
+	{HttpStatusCode::Gone, "HTTP/1.1 410 Gone\r\n"},
+	{HttpStatusCode::LengthRequired, "HTTP/1.1 411 Length Required\r\n"},
+	{HttpStatusCode::PreconditionFailed, "HTTP/1.1 412 Precondition Failed\r\n"},
+	{HttpStatusCode::PayloadTooLarge, "HTTP/1.1 413 Payload Too Large\r\n"},
+	{HttpStatusCode::UriTooLong, "HTTP/1.1 414 URI Too Long\r\n"},
+	{HttpStatusCode::UnsupportedMediaType, "HTTP/1.1 415 Unsupported Media Type\r\n"},
+	{HttpStatusCode::RangeNotSatisfiable, "HTTP/1.1 416 Range Not Satisfiable\r\n"},
+	{HttpStatusCode::ExpectationFailed, "HTTP/1.1 417 Expectation Failed\r\n"},
+	{HttpStatusCode::ImATeapot, "HTTP/1.1 418 I'm A Teapot\r\n"},
+	{HttpStatusCode::MisdirectedRequest, "HTTP/1.1 421 Misdirected Request\r\n"},
+	{HttpStatusCode::UnprocessableEntity, "HTTP/1.1 422 Unprocessable Entity\r\n"},
+	{HttpStatusCode::Locked, "HTTP/1.1 423 Locked\r\n"},
+	{HttpStatusCode::FailedDependency, "HTTP/1.1 424 Failed Dependency\r\n"},
+	{HttpStatusCode::TooEarly, "HTTP/1.1 425 Too Early\r\n"},
+	{HttpStatusCode::UpgradeRequired, "HTTP/1.1 426 Upgrade Required\r\n"},
+	{HttpStatusCode::PreconditionRequired, "HTTP/1.1 428 Precondition Required\r\n"},
+	{HttpStatusCode::TooManyRequests, "HTTP/1.1 429 Too Many Requests\r\n"},
+	{HttpStatusCode::RequestHeaderFieldsTooLarge, "HTTP/1.1 431 Request Header Fields Too Large\r\n"},
+	{HttpStatusCode::UnavailableForLegalReasons, "HTTP/1.1 451 Unavailable For Legal Reasons\r\n"},
+	{HttpStatusCode::InternalServerError, "HTTP/1.1 500 Internal Server Error\r\n"},
+	{HttpStatusCode::NotImplemented, "HTTP/1.1 501 Not Implemented\r\n"},
+	{HttpStatusCode::BadGateway, "HTTP/1.1 502 Bad Gateway\r\n"},
+	{HttpStatusCode::ServiceUnavailable, "HTTP/1.1 503 Service Unavailable\r\n"},
+	{HttpStatusCode::GatewayTimeout, "HTTP/1.1 504 Gateway Timeout\r\n"},
+	{HttpStatusCode::HttpVersionNotSupported, "HTTP/1.1 505 HTTP Version Not Supported\r\n"},
+	{HttpStatusCode::VariantAlsoNegotiates, "HTTP/1.1 506 Variant Also Negotiates\r\n"},
+	{HttpStatusCode::InsufficientStorage, "HTTP/1.1 507 Insufficient Storage\r\n"},
+	{HttpStatusCode::LoopDetected, "HTTP/1.1 508 Loop Detected\r\n"},
+	{HttpStatusCode::NotExtended, "HTTP/1.1 510 Not Extended\r\n"},
+	{HttpStatusCode::NetworkAuthenticationRequired, "HTTP/1.1 511 Network Authentication Required\r\n"},
+	};
+}
+
+std::string_view statusLine(HttpStatusCode code)
+{
+	const StatusLine* end = std::end(STATUS_LINES);
+	const StatusLine* it = std::lower_bound(std::begin(STATUS_LINES), end, code,
+		[](const StatusLine& entry, HttpStatusCode c) { return entry.code < c; });
+	if (it == end || it->code != code)
+		return {};
+	return it->line;
+}
@@ -2,6 +2,7 @@
 # define HTTPSTATUSCODE_HPP
 
 #include <string>
+#include <string_view>
 
 enum class HttpStatusCode
 {
@@ -81,5 +82,7 @@ enum class HttpStatusCode
 };
 
 std::string codeToText(HttpStatusCode code);
+// "HTTP/1.1 NNN Reason\r\n", empty for codes without a reason phrase
+std::string_view statusLine(HttpStatusCode code);
 
 #endif
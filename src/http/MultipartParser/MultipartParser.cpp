@@ -0,0 +1,387 @@
+#include "MultipartParser.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ByteScan.hpp"
+
+// -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
+
+// The carry starts as a CRLF, so a delimiter right at the start of the
+// body is found like any other
+MultipartParser::MultipartParser(std::string_view boundary,
+                                 const std::string& uploadStore)
+  : m_delimiter("\r\n--" + std::string(boundary))
+  , m_uploadStore(uploadStore)
+  , m_stage(Stage::BODY)
+  , m_carry("\r\n")
+  , m_headers()
+  , m_fd(-1)
+  , m_tempName()
+  , m_partPath()
+  , m_savedFiles()
+  , m_createdFiles()
+  , m_replacements()
+  , m_partCount(0)
+  , m_isMalformed(false)
+  , m_hasFailed(false)
+{
+}
+
+MultipartParser::~MultipartParser()
+{
+    discardPart();
+    for (const auto& replacement : m_replacements)
+        unlink(replacement.first.c_str());
+    if (!isDone())
+        for (const std::string& path : m_createdFiles)
+            unlink(path.c_str());
+}
+
+// ---------------------------ACCESSORS-----------------------------
+
+bool MultipartParser::isDone() const
+{
+    return m_stage == Stage::DONE && !m_isMalformed && !m_hasFailed;
+}
+
+bool MultipartParser::isMalformed() const
+{
+    return m_isMalformed;
+}
+
+bool MultipartParser::hasFailed() const
+{
+    return m_hasFailed;
+}
+
+const std::vector<std::string>& MultipartParser::savedFiles() const
+{
+    return m_savedFiles;
+}
+
+// ---------------------------METHODS-----------------------------
+
+void MultipartParser::feed(std::string_view data)
+{
+    while (!data.empty() && m_stage != Stage::DONE && !m_isMalformed
+           && !m_hasFailed)
+    {
+        switch (m_stage)
+        {
+        case Stage::BODY:
+            data.remove_prefix(parseBody(data));
+            break;
+        case Stage::HEADERS:
+            data.remove_prefix(parseHeaders(data));
+            break;
+        default:
+            data.remove_prefix(parseBoundaryEnd(data));
+            break;
+        }
+    }
+}
+
+// The boundary parameter of a Content-Type, "" if there's none
+std::string MultipartParser::extractBoundary(std::string_view contentType)
+{
+    const std::string_view key = "boundary=";
+    size_t keyPos = contentType.find(key);
+    if (keyPos == std::string_view::npos)
+        return {};
+
+    std::string_view value = contentType.substr(keyPos + key.size());
+    value = value.substr(0, value.find(';'));
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t'))
+        value.remove_suffix(1);
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+        value = value.substr(1, value.size() - 2);
+
+    return std::string(value);
+}
+
+std::string MultipartParser::extractFileName(std::string_view headers)
+{
+    const std::string_view prefix = "filename=\"";
+    size_t prefixPos = headers.find(prefix);
+    if (prefixPos == std::string_view::npos)
+        return {};
+
+    size_t openBracePos = prefixPos + prefix.length();
+    size_t closeBracePos = headers.find('"', openBracePos);
+    if (closeBracePos == std::string_view::npos)
+        return {};
+
+    return std::string(headers.substr(openBracePos, closeBracePos - openBracePos));
+}
+
+// Passes on the data up to the next delimiter and returns how much of
+// it was used. Data that may be the start of a delimiter is held back
+// until the next piece tells.
+size_t MultipartParser::parseBody(std::string_view data)
+{
+    const size_t delimiterSize = m_delimiter.size();
+
+    if (!m_carry.empty())
+    {
+        // A delimiter starting in the carry ends in this window
+        size_t carried = m_carry.size();
+        m_carry.append(data.substr(0, delimiterSize));
+        size_t pos = ByteScan::find(m_carry, m_delimiter);
+        if (pos != std::string::npos)
+        {
+            writePart(std::string_view(m_carry).substr(0, pos));
+            m_carry.clear();
+            onDelimiter();
+            return pos + delimiterSize - carried;
+        }
+        if (data.size() >= delimiterSize)
+        {
+            writePart(std::string_view(m_carry).substr(0, carried));
+            m_carry.clear();
+            return 0;
+        }
+        size_t keep = partialDelimiter(m_carry);
+        writePart(std::string_view(m_carry).substr(0, m_carry.size() - keep));
+        m_carry.erase(0, m_carry.size() - keep);
+        return data.size();
+    }
+
+    size_t pos = ByteScan::find(data, m_delimiter);
+    if (pos != std::string_view::npos)
+    {
+        writePart(data.substr(0, pos));
+        onDelimiter();
+        return pos + delimiterSize;
+    }
+
+    size_t keep = partialDelimiter(data);
+    writePart(data.substr(0, data.size() - keep));
+    m_carry.assign(data.substr(data.size() - keep));
+    return data.size();
+}
+
+// What follows a delimiter: optional padding and a CRLF before the
+// headers of the next part, or "--" after the last one
+size_t MultipartParser::parseBoundaryEnd(std::string_view data)
+{
+    size_t pos = 0;
+
+    while (pos < data.size() && m_stage != Stage::HEADERS
+           && m_stage != Stage::DONE)
+    {
+        char c = data[pos++];
+
+        if (m_stage == Stage::BOUNDARY_END && c == '-')
+            m_stage = Stage::CLOSING_DASH;
+        else if (m_stage == Stage::BOUNDARY_END && c == '\r')
+            m_stage = Stage::BOUNDARY_LF;
+        else if (m_stage == Stage::BOUNDARY_END && (c == ' ' || c == '\t'))
+            continue;
+        else if (m_stage == Stage::CLOSING_DASH && c == '-')
+        {
+            m_stage = Stage::DONE;
+            replaceExisting();
+        }
+        else if (m_stage == Stage::BOUNDARY_LF && c == '\n')
+        {
+            // Makes an empty header block end like any other
+            m_headers = "\r\n";
+            m_stage = Stage::HEADERS;
+        }
+        else
+        {
+            markMalformed();
+            return data.size();
+        }
+    }
+    return pos;
+}
+
+// Buffers the headers of a part, up to MAX_PART_HEADERS
+size_t MultipartParser::parseHeaders(std::string_view data)
+{
+    size_t before = m_headers.size();
+    size_t scanFrom = before < 3 ? 0 : before - 3;
+    size_t take = std::min(data.size(), MAX_PART_HEADERS + 4 - before);
+    m_headers.append(data.substr(0, take));
+
+    size_t end = ByteScan::findHeaderEnd(m_headers, scanFrom);
+    if (end == std::string::npos)
+    {
+        if (m_headers.size() >= MAX_PART_HEADERS + 4)
+            markMalformed();
+        return take;
+    }
+
+    std::string_view headers = std::string_view(m_headers).substr(0, end);
+    startPart(headers.substr(std::min<size_t>(2, headers.size())));
+    m_headers.clear();
+    m_stage = Stage::BODY;
+    return end + 4 - before;
+}
+
+// The length of the longest end of data that starts a delimiter
+size_t MultipartParser::partialDelimiter(std::string_view data) const
+{
+    size_t from = data.size() >= m_delimiter.size()
+                      ? data.size() - m_delimiter.size() + 1
+                      : 0;
+
+    for (size_t i = ByteScan::find(data, '\r', from); i != std::string_view::npos;
+         i = ByteScan::find(data, '\r', i + 1))
+    {
+        if (m_delimiter.compare(0, data.size() - i, data.substr(i)) == 0)
+            return data.size() - i;
+    }
+    return 0;
+}
+
+void MultipartParser::onDelimiter()
+{
+    finishPart();
+    m_stage = Stage::BOUNDARY_END;
+}
+
+// Only parts with a file name are kept, in a file of that name
+void MultipartParser::startPart(std::string_view headers)
+{
+    std::string fileName = extractFileName(headers);
+    if (fileName.empty())
+        return;
+
+    m_partPath = m_uploadStore + "/" + fileName;
+    openTempFile();
+}
+
+// Anonymous where the filesystem supports it, a hidden name otherwise
+void MultipartParser::openTempFile()
+{
+    m_fd = open(m_uploadStore.c_str(), O_TMPFILE | O_WRONLY | O_CLOEXEC, 0666);
+    if (m_fd != -1)
+        return;
+    if (errno != EOPNOTSUPP && errno != EISDIR && errno != EINVAL)
+        return markFailed();
+
+    std::string name = m_uploadStore + "/.webserv_part_XXXXXX";
+    m_fd = mkostemp(name.data(), O_CLOEXEC);
+    if (m_fd == -1)
+        return markFailed();
+    fchmod(m_fd, 0644);
+    m_tempName = std::move(name);
+}
+
+void MultipartParser::writePart(std::string_view data)
+{
+    while (m_fd != -1 && !data.empty())
+    {
+        ssize_t written = write(m_fd, data.data(), data.size());
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return markFailed();
+        data.remove_prefix(written);
+    }
+}
+
+// Gives the complete part its name, if it's a new one. A part for an
+// existing file keeps a hidden name until the form is complete. Returns
+// false if neither worked.
+bool MultipartParser::publishPart()
+{
+    std::string self = "/proc/self/fd/" + std::to_string(m_fd);
+    int linked = m_tempName.empty()
+                     ? linkat(AT_FDCWD, self.c_str(), AT_FDCWD,
+                              m_partPath.c_str(), AT_SYMLINK_FOLLOW)
+                     : link(m_tempName.c_str(), m_partPath.c_str());
+    if (linked == 0)
+    {
+        if (!m_tempName.empty())
+            unlink(m_tempName.c_str());
+        m_tempName.clear();
+        m_createdFiles.push_back(m_partPath);
+        return true;
+    }
+    if (errno != EEXIST || (m_tempName.empty() && !linkTempName()))
+        return false;
+
+    m_replacements.emplace_back(std::move(m_tempName), m_partPath);
+    m_tempName.clear();
+    return true;
+}
+
+// Links the anonymous temp file under a free hidden name
+bool MultipartParser::linkTempName()
+{
+    std::string self = "/proc/self/fd/" + std::to_string(m_fd);
+    int linked;
+    do
+    {
+        m_tempName = m_uploadStore + "/.webserv_part_"
+                     + std::to_string(getpid()) + "_"
+                     + std::to_string(reinterpret_cast<uintptr_t>(this)) + "_"
+                     + std::to_string(m_partCount++);
+        linked = linkat(AT_FDCWD, self.c_str(), AT_FDCWD, m_tempName.c_str(),
+                        AT_SYMLINK_FOLLOW);
+    } while (linked == -1 && errno == EEXIST);
+
+    if (linked == -1)
+        m_tempName.clear();
+    return linked == 0;
+}
+
+// The form is complete: each waiting part replaces its file in one
+// rename, so the file is never seen missing or half written
+void MultipartParser::replaceExisting()
+{
+    size_t done = 0;
+    for (; done < m_replacements.size(); ++done)
+    {
+        const auto& [temp, path] = m_replacements[done];
+        if (rename(temp.c_str(), path.c_str()) == -1)
+            break;
+    }
+    m_replacements.erase(m_replacements.begin(), m_replacements.begin() + done);
+    if (!m_replacements.empty())
+        markFailed();
+}
+
+void MultipartParser::finishPart()
+{
+    if (m_fd == -1)
+        return;
+    if (!publishPart())
+        return markFailed();
+    m_savedFiles.push_back(m_partPath);
+    if (close(m_fd) == -1)
+        m_hasFailed = true;
+    m_fd = -1;
+}
+
+// The temp file of an incomplete part goes away with its descriptor
+void MultipartParser::discardPart()
+{
+    if (m_fd == -1)
+        return;
+    close(m_fd);
+    m_fd = -1;
+    if (!m_tempName.empty())
+        unlink(m_tempName.c_str());
+    m_tempName.clear();
+}
+
+void MultipartParser::markMalformed()
+{
+    m_isMalformed = true;
+    discardPart();
+}
+
+void MultipartParser::markFailed()
+{
+    m_hasFailed = true;
+    discardPart();
+}
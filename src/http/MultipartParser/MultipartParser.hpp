@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef MULTIPARTPARSER_HPP
+# define MULTIPARTPARSER_HPP
+
+# include <string>
+# include <string_view>
+# include <utility>
+# include <vector>
+
+// Incremental multipart/form-data parser. It is fed the body as it
+// arrives, in pieces of any size, and writes every file part straight
+// into the upload store; other parts are skipped. Only a delimiter split
+// across two pieces and the headers of the current part are ever
+// buffered, so memory stays the same whatever the upload size.
+// A part is written to an anonymous temp file in the upload store and
+// only gets its name once its closing delimiter was seen, so a half
+// written file is never visible. A part for a name that already exists
+// waits under a hidden name, and replaces the file only once the whole
+// form was received. If it isn't, the files this parser created and the
+// waiting parts are removed again, and existing files stay untouched.
+class MultipartParser
+{
+    // Construction and destruction
+  public:
+    MultipartParser() = delete;
+    MultipartParser(std::string_view boundary, const std::string& uploadStore);
+    MultipartParser(const MultipartParser& other) = delete;
+    MultipartParser& operator=(const MultipartParser& other) = delete;
+    MultipartParser(MultipartParser&& other) noexcept = delete;
+    MultipartParser& operator=(MultipartParser&& other) noexcept = delete;
+    ~MultipartParser();
+
+    // Class specific features
+  public:
+    // Constants
+    static constexpr size_t MAX_PART_HEADERS = 8 * 1024;
+
+    // Accessors
+    bool isDone() const; // closing delimiter seen, every file written
+    bool isMalformed() const;
+    bool hasFailed() const; // a file couldn't be written
+    const std::vector<std::string>& savedFiles() const;
+
+    // Methods
+    void feed(std::string_view data);
+    static std::string extractBoundary(std::string_view contentType);
+    static std::string extractFileName(std::string_view headers);
+
+  private:
+    // Where the parser stopped, so the next piece resumes right there
+    enum class Stage
+    {
+        BODY,          // data of a part, or the preamble
+        BOUNDARY_END,  // after a delimiter: padding, CRLF or "--"
+        CLOSING_DASH,
+        BOUNDARY_LF,
+        HEADERS,
+        DONE           // the epilogue, ignored
+    };
+
+    // Properties
+    std::string m_delimiter; // "\r\n--" boundary
+    std::string m_uploadStore;
+    Stage m_stage;
+    std::string m_carry; // end of the data that may start a delimiter
+    std::string m_headers;
+    int m_fd; // of the current file part, -1 if it isn't one
+    std::string m_tempName; // of the part's temp file, "" if anonymous
+    std::string m_partPath; // where the current part goes once complete
+    std::vector<std::string> m_savedFiles;
+    std::vector<std::string> m_createdFiles; // didn't exist before
+    // Complete parts under their hidden name, and the file they replace
+    std::vector<std::pair<std::string, std::string>> m_replacements;
+    size_t m_partCount;
+    bool m_isMalformed;
+    bool m_hasFailed;
+
+    // Methods
+    size_t parseBody(std::string_view data);
+    size_t parseBoundaryEnd(std::string_view data);
+    size_t parseHeaders(std::string_view data);
+    size_t partialDelimiter(std::string_view data) const;
+    void onDelimiter();
+    void startPart(std::string_view headers);
+    void openTempFile();
+    void writePart(std::string_view data);
+    bool publishPart();
+    bool linkTempName();
+    void replaceExisting();
+    void finishPart();
+    void discardPart();
+    void markMalformed();
+    void markFailed();
+};
+
+#endif
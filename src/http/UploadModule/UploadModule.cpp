@@ -1,8 +1,5 @@
 #include "UploadModule.hpp"
 
-using FormField = UploadModule::FormField;
-using FileField = UploadModule::FileField;
-
 // ---------------------------METHODS-----------------------------
 
 // clang-format off
@@ -25,176 +22,91 @@ Data inside second file\n\r\n
 */
 // clang-format on
 
-void UploadModule::processUpload(const RequestData& req, const RequestContext& ctx,
+void UploadModule::processUpload(RequestData& req, const RequestContext& ctx,
                                  RawResponse& resp)
 {
-    if (isMultipartFormData(req))
-    {
-        std::vector<std::string> savedFiles
-            = processMultipartFormData(req, ctx.upload_store);
-        return create201Response(resp, savedFiles);
-    }
+    const std::string& contentType = req.getHeader("Content-Type");
+    if (isMultipartFormData(contentType))
+        return processMultipartFormData(req, ctx.upload_store, resp);
 
-    std::string extension
-        = MimeTypeRecognizer::getExtension(req.getHeader("Content-Type"));
+    std::string extension = MimeTypeRecognizer::getExtension(contentType);
     if (!extension.empty())
     {
-        std::string filePath = saveFile(
-            {generateRandomName() + extension, req.body}, ctx.upload_store);
+        std::string filePath = saveBody(
+            req.body, generateRandomName() + extension, ctx.upload_store);
         return create201Response(resp, {filePath});
     }
 
     return create415Response(resp);
 }
 
-bool UploadModule::isMultipartFormData(const RequestData& req)
+bool UploadModule::isMultipartFormData(std::string_view contentType)
 {
-    const std::string& headerValue = req.getHeader("Content-Type");
-    const std::string& prefix = "multipart/form-data";
+    const std::string_view prefix = "multipart/form-data";
 
-    return headerValue.compare(0, prefix.length(), prefix) == 0;
+    return contentType.compare(0, prefix.length(), prefix) == 0;
 }
 
-std::vector<std::string> UploadModule::processMultipartFormData(
-    const RequestData& req, const std::string& uploadStore)
+std::unique_ptr<MultipartParser> UploadModule::createMultipartParser(
+    std::string_view contentType, const std::string& uploadStore)
 {
-    const std::string boundary = extractBoundary(req.getHeader("Content-Type"));
+    const std::string boundary = MultipartParser::extractBoundary(contentType);
     if (boundary.empty())
-        return {};
-
-    std::vector<FormField> formFields = parseFormData(req.body, boundary);
-    std::vector<FileField> files = searchForFiles(formFields);
-    std::vector<std::string> savedFiles;
-    savedFiles.reserve(files.size());
-    for (FileField file : files)
-        savedFiles.push_back(saveFile(file, uploadStore));
-
-    return savedFiles;
-}
-
-std::string UploadModule::extractBoundary(const std::string& contentTypeHeader)
-{
-    const std::string prefix = "multipart/form-data; boundary=";
-    if (contentTypeHeader.compare(0, prefix.length(), prefix) != 0)
-        return {};
-
-    return contentTypeHeader.substr(prefix.length());
-}
-
-std::vector<FormField> UploadModule::parseFormData(const std::string& body,
-                                                   const std::string& boundary)
-{
-    std::vector<FormField> formFields;
-
-    FormField field{};
-    size_t pos = 0;
-    while (extractFormField(body, boundary, pos, field))
-        formFields.push_back(field);
-
-    return formFields;
-}
-
-bool UploadModule::extractFormField(const std::string& body,
-                                    const std::string& boundary, size_t& pos,
-                                    FormField& outField)
-{
-    const std::string boundaryMarker = "--" + boundary;
-
-    size_t start = findNextBoundary(body, pos, boundaryMarker);
-    if (start == std::string::npos
-        || isClosingBoundary(body, start, boundaryMarker))
-        return false;
-
-    pos = skipBoundary(start, boundaryMarker);
-    std::string headers = extractHeaders(body, pos);
-
-    size_t bodyStart = pos;
-    size_t bodyEnd
-        = findNextBoundary(body, pos, boundaryMarker) - strlen("\r\n");
-    if (bodyEnd == std::string::npos)
-        return false;
-
-    outField = buildField(body, headers, bodyStart, bodyEnd);
+        return nullptr;
 
-    return true;
+    return std::make_unique<MultipartParser>(boundary, uploadStore);
 }
 
-size_t UploadModule::findNextBoundary(const std::string& body, size_t& pos,
-                                      const std::string& boundaryMarker)
+// The files are normally written while the body arrives; a body that
+// was received whole is run through the parser now
+void UploadModule::processMultipartFormData(RequestData& req,
+                                            const std::string& uploadStore,
+                                            RawResponse& resp)
 {
-    return body.find(boundaryMarker, pos);
-}
-
-bool UploadModule::isClosingBoundary(const std::string& body, size_t start,
-                                     const std::string& boundary)
-{
-    size_t pos = start + boundary.size();
-    return body.compare(pos, 2, "--") == 0;
-}
-
-size_t UploadModule::skipBoundary(size_t start, const std::string& boundary)
-{
-    size_t pos = start + boundary.size() + strlen("\r\n");
-    return pos;
-}
-
-std::string UploadModule::extractHeaders(const std::string& body, size_t& pos)
-{
-    size_t headersEnd = body.find("\r\n\r\n", pos);
-    std::string headers = body.substr(pos, headersEnd - pos);
-    pos = headersEnd + strlen("\r\n\r\n");
-    return headers;
-}
+    std::unique_ptr<MultipartParser> parser = req.body.takeMultipart();
+    if (!parser)
+    {
+        parser = createMultipartParser(req.getHeader("Content-Type"), uploadStore);
+        if (!parser)
+            return create201Response(resp, {});
+        feedBody(*parser, req.body);
+    }
 
-FormField UploadModule::buildField(const std::string& body,
-                                   const std::string& headers, size_t start,
-                                   size_t end)
-{
-    FormField f;
-    f.headers = headers;
-    f.body = body.substr(start, end - start);
-    return f;
-}
+    if (parser->hasFailed())
+        throw std::runtime_error("Failed to write the uploaded files");
+    if (!parser->isDone())
+        return create400Response(resp);
 
-std::vector<FileField> UploadModule::searchForFiles(
-    const std::vector<FormField>& formFields)
-{
-    std::vector<FileField> files;
-    std::string filename;
-    for (FormField field : formFields)
+    for (const std::string& filePath : parser->savedFiles())
     {
-        filename = extractFileName(field.headers);
-        if (!filename.empty())
-            files.push_back({filename, field.body});
+        OpenFileCache::local().invalidate(filePath);
+        ResponseCache::local().invalidate(filePath);
     }
-    return files;
+    create201Response(resp, parser->savedFiles());
 }
 
-std::string UploadModule::extractFileName(const std::string& headers)
+void UploadModule::feedBody(MultipartParser& parser, const RequestBody& body)
 {
-    const std::string& prefix = "filename=\"";
-    size_t prefixPos = headers.find(prefix);
-    if (prefixPos == std::string::npos)
-        return {};
-
-    size_t openBracePos = prefixPos + prefix.length();
-    size_t closeBracePos = headers.find('"', openBracePos);
-    size_t filenameSize = closeBracePos - openBracePos;
+    if (!body.isSpooled())
+        return parser.feed(body.memory());
 
-    return headers.substr(openBracePos, filenameSize);
+    char buf[64 * 1024];
+    size_t offset = 0;
+    while (size_t n = body.read(offset, buf, sizeof(buf)))
+    {
+        parser.feed(std::string_view(buf, n));
+        offset += n;
+    }
 }
 
-std::string UploadModule::saveFile(const FileField& file,
+// A body spooled to disk becomes the file without being copied
+std::string UploadModule::saveBody(RequestBody& body, const std::string& fileName,
                                    const std::string& uploadStore)
 {
-    std::string filePath = uploadStore + "/" + file.fileName;
-    std::ofstream os(filePath, std::ios::binary);
-    if (!os)
-        throw std::runtime_error("Failed to open file '" + file.fileName
-                                 + "' for writing");
-    os.write(file.contents.c_str(), file.contents.size());
-    if (!os)
-        throw std::runtime_error("Failed to write file '" + file.fileName + "'");
+    std::string filePath = uploadStore + "/" + fileName;
+    body.saveAs(filePath);
+    OpenFileCache::local().invalidate(filePath);
+    ResponseCache::local().invalidate(filePath);
 
     return filePath;
 }
@@ -218,7 +130,7 @@ std::string UploadModule::generateRandomName(size_t length)
 }
 
 void UploadModule::create201Response(RawResponse& resp,
-                                     std::vector<std::string> savedFiles)
+                                     const std::vector<std::string>& savedFiles)
 {
     std::stringstream bodyStream;
 
@@ -240,6 +152,11 @@ void UploadModule::create201Response(RawResponse& resp,
     resp.setBody(bodyStream.str());
 }
 
+void UploadModule::create400Response(RawResponse& resp)
+{
+    resp.setStatusCode(HttpStatusCode::BadRequest);
+}
+
 void UploadModule::create415Response(RawResponse& resp)
 {
     resp.setStatusCode(HttpStatusCode::UnsupportedMediaType);
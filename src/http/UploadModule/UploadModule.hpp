@@ -4,15 +4,20 @@
 # define UPLOADMODULE_HPP
 
 # include <istream>
+# include <memory>
 # include <vector>
 # include <cstring>
 # include <random>
 # include <sstream>
+# include <string_view>
 
 # include "RequestContext.hpp"
 # include "RequestData.hpp"
 # include "RawResponse.hpp"
 # include "MimeTypeRecognizer.hpp"
+# include "OpenFileCache.hpp"
+# include "ResponseCache.hpp"
+# include "MultipartParser.hpp"
 
 class UploadModule
 {
@@ -27,51 +32,27 @@ class UploadModule
 
     // Class specific features
   public:
-    // Structs, Classes
-    struct FormField
-    {
-        std::string headers;
-        std::string body;
-    };
-    struct FileField
-    {
-        std::string fileName;
-        std::string contents;
-    };
     // Methods
-    static void processUpload(const RequestData& req, const RequestContext& ctx,
+    static void processUpload(RequestData& req, const RequestContext& ctx,
                               RawResponse& resp);
+    static bool isMultipartFormData(std::string_view contentType);
+    static std::unique_ptr<MultipartParser> createMultipartParser(
+        std::string_view contentType, const std::string& uploadStore);
 
   private:
     // Methods
-    static bool isMultipartFormData(const RequestData& req);
-    static std::vector<std::string> processMultipartFormData(
-        const RequestData& req, const std::string& uploadStore);
-    static std::string extractBoundary(const std::string& contentTypeHeader);
-    static std::vector<FormField> parseFormData(const std::string& body,
-                                                const std::string& boundary);
-    static bool extractFormField(const std::string& body,
-                                 const std::string& boundary, size_t& pos,
-                                 FormField& outField);
-    static size_t findNextBoundary(const std::string& body, size_t& pos,
-                                   const std::string& boundary);
-    static bool isClosingBoundary(const std::string& body, size_t start,
-                                  const std::string& boundary);
-    static size_t skipBoundary(size_t start, const std::string& boundary);
-    static std::string extractHeaders(const std::string& body, size_t& pos);
-    static FormField buildField(const std::string& body,
-                                const std::string& headers, size_t start,
-                                size_t end);
-    static std::vector<FileField> searchForFiles(
-        const std::vector<FormField>& formFields);
-    static std::string extractFileName(const std::string& headers);
-    static std::string saveFile(const FileField& file,
+    static void processMultipartFormData(RequestData& req,
+                                         const std::string& uploadStore,
+                                         RawResponse& resp);
+    static void feedBody(MultipartParser& parser, const RequestBody& body);
+    static std::string saveBody(RequestBody& body, const std::string& fileName,
                                 const std::string& uploadStore);
     static std::string generateRandomName(size_t length = 32);
 
     ////
     static void create201Response(RawResponse& resp,
-                                  std::vector<std::string> savedFiles);
+                                  const std::vector<std::string>& savedFiles);
+    static void create400Response(RawResponse& resp);
     static void create415Response(RawResponse& resp);
 };
 
@@ -1,41 +1,33 @@
 #include "BodyParser.hpp"
 
 #include <algorithm>
-#include <sstream>
+#include <cctype>
+#include <cstdint>
 #include <stdexcept>
 
+#include "ByteScan.hpp"
+#include "UriUtils.hpp"
+
 namespace BodyParser
 {
 	// ------------------------
 	// Content-Length
 	// ------------------------
 	
-	void parseSizedBody(
-		const std::string& incomingData,
-		std::string& conLenBuffer,
-		std::string& tempBuffer,
-		size_t expectedLength,
-		bool& bodyDone
+	// Appends what is still missing of the body and returns how much of
+	// input that took, the rest belongs to the next request
+	size_t appendSizedBody(
+		std::string_view input,
+		RequestBody& body,
+		size_t expectedLength
 	)
 	{
-		if (bodyDone)
-		return;
-	
-		size_t remaining = remainingConLen(expectedLength, conLenBuffer.size()); // bytes still needed
-		DBG("[appendBodyBytes]: remaining bytes of content to append = " << remaining);
-		
-		size_t toAppend = std::min(remaining, incomingData.size());
-		DBG("[appendBodyBytes]: bytes to append in reality = " << toAppend);
-		
-		conLenBuffer.append(incomingData, 0, toAppend);
-		
-		tempBuffer.erase(0, toAppend);
-		
-		if (conLenBuffer.size() == expectedLength)
-		{
-			bodyDone = true;
-			DBG("[appendBodyBytes]: Content-Length body finished, body done set");
-		}
+		size_t remaining = remainingConLen(expectedLength, body.size()); // bytes still needed
+		size_t toAppend = std::min(remaining, input.size());
+		DBG("[appendSizedBody]: " << remaining << " bytes missing, " << toAppend << " available");
+
+		body.append(input.substr(0, toAppend));
+		return toAppend;
 	}
 
 	size_t remainingConLen(size_t expectedLength, size_t currentSize)
@@ -49,205 +41,125 @@ namespace BodyParser
 	// Chunked
 	// ------------------------
 
-	void parseChunkedBody(
-		std::string& chunkedBuffer,
-		std::string& tempBuffer,
-		std::string& body,
-		bool& terminatingZeroMet,
-		bool& bodyDone
-	)
-	{
-		// Append tempBuffer to chunkedBuffer
-		chunkedBuffer += tempBuffer;
-		DBG("[appendBodyBytes]: appended chunkedBuffer with data from tempBuffer, chunkedBuffer size = " 
-			<< chunkedBuffer.size());
-
-		tempBuffer.clear(); // consumed for decoding
-		DBG("[appendBodyBytes]: tempBuffer cleared for decoding");
-
-		size_t bytesProcessed = 0;
-
-		// decode as much as possible
-		std::string decoded = decodeChunkedBody(chunkedBuffer, terminatingZeroMet, bytesProcessed);
-		body += decoded; // append only the decoded chunks
-		DBG("[appendBodyBytes]: decoded chunked body appended, decoded size = " << decoded.size());
-
-		// remove processed bytes from chunkedBuffer
-		// setChunkedBuffer(chunkedBuffer.substr(bytesProcessed));
-		chunkedBuffer = chunkedBuffer.substr(bytesProcessed);
-		DBG("[appendBodyBytes]: chunkedBuffer resized after processing, new size = " << chunkedBuffer.size());
-
-		if (terminatingZeroMet)
-		{
-			bodyDone = true;
-			tempBuffer = chunkedBuffer;
-			chunkedBuffer.clear();
-			DBG("[appendBodyBytes]: Terminating zero chunk found, bodyDone set, tempBuffer updated, chunkedBuffer cleared");
-		}
-		else
-		{
-			// partial chunk left? move leftovers to tempBuffer for next process
-			tempBuffer = chunkedBuffer + tempBuffer;
-			chunkedBuffer.clear();
-			DBG("[appendBodyBytes]: Terminating zero not found, leftovers moved to tempBuffer");
-		}
-	}
-
-	std::string decodeChunkedBody(
-		std::string& chunkedBuffer,
-		bool& terminatingZeroMet,
-		size_t& bytesProcessed
+	// Decodes what it can of input into body and returns the bytes it
+	// consumed: all of them, unless the body ended. Every byte is looked
+	// at once, the state carries partial sizes and lines over to the
+	// next call. maxBodySize 0 means no limit.
+	size_t decodeChunked(
+		std::string_view input,
+		ChunkedState& state,
+		RequestBody& body,
+		size_t maxBodySize
 	)
 	{
-		DBG("[decodeChunkedBody]: START: chunkedBuffer = |" << chunkedBuffer 
-			<< "|, chunkedBuffer size = " << chunkedBuffer.size());
-
-		std::string decoded;
 		size_t pos = 0;
-		bytesProcessed = 0;
 
-		while (pos < chunkedBuffer.size())
+		while (pos < input.size() && state.stage != ChunkStage::DONE)
 		{
-			std::string chunkData;
-			if (!readChunk(chunkedBuffer, pos, chunkData, terminatingZeroMet))
-				break; // incomplete data
-
-			decoded += chunkData;
+			char c = input[pos];
+
+			switch (state.stage)
+			{
+				case ChunkStage::SIZE:
+					if (std::isxdigit(static_cast<unsigned char>(c)))
+					{
+						if (state.remaining > (SIZE_MAX >> 4))
+							throw std::runtime_error("Chunk size too large");
+						state.remaining = state.remaining * 16 + UriUtils::hexValue(c);
+						state.hasDigits = true;
+					}
+					else if (!state.hasDigits)
+						throw std::runtime_error("Malformed chunk size in request");
+					else if (c == ';' || c == ' ' || c == '\t')
+						state.stage = ChunkStage::EXTENSION;
+					else if (c == '\r')
+						state.stage = ChunkStage::SIZE_LF;
+					else
+						throw std::runtime_error("Malformed chunk size in request");
+					++pos;
+					break;
+
+				case ChunkStage::EXTENSION:
+				case ChunkStage::TRAILER:
+				{
+					size_t cr = ByteScan::find(input, '\r', pos);
+					if (cr == ByteScan::npos)
+						return input.size();
+					state.stage = (state.stage == ChunkStage::EXTENSION)
+						? ChunkStage::SIZE_LF : ChunkStage::TRAILER_LF;
+					pos = cr + 1;
+					break;
+				}
+
+				case ChunkStage::SIZE_LF:
+					if (c != '\n')
+						throw std::runtime_error("Missing LF after chunk size");
+					++pos;
+					if (state.remaining == 0)
+					{
+						state.stage = ChunkStage::TRAILER_START;
+						break;
+					}
+					// Known before the data arrives, no need to wait for it
+					if (maxBodySize != 0 && (state.remaining > maxBodySize
+						|| body.size() > maxBodySize - state.remaining))
+						throw BodyTooLargeException();
+					body.reserve(body.size() + state.remaining);
+					state.stage = ChunkStage::DATA;
+					break;
+
+				case ChunkStage::DATA:
+				{
+					size_t n = std::min(state.remaining, input.size() - pos);
+					body.append(input.substr(pos, n));
+					pos += n;
+					state.remaining -= n;
+					if (state.remaining == 0)
+						state.stage = ChunkStage::DATA_CR;
+					break;
+				}
+
+				case ChunkStage::DATA_CR:
+					if (c != '\r')
+						throw std::runtime_error("Missing CRLF after chunk data");
+					state.stage = ChunkStage::DATA_LF;
+					++pos;
+					break;
+
+				case ChunkStage::DATA_LF:
+					if (c != '\n')
+						throw std::runtime_error("Missing CRLF after chunk data");
+					state.stage = ChunkStage::SIZE;
+					state.hasDigits = false;
+					++pos;
+					break;
+
+				case ChunkStage::TRAILER_START:
+					state.stage = (c == '\r') ? ChunkStage::LAST_LF : ChunkStage::TRAILER;
+					if (c == '\r')
+						++pos;
+					break;
+
+				case ChunkStage::TRAILER_LF:
+					if (c != '\n')
+						throw std::runtime_error("Missing LF after trailer field");
+					state.stage = ChunkStage::TRAILER_START;
+					++pos;
+					break;
+
+				case ChunkStage::LAST_LF:
+					if (c != '\n')
+						throw std::runtime_error("Missing LF after last chunk");
+					state.stage = ChunkStage::DONE;
+					++pos;
+					break;
+
+				case ChunkStage::DONE:
+					break;
+			}
 		}
 
-		bytesProcessed = pos;
-		DBG("[decodeChunkedBody]: END: decoded.size = " << decoded.size() 
-			<< ", bytesProcessed = " << bytesProcessed);
-
-		return decoded;
-	}
-	
-	// Reads the header and size, Checks if data is complete
-	// Outputs the chunk (or signals zero-terminator), Updates pos
-	bool readChunk(
-		const std::string& chunkedBuffer,
-		size_t& pos,
-		std::string& chunkData,
-		bool& terminatingZeroMet
-	)
-	{
-		// Find end of the current chunk header line
-		size_t chunkLineEnd = chunkedBuffer.find("\r\n", pos);
-		if (chunkLineEnd == std::string::npos)
-		{
-			DBG("[readChunk]: Incomplete chunkHeaderLine, waiting for more data");
-			return false; // wait for more data
-		}
-
-		std::string chunkHeaderLine = chunkedBuffer.substr(pos, chunkLineEnd - pos);
-		DBG("[readChunk]: chunkHeaderLine is |" << chunkHeaderLine << "|");
-		
-		// Extract chunk size (ignore extensions)
-		size_t chunkSize = parseChunkSize(chunkHeaderLine);
-
-		DBG("[readChunk]: Found the chunkHeaderLine |" << chunkHeaderLine 
-			<< "|, chunkSize = " << chunkSize << " bytes");
-
-		size_t chunkDataStart = chunkLineEnd + 2; // skip \r\n
-		DBG("[readChunk]: chunkDataStart = " << chunkDataStart);
-
-		size_t chunkDataEnd = chunkDataStart + chunkSize;
-		DBG("[readChunk]: chunkDataEnd = " << chunkDataEnd);
-
-		if (chunkDataEnd > chunkedBuffer.size())
-		{
-			DBG("[readChunk]: Incomplete chunkData, waiting for more data");
-			return false; // wait for more data
-		}
-		
-		//chunk actually contains data
-		if (chunkSize > 0)
-		{
-			chunkData = chunkedBuffer.substr(chunkDataStart, chunkSize);
-			DBG("[readChunk]: Appended chunkData |" << chunkData 
-				<< "|, chunkData size = " << chunkData.size());
-			
-			pos = chunkDataEnd + 2; // skip chunkData + trailing \r\n
-			DBG("[readChunk]: skipped chunkData + chunkTrailer, pos = " << pos);
-			return true;
-		}
-		else
-		{
-			return handleTerminatingZeroChunk(chunkedBuffer, chunkDataStart, pos, terminatingZeroMet);
-		}
-	}
-	
-	size_t parseChunkSize(const std::string& chunkHeaderLine)
-	{
-		// Extract chunk size (ignore extensions)
-		size_t semicolonPos = chunkHeaderLine.find(';');
-		std::string chunkSizeStr =
-			(semicolonPos == std::string::npos)
-			? chunkHeaderLine            // the whole string
-			: chunkHeaderLine.substr(0, semicolonPos); // substring before ';'
-		
-		//treat any non-hex characters before CRLF as malformed
-		for (char c : chunkSizeStr)
-		{
-			if (!isxdigit(c)) // if not a hex digit
-				throw std::runtime_error("Malformed chunk size in request");
-		}
-			
-		size_t chunkSize = 0;
-		try
-		{
-			chunkSize = std::stoul(chunkSizeStr, nullptr, 16); // hex string → number
-		}
-		catch (...)
-		{
-			DBG("[parseChunkSize]: Invalid chunk size |" << chunkSizeStr << "|, throwing exception");
-			throw std::runtime_error("Invalid chunk size in chunked body");
-		}
-
-		return chunkSize;
-	}
-	
-	// Returns true if the terminating zero chunk was fully consumed
-	bool handleTerminatingZeroChunk(
-		const std::string& chunkedBuffer,
-		size_t chunkDataStart,
-		size_t& pos,
-		bool& terminatingZeroMet
-	)
-	{
-		DBG("[handleTerminatingZeroChunk]: reached terminating zero chunk!!");
-
-		// chunkDataStart points right after the chunk header line (0\r\n)
-		size_t zeroChunkEnd = chunkDataStart + 2; //final CRLF
-		DBG("[handleTerminatingZeroChunk]: zeroChunkEnd = " << zeroChunkEnd);
-
-		if (chunkedBuffer.size() >= zeroChunkEnd &&
-			chunkedBuffer[chunkDataStart] == '\r' &&
-			chunkedBuffer[chunkDataStart + 1] == '\n')
-		{
-			pos = zeroChunkEnd;
-			terminatingZeroMet = true;
-			DBG("[handleTerminatingZeroChunk]: Zero-size chunk fully consumed, pos = " << pos);
-			return true;
-		}
-		else
-		{
-			DBG("[handleTerminatingZeroChunk]: waiting for final CRLF after zero chunk");
-			return false; // wait for more data
-		}
-	}
-	
-	// ------------------------
-	// Buffer utilities
-	// ------------------------
-
-	void appendTempBuffer(std::string& tempBuffer, const std::string& data)
-	{
-		tempBuffer += data;
-	}
-
-	void appendToChunkedBuffer(std::string& chunkedBuffer, const std::string& data)
-	{
-		chunkedBuffer += data;
+		DBG("[decodeChunked]: consumed " << pos << " bytes, body size = " << body.size());
+		return pos;
 	}
-}
\ No newline at end of file
+}
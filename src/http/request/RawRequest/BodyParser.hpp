@@ -1,7 +1,11 @@
 #ifndef BODYPARSER_HPP
 #define BODYPARSER_HPP
 
+#include <stdexcept>
 #include <string>
+#include <string_view>
+
+#include "RequestBody.hpp"
 #include "debug.hpp"
 
 namespace BodyParser
@@ -12,53 +16,55 @@ namespace BodyParser
 
 	size_t remainingConLen(size_t expectedLength, size_t currentSize);
 
-	void parseSizedBody(
-		const std::string& incomingData,
-		std::string& conLenBuffer,
-		std::string& tempBuffer,
-		size_t expectedLength,
-		bool& bodyDone
+	size_t appendSizedBody(
+		std::string_view input,
+		RequestBody& body,
+		size_t expectedLength
 	);
 
 	// ------------------------
-	// Chunked helpers
+	// Chunked
 	// ------------------------
 
-	void parseChunkedBody(
-		std::string& chunkedBuffer,
-		std::string& tempBuffer,
-		std::string& body,
-		bool& terminatingZeroMet,
-		bool& bodyDone
-	);
-	
-	std::string decodeChunkedBody(
-		std::string& chunkedBuffer,
-		bool& terminatingZeroMet,
-		size_t& bytesProcessed
-	);
-	
-	bool readChunk(
-		const std::string& chunkedBuffer,
-		size_t& pos,
-		std::string& chunkData,
-		bool& terminatingZeroMet
-	);
-	
-	size_t parseChunkSize(const std::string& chunkHeaderLine);
-	
-	bool handleTerminatingZeroChunk(
-		const std::string& chunkedBuffer,
-		size_t chunkDataStart,
-		size_t& pos,
-		bool& terminatingZeroMet
-	);
+	// Where the decoder stopped, so the next read resumes right there
+	enum class ChunkStage
+	{
+		SIZE,          // hex digits of the chunk size
+		EXTENSION,     // ";name=value" after the size, skipped
+		SIZE_LF,
+		DATA,
+		DATA_CR,       // CRLF closing the chunk data
+		DATA_LF,
+		TRAILER_START, // after the last chunk: a trailer field or the end
+		TRAILER,       // trailer field, skipped
+		TRAILER_LF,
+		LAST_LF,
+		DONE
+	};
 
-	// ------------------------
-	// Buffer utilities
-	// ------------------------
-	void appendTempBuffer(std::string& tempBuffer, const std::string& data);
-	void appendToChunkedBuffer(std::string& chunkedBuffer, const std::string& data);
+	struct ChunkedState
+	{
+		ChunkStage stage = ChunkStage::SIZE;
+		size_t remaining = 0; // of the current chunk size or data
+		bool hasDigits = false;
+	};
+
+	// Thrown once a body grows past client_max_body_size
+	class BodyTooLargeException : public std::runtime_error
+	{
+	  public:
+		BodyTooLargeException()
+		  : std::runtime_error("Request body exceeds client_max_body_size")
+		{
+		}
+	};
+
+	size_t decodeChunked(
+		std::string_view input,
+		ChunkedState& state,
+		RequestBody& body,
+		size_t maxBodySize
+	);
 }
 
 #endif
@@ -3,9 +3,9 @@
 // -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
 
 RawRequest::RawRequest()
-	: m_tempBuffer(), m_body(), m_chunkedBuffer(), m_conLenBuffer(), m_method(), m_uri(), m_host(), m_httpVersion(),
-	m_headers(), m_bodyType(BodyType::NO_BODY), m_headersDone(false), m_terminatingZeroMet(false), m_bodyDone(false),
-	m_requestDone(false), m_isBadRequest(false), m_shouldClose(false) {}
+	: m_tempBuffer(), m_body(), m_method(), m_uri(), m_host(), m_httpVersion(),
+	m_head(), m_headers(), m_addedHeaders(), m_bodyType(BodyType::NO_BODY), m_chunked(), m_contentLength(0), m_maxBodySize(0), m_headerScanPos(0), m_headersDone(false), m_bodyDone(false),
+	m_requestDone(false), m_isBadRequest(false), m_isBodyTooLarge(false), m_isServerError(false), m_expectsContinue(false), m_shouldClose(false) {}
 
 // ---------------------------ACCESSORS-----------------------------
 
@@ -29,6 +29,21 @@ bool RawRequest::isBadRequest() const
 	return m_isBadRequest;
 }
 
+bool RawRequest::isBodyTooLarge() const
+{
+	return m_isBodyTooLarge;
+}
+
+bool RawRequest::isServerError() const
+{
+	return m_isServerError;
+}
+
+bool RawRequest::expectsContinue() const
+{
+	return m_expectsContinue;
+}
+
 bool RawRequest::shouldClose() const
 { 
 	return m_shouldClose;
@@ -54,15 +69,14 @@ const std::string& RawRequest::httpVersion() const
 	return m_httpVersion;
 }
 
-const std::unordered_map<std::string, std::string>& RawRequest::headers() const
+const HeaderViewMap& RawRequest::headers() const
 {
 	return m_headers;
 }
 
-const std::string RawRequest::header(const std::string& name) const
+std::string_view RawRequest::header(std::string_view name) const
 {
-	auto it = m_headers.find(name);
-	return (it != m_headers.end()) ? it->second : "";
+	return m_headers.get(name);
 }
 
 const std::string& RawRequest::host() const
@@ -83,7 +97,7 @@ size_t RawRequest::contentLength() const
 
 	try
 	{
-		long value = std::stol(clIt->second);
+		long value = std::stol(std::string(clIt->second));
 		if (value < 0)
 			throw std::invalid_argument("Negative Content-Length not allowed");
 
@@ -91,7 +105,7 @@ size_t RawRequest::contentLength() const
 	}
 	catch (const std::exception& e)
 	{
-		throw std::invalid_argument("Invalid Content-Length header: " + clIt->second);
+		throw std::invalid_argument("Invalid Content-Length header: " + std::string(clIt->second));
 	}
 }
 
@@ -100,7 +114,7 @@ const std::string& RawRequest::tempBuffer() const
 	return m_tempBuffer;
 }
 
-const std::string& RawRequest::body() const
+const RequestBody& RawRequest::body() const
 {
 	return m_body;
 }
@@ -120,7 +134,14 @@ void RawRequest::setHeadersDone()
 	m_headersDone = true;
 }
 
+// The request keeps its own copy, m_headers only holds views
 void RawRequest::addHeader(const std::string& name, const std::string& value)
+{
+	std::string_view storedName = m_addedHeaders.emplace_back(name);
+	storeHeader(storedName, m_addedHeaders.emplace_back(value));
+}
+
+void RawRequest::storeHeader(std::string_view name, std::string_view value)
 {
 	auto it = m_headers.find(name);
 	if (it != m_headers.end())
@@ -130,8 +151,8 @@ void RawRequest::addHeader(const std::string& name, const std::string& value)
 		{
 			// Conflict: same header with different values
 			m_bodyType = BodyType::ERROR;
-			throw std::runtime_error("Header conflict: " + name +
-									 " has values [" + it->second + "] and [" + value + "]");
+			throw std::runtime_error("Header conflict: " + std::string(name) +
+									 " has values [" + std::string(it->second) + "] and [" + std::string(value) + "]");
 		}
 		else
 		{
@@ -148,19 +169,55 @@ void RawRequest::setShouldClose(bool value)
 	m_shouldClose = value;
 }
 
-void RawRequest::setTempBuffer(const std::string& buffer)
+// A body announced larger than the limit is refused before any of it
+// is read
+void RawRequest::setMaxBodySize(size_t size)
+{
+	m_maxBodySize = size;
+	if (size != 0 && m_bodyType == BodyType::SIZED && m_contentLength > size)
+		markBodyTooLarge();
+}
+
+// Bodies past client_body_buffer_size are spooled to disk
+void RawRequest::setBodySettings(const BodySettings& settings)
 {
-	m_tempBuffer = buffer;
+	m_body.setSpooling(settings.bufferSize, settings.tempPath);
+	setMaxBodySize(settings.maxSize);
+}
+
+// A multipart upload is parsed as it arrives instead of being kept
+void RawRequest::streamBodyTo(std::unique_ptr<MultipartParser> parser)
+{
+	m_body.streamTo(std::move(parser));
+}
+
+void RawRequest::setTempBuffer(std::string buffer)
+{
+	m_tempBuffer = std::move(buffer);
+	m_headerScanPos = 0;
+}
+
+// Hands the bytes after a complete request over to the next one
+std::string RawRequest::takeTempBuffer()
+{
+	std::string buffer = std::move(m_tempBuffer);
+	m_tempBuffer.clear();
+	return buffer;
 }
 
 void RawRequest::setBody(const std::string& data)
 {
-	m_body = data;
+	m_body.clear();
+	m_body.append(data);
 }
 
-void RawRequest::appendTempBuffer(const std::string& data)
+// Once the headers are done, body bytes go straight into the body
+// instead of being buffered first
+void RawRequest::appendTempBuffer(std::string_view data)
 {
-	m_tempBuffer += data;
+	if (m_headersDone && !m_bodyDone && m_tempBuffer.empty())
+		data.remove_prefix(appendBodyBytes(data));
+	m_tempBuffer.append(data);
 }
 
 void RawRequest::setRequestDone()
@@ -176,8 +233,40 @@ void RawRequest::markBadRequest()
 	m_requestDone = true;
 }
 
+// The rest of the body is never read, so the connection can't be reused
+void RawRequest::markBodyTooLarge()
+{
+	m_isBodyTooLarge = true;
+	m_shouldClose = true;
+	m_tempBuffer.clear();
+	m_headersDone = true;
+	m_bodyDone = true;
+	m_requestDone = true;
+}
+
+// The body couldn't be stored (client_body_temp_path missing, disk
+// full): the rest of it is never read either
+void RawRequest::markServerError()
+{
+	m_isServerError = true;
+	m_shouldClose = true;
+	m_tempBuffer.clear();
+	m_headersDone = true;
+	m_bodyDone = true;
+	m_requestDone = true;
+}
+
 // ---------------------------METHODS-----------------------------
 
+// Returns true once the headers are done, the body limit can then be
+// set before the body is parsed
+bool RawRequest::parseHeaderPart()
+{
+	if (!isHeadersDone())
+		handleHeaderPart();
+	return isHeadersDone();
+}
+
 bool RawRequest::parse()
 {
 	// Parse headers if not done
@@ -202,7 +291,7 @@ bool RawRequest::parse()
 	// Parse body if needed
 	if (!isBadRequest() && isHeadersDone() && !isBodyDone())
 	{
-		appendBodyBytes(tempBuffer());
+		m_tempBuffer.erase(0, appendBodyBytes(m_tempBuffer));
 
 		if (!isBodyDone())
 		{
@@ -222,7 +311,8 @@ bool RawRequest::parse()
 	return false;
 }
 
-RequestData RawRequest::buildRequestData() const
+// The body is moved out, it's only needed once
+RequestData RawRequest::takeRequestData()
 {
 	RequestData data;
 
@@ -230,8 +320,8 @@ RequestData RawRequest::buildRequestData() const
 	data.uri = m_uri;
 	data.query = m_query;
 	data.httpVersion = m_httpVersion;
-	data.headers = m_headers;
-	data.body = m_body;
+	data.headers = HeaderMap(m_headers);
+	data.body = std::move(m_body);
 	return data;
 }
 
@@ -239,17 +329,24 @@ void RawRequest::handleHeaderPart()
 {
 	DBG("handleHeaderPart");
 
-	std::string headerPart;
-	
-	if (!extractHeaderPart(headerPart))
+	size_t headerEnd;
+	if (!findHeaderEnd(headerEnd))
 	{
 		DBG("Headers incomplete");
 		return;
 	}
 	
-	DBG("Header part extracted, length = " << headerPart.size());
+	DBG("Header part found, length = " << headerEnd);
 
-	parseRequestLineAndHeaders(headerPart);
+	// Header names and values stay views into this copy of the block
+	// until takeRequestData, so storing them doesn't allocate
+	m_head = std::make_unique<char[]>(headerEnd);
+	std::copy_n(m_tempBuffer.data(), headerEnd, m_head.get());
+	parseRequestLineAndHeaders(std::string_view(m_head.get(), headerEnd));
+
+	// Keep leftover (after headers) in tempBuffer
+	m_tempBuffer.erase(0, headerEnd);
+	DBG("Temp buffer length after header removal = " << m_tempBuffer.size());
 
 	if (m_bodyType == BodyType::NO_BODY)
 	{
@@ -261,36 +358,65 @@ void RawRequest::handleHeaderPart()
 	finalizeHeaderPart();
 }
 
-bool RawRequest::extractHeaderPart(std::string& headerPart)
+// The search resumes where the previous segment left off, only the
+// last 3 bytes are looked at again: the terminator may straddle them
+bool RawRequest::findHeaderEnd(size_t& headerEnd)
 {
-	size_t headerEnd = m_tempBuffer.find("\r\n\r\n");
-	if (headerEnd == std::string::npos)
+	size_t from = m_headerScanPos > 3 ? m_headerScanPos - 3 : 0;
+	size_t pos = ByteScan::findHeaderEnd(m_tempBuffer, from);
+	if (pos == std::string::npos)
+	{
+		m_headerScanPos = m_tempBuffer.size();
 		return false;
+	}
 
-	headerPart = m_tempBuffer.substr(0, headerEnd + 4);
-	
-	// Keep leftover (after headers) in tempBuffer
-	m_tempBuffer = m_tempBuffer.substr(headerEnd + 4);
-	DBG("Temp buffer length after header removal = " << _tempBuffer.size());
-
+	headerEnd = pos + 4;
 	return true;
 }
 
-void RawRequest::parseRequestLineAndHeaders(const std::string& headerPart)
+// Splits off the next line, without its line ending
+std::string_view RawRequest::takeLine(std::string_view& rest)
+{
+	size_t end = ByteScan::find(rest, '\n');
+	std::string_view line = rest.substr(0, end);
+	rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+
+	if (!line.empty() && line.back() == '\r')
+		line.remove_suffix(1);
+	return line;
+}
+
+// Splits off the next whitespace separated word
+std::string_view RawRequest::takeWord(std::string_view& rest)
+{
+	size_t start = rest.find_first_not_of(" \t");
+	if (start == std::string_view::npos)
+	{
+		rest = {};
+		return {};
+	}
+	rest.remove_prefix(start);
+
+	size_t end = std::min(rest.find_first_of(" \t"), rest.size());
+	std::string_view word = rest.substr(0, end);
+	rest.remove_prefix(end);
+	return word;
+}
+
+// The header block is parsed in place, only the method, uri and version
+// are copied out of it
+void RawRequest::parseRequestLineAndHeaders(std::string_view headerPart)
 {
 	try
 	{
-		std::istringstream stream(headerPart);
-		std::string line;
-		if (!std::getline(stream, line))
+		std::string_view line = takeLine(headerPart);
+		if (line.empty())
 			throw std::runtime_error("Malformed request: missing request line");
 
-		StrUtils::removeCarriageReturns(line);
-
 		DBG("[parseRequestLineAndHeaders] Request line: " << line);
 
 		parseRequestLine(line);
-		parseHeaders(stream);
+		parseHeaders(headerPart);
 	}
 	catch(const std::exception& e)
 	{
@@ -299,12 +425,14 @@ void RawRequest::parseRequestLineAndHeaders(const std::string& headerPart)
 	}
 }
 
-void RawRequest::parseRequestLine(const std::string& firstLine)
+void RawRequest::parseRequestLine(std::string_view firstLine)
 {
-	std::istringstream reqLine(firstLine);
-	std::string methodStr;
-	
-	reqLine >> methodStr >> m_rawUri >> m_httpVersion;
+	if (ByteScan::findControl(firstLine) != ByteScan::npos)
+		throw std::invalid_argument("Control character in request line");
+
+	const std::string methodStr(takeWord(firstLine));
+	m_rawUri = takeWord(firstLine);
+	m_httpVersion = takeWord(firstLine);
 
 	if (methodStr.empty() || m_rawUri.empty() || m_httpVersion.empty())
 		throw std::runtime_error("Invalid request line");
@@ -329,8 +457,8 @@ void RawRequest::splitUriAndQuery()
 	size_t qpos = m_rawUri.find('?');
 	if (qpos != std::string::npos)
 	{
-		m_uri = m_rawUri.substr(0, qpos);
-		m_query = m_rawUri.substr(qpos + 1);
+		m_uri.assign(m_rawUri, 0, qpos);
+		m_query.assign(m_rawUri, qpos + 1);
 	}
 	else
 	{
@@ -341,41 +469,37 @@ void RawRequest::splitUriAndQuery()
 	DBG("[splitUriAndQuery]: _uri = " << _uri << ", _query = " << _query);
 }
 
-void RawRequest::parseHeaders(std::istringstream& stream)
+void RawRequest::parseHeaders(std::string_view lines)
 {
-	std::string line;
-	while (std::getline(stream, line) && !line.empty() && line != "\r")
-	{
-		StrUtils::removeCarriageReturns(line);
+	std::string_view line;
+	while (!(line = takeLine(lines)).empty())
 		parseAndStoreHeaderLine(line);
-	}
 
 	// Decide body type and connection behavior
 	finalizeHeaders();
 }
 
-void RawRequest::parseAndStoreHeaderLine(const std::string& line)
+void RawRequest::parseAndStoreHeaderLine(std::string_view line)
 {
-	auto colonPos = line.find(':');
-	if (colonPos == std::string::npos)
-		throw std::invalid_argument("Malformed header line: " + line);
+	auto colonPos = ByteScan::find(line, ':');
+	if (colonPos == ByteScan::npos)
+		throw std::invalid_argument("Malformed header line: " + std::string(line));
+	if (ByteScan::findControl(line, colonPos) != ByteScan::npos)
+		throw std::invalid_argument("Control character in header line");
 
-	std::string key = line.substr(0, colonPos);
-	std::string value = line.substr(colonPos + 1);
-	StrUtils::trimLeadingWhitespace(value);
+	std::string_view key = line.substr(0, colonPos);
+	std::string_view value = line.substr(colonPos + 1);
+	value.remove_prefix(std::min(value.find_first_not_of(" \t"), value.size()));
 	try
 	{
-		addHeader(key, value);
+		storeHeader(key, value);
 	}
 	catch(const std::exception& e)
 	{
 		throw std::invalid_argument("Header parse error: " + std::string(e.what()));
 	}
 	if (StrUtils::equalsIgnoreCase(key, "Host"))
-	{
-		size_t portPos = value.find(':');
-		m_host = (portPos != std::string::npos) ? value.substr(0, portPos) : value;
-	}
+		m_host = value.substr(0, value.find(':'));
 }
 
 void RawRequest::finalizeHeaders()
@@ -383,7 +507,14 @@ void RawRequest::finalizeHeaders()
 	if (StrUtils::equalsIgnoreCase(header("Transfer-Encoding"), "chunked"))
 		m_bodyType = BodyType::CHUNKED;
 	else if (!header("Content-Length").empty())
+	{
 		m_bodyType = BodyType::SIZED;
+		m_contentLength = contentLength();
+	}
+
+	// HTTP/1.0 clients don't know about interim responses
+	m_expectsContinue = m_bodyType != BodyType::NO_BODY && m_httpVersion == "HTTP/1.1"
+		&& StrUtils::equalsIgnoreCase(header("Expect"), "100-continue");
 
 	if (StrUtils::equalsIgnoreCase(header("Connection"), "close"))
 		m_shouldClose = true;
@@ -403,7 +534,8 @@ void RawRequest::finalizeHeaderPart()
 	}
 }
 
-void RawRequest::appendBodyBytes(const std::string& data)
+// Returns how much of data belongs to the body
+size_t RawRequest::appendBodyBytes(std::string_view data)
 {
 	try
 	{
@@ -411,55 +543,49 @@ void RawRequest::appendBodyBytes(const std::string& data)
 		{
 			case BodyType::SIZED:
 			{
-				BodyParser::parseSizedBody(
-					data,
-					m_conLenBuffer,
-					m_tempBuffer,
-					contentLength(),
-					m_bodyDone
-				);
-
-				if (m_bodyDone)
+				size_t expected = m_contentLength;
+				if (m_body.empty())
 				{
-					appendToBody(m_conLenBuffer); // only append when done
-					DBG("[appendBodyBytes]: Content-Length body finished, body appended, bodyDone set");
+					size_t limit = m_maxBodySize ? m_maxBodySize : expected;
+					m_body.reserve(std::min(expected, limit));
 				}
-				break;
+
+				size_t consumed = BodyParser::appendSizedBody(data, m_body, expected);
+				m_bodyDone = (m_body.size() == expected);
+				DBG("[appendBodyBytes]: Content-Length body, bodyDone = " << m_bodyDone);
+				return consumed;
 			}
 
 			case BodyType::CHUNKED:
 			{
-				BodyParser::parseChunkedBody(
-					m_chunkedBuffer,
-					m_tempBuffer,
-					m_body,
-					m_terminatingZeroMet,
-					m_bodyDone
-				);
-				break;
+				size_t consumed = BodyParser::decodeChunked(
+					data, m_chunked, m_body, m_maxBodySize);
+				m_bodyDone = (m_chunked.stage == BodyParser::ChunkStage::DONE);
+				return consumed;
 			}
 
 			case BodyType::NO_BODY:
 				DBG("[appendBodyBytes]: No body type, nothing to append");
-				break;
+				return 0;
 
 			case BodyType::ERROR:
 				throw std::runtime_error("Cannot append body data: request in ERROR state");
 		}
 	}
+	catch (const BodyParser::BodyTooLargeException& e)
+	{
+		DBG("[appendBodyBytes] " << e.what());
+		markBodyTooLarge();
+	}
+	catch (const std::system_error& e)
+	{
+		DBG("[appendBodyBytes] Server error: " << e.what());
+		markServerError();
+	}
 	catch(const std::exception& e)
 	{
 		DBG("[appendBodyBytes] Bad request: " << e.what());
 		markBadRequest(); // sets _requestDone and prepares 400 response
 	}
+	return data.size();
 }
-
-void RawRequest::appendToBody(const std::string& data)
-{
-	DBG("[appendToBody]: Appending " << data.size() << " bytes to _body");
-
-	m_body += data;
-
-	DBG("[appendToBody]: _body now = |" << _body << "|");
-}
-
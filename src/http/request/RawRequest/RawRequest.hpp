@@ -1,14 +1,24 @@
 #ifndef RAWREQUEST_HPP
 #define RAWREQUEST_HPP
 
+#include <algorithm>
+#include <deque>
 #include <string>
+#include <system_error>
 #include <iostream>
+#include <memory>
+#include <string_view>
 
 #include "StrUtils.hpp"
 #include "HttpMethod.hpp"
 #include "RequestData.hpp"
+#include "HeaderMap.hpp"
 #include "UriUtils.hpp"
+#include "ByteScan.hpp"
 #include "BodyParser.hpp"
+#include "RequestBody.hpp"
+#include "BodySettings.hpp"
+#include "MultipartParser.hpp"
 #include "debug.hpp"
 
 enum BodyType
@@ -24,23 +34,29 @@ class RawRequest
   private:
     // Properties
     std::string m_tempBuffer;
-    std::string m_body;
-    std::string m_chunkedBuffer;
-    std::string m_conLenBuffer;
+    RequestBody m_body;
     HttpMethod m_method;
     std::string m_rawUri;
     std::string m_uri;
     std::string m_host;
     std::string m_query;
     std::string m_httpVersion;
-    std::unordered_map<std::string, std::string> m_headers;
+    std::unique_ptr<char[]> m_head; // the received header block
+    HeaderViewMap m_headers; // views into m_head or m_addedHeaders
+    std::deque<std::string> m_addedHeaders; // names and values given to addHeader
     BodyType m_bodyType;
+    BodyParser::ChunkedState m_chunked;
+    size_t m_contentLength;
+    size_t m_maxBodySize; // 0: no limit
+    size_t m_headerScanPos; // the header terminator isn't before this
 
     bool m_headersDone;
-    bool m_terminatingZeroMet;
     bool m_bodyDone;
     bool m_requestDone;
     bool m_isBadRequest;
+    bool m_isBodyTooLarge;
+    bool m_isServerError;
+    bool m_expectsContinue;
     bool m_shouldClose;
 
     // Accessors
@@ -48,17 +64,18 @@ class RawRequest
 
     // Methods
     void handleHeaderPart();
-    bool extractHeaderPart(std::string& headerPart);
-    void parseRequestLineAndHeaders(const std::string& headerPart);
-    void parseRequestLine(const std::string& firstLine);
+    bool findHeaderEnd(size_t& headerEnd);
+    static std::string_view takeLine(std::string_view& rest);
+    static std::string_view takeWord(std::string_view& rest);
+    void parseRequestLineAndHeaders(std::string_view headerPart);
+    void parseRequestLine(std::string_view firstLine);
     void splitUriAndQuery();
-    void parseHeaders(std::istringstream& stream);
-    void parseAndStoreHeaderLine(const std::string& line);
+    void parseHeaders(std::string_view lines);
+    void parseAndStoreHeaderLine(std::string_view line);
+    void storeHeader(std::string_view name, std::string_view value);
     void finalizeHeaders();
     void finalizeHeaderPart();
-    void appendBodyBytes(const std::string& data);
-
-    void appendToBody(const std::string& data);
+    size_t appendBodyBytes(std::string_view data);
 
   public:
     // Construction and destruction
@@ -74,31 +91,41 @@ class RawRequest
     bool isBodyDone() const;
     bool isRequestDone() const;
     bool isBadRequest() const;
+    bool isBodyTooLarge() const;
+    bool isServerError() const;
+    bool expectsContinue() const;
     bool shouldClose() const;
     HttpMethod method() const;
     const std::string& uri() const;
     const std::string& query() const;
     const std::string& httpVersion() const;
-    const std::unordered_map<std::string, std::string>& headers() const;
-    const std::string header(const std::string& name) const; // may return ""
+    const HeaderViewMap& headers() const;
+    std::string_view header(std::string_view name) const; // may return ""
     const std::string& host() const;
     BodyType bodyType() const;
     const std::string& tempBuffer() const;
-    const std::string& body() const;
+    const RequestBody& body() const;
     void setMethod(HttpMethod method);
     void setUri(const std::string& uri);
     void setHeadersDone();
     void addHeader(const std::string& name, const std::string& value);
     void setShouldClose(bool value);
-    void setTempBuffer(const std::string& buffer);
+    void setMaxBodySize(size_t size);
+    void setBodySettings(const BodySettings& settings);
+    void streamBodyTo(std::unique_ptr<MultipartParser> parser);
+    void setTempBuffer(std::string buffer);
+    std::string takeTempBuffer();
     void setBody(const std::string& data);
-    void appendTempBuffer(const std::string& data);
+    void appendTempBuffer(std::string_view data);
     void setRequestDone();
     void markBadRequest();
+    void markBodyTooLarge();
+    void markServerError();
 
     // Methods
+    bool parseHeaderPart();
     bool parse();
-    RequestData buildRequestData() const;
+    RequestData takeRequestData();
 };
 
 #endif
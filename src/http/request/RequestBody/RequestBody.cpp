@@ -0,0 +1,367 @@
+#include "RequestBody.hpp"
+#include "MultipartParser.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace
+{
+	constexpr size_t COPY_CHUNK = 64 * 1024;
+
+	[[noreturn]] void fail(const std::string& what)
+	{
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	void writeFully(int fd, const char* data, size_t n, const std::string& what)
+	{
+		while (n > 0)
+		{
+			ssize_t written = ::write(fd, data, n);
+			if (written < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				fail(what);
+			}
+			data += written;
+			n -= written;
+		}
+	}
+
+	// Copies a whole file, for when it can't be linked in place
+	void copyFile(int from, size_t size, const std::string& path)
+	{
+		int to = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+		if (to == -1)
+			fail("Failed to open file '" + path + "' for writing");
+
+		off_t offset = 0;
+		while (static_cast<size_t>(offset) < size)
+		{
+			ssize_t n = ::sendfile(to, from, &offset, size - offset);
+			if (n <= 0)
+			{
+				int err = n == 0 ? EIO : errno;
+				::close(to);
+				errno = err;
+				fail("Failed to write file '" + path + "'");
+			}
+		}
+		::close(to);
+	}
+}
+
+// -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
+
+RequestBody::RequestBody()
+	: m_memory(), m_fd(-1), m_tempName(), m_size(0), m_bufferSize(SIZE_MAX),
+	m_tempPath("/tmp"), m_multipart() {}
+
+RequestBody::RequestBody(RequestBody&& other) noexcept
+	: m_memory(std::move(other.m_memory)), m_fd(other.m_fd),
+	m_tempName(std::move(other.m_tempName)), m_size(other.m_size),
+	m_bufferSize(other.m_bufferSize), m_tempPath(std::move(other.m_tempPath)),
+	m_multipart(std::move(other.m_multipart))
+{
+	other.m_fd = -1;
+	other.m_tempName.clear();
+	other.m_memory.clear();
+	other.m_size = 0;
+}
+
+RequestBody& RequestBody::operator=(RequestBody&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_memory = std::move(other.m_memory);
+		m_fd = other.m_fd;
+		m_tempName = std::move(other.m_tempName);
+		m_size = other.m_size;
+		m_bufferSize = other.m_bufferSize;
+		m_tempPath = std::move(other.m_tempPath);
+		m_multipart = std::move(other.m_multipart);
+		other.m_fd = -1;
+		other.m_tempName.clear();
+		other.m_memory.clear();
+		other.m_size = 0;
+	}
+	return *this;
+}
+
+RequestBody::~RequestBody()
+{
+	release();
+}
+
+// ---------------------------ACCESSORS-----------------------------
+
+size_t RequestBody::size() const
+{
+	return m_size;
+}
+
+bool RequestBody::empty() const
+{
+	return m_size == 0;
+}
+
+bool RequestBody::isSpooled() const
+{
+	return m_fd != -1;
+}
+
+bool RequestBody::isStreamed() const
+{
+	return m_multipart != nullptr;
+}
+
+int RequestBody::fd() const
+{
+	return m_fd;
+}
+
+std::string_view RequestBody::memory() const
+{
+	return m_memory;
+}
+
+void RequestBody::setSpooling(size_t bufferSize, const std::string& tempPath)
+{
+	m_bufferSize = bufferSize;
+	if (!tempPath.empty())
+		m_tempPath = tempPath;
+}
+
+// From now on the bytes go to the parser, only their count is kept
+void RequestBody::streamTo(std::unique_ptr<MultipartParser> parser)
+{
+	m_multipart = std::move(parser);
+}
+
+std::unique_ptr<MultipartParser> RequestBody::takeMultipart()
+{
+	return std::move(m_multipart);
+}
+
+// ---------------------------METHODS-----------------------------
+
+// Room for a body of a known size: a body that won't fit in memory goes
+// to disk before its first byte
+void RequestBody::reserve(size_t expected)
+{
+	if (m_fd != -1 || m_multipart)
+		return;
+	if (expected > m_bufferSize)
+		spool();
+	else
+		m_memory.reserve(std::min(expected, MAX_MEMORY_RESERVE));
+}
+
+void RequestBody::append(std::string_view data)
+{
+	if (m_multipart)
+	{
+		m_multipart->feed(data);
+		m_size += data.size();
+		return;
+	}
+	if (m_fd == -1 && m_size + data.size() > m_bufferSize)
+		spool();
+
+	if (m_fd != -1)
+		writeAll(data);
+	else
+		m_memory.append(data.data(), data.size());
+	m_size += data.size();
+}
+
+void RequestBody::clear()
+{
+	release();
+	m_multipart.reset();
+	m_memory.clear();
+	m_size = 0;
+}
+
+// The whole body in memory, read back from disk if it was spooled
+std::string RequestBody::str() const
+{
+	if (m_fd == -1)
+		return m_memory;
+
+	std::string out(m_size, '\0');
+	out.resize(read(0, out.data(), m_size));
+	return out;
+}
+
+// Copies up to n bytes from offset into buf, returns how many
+size_t RequestBody::read(size_t offset, char* buf, size_t n) const
+{
+	if (offset >= m_size)
+		return 0;
+	n = std::min(n, m_size - offset);
+
+	if (m_fd == -1)
+	{
+		std::memcpy(buf, m_memory.data() + offset, n);
+		return n;
+	}
+
+	size_t done = 0;
+	while (done < n)
+	{
+		ssize_t got = ::pread(m_fd, buf + done, n - done, offset + done);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got <= 0)
+			break;
+		done += got;
+	}
+	return done;
+}
+
+// Writes up to max bytes from offset to fd, like write(2). A spooled
+// body goes from the page cache to a pipe without being copied in
+// userspace
+ssize_t RequestBody::writeTo(int fd, size_t offset, size_t max) const
+{
+	if (offset >= m_size)
+		return 0;
+	size_t n = std::min(max, m_size - offset);
+
+	if (m_fd == -1)
+		return ::write(fd, m_memory.data() + offset, n);
+
+	loff_t from = offset;
+	ssize_t spliced = ::splice(m_fd, &from, fd, nullptr, n,
+		SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+	if (spliced >= 0 || errno != EINVAL)
+		return spliced;
+
+	// Not a pipe
+	char buf[COPY_CHUNK];
+	size_t got = read(offset, buf, std::min(n, sizeof(buf)));
+	return ::write(fd, buf, got);
+}
+
+// Stores the body as the file at path. A spooled body is linked (or
+// renamed) there rather than copied, unless it's on another filesystem
+void RequestBody::saveAs(const std::string& path)
+{
+	if (m_fd == -1)
+	{
+		int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+		if (fd == -1)
+			fail("Failed to open file '" + path + "' for writing");
+		try
+		{
+			writeFully(fd, m_memory.data(), m_memory.size(),
+				"Failed to write file '" + path + "'");
+		}
+		catch (...)
+		{
+			::close(fd);
+			throw;
+		}
+		::close(fd);
+		return;
+	}
+
+	if (m_tempName.empty())
+	{
+		std::string self = "/proc/self/fd/" + std::to_string(m_fd);
+		int linked = ::linkat(AT_FDCWD, self.c_str(), AT_FDCWD, path.c_str(),
+			AT_SYMLINK_FOLLOW);
+		if (linked == -1 && errno == EEXIST && ::unlink(path.c_str()) == 0)
+			linked = ::linkat(AT_FDCWD, self.c_str(), AT_FDCWD, path.c_str(),
+				AT_SYMLINK_FOLLOW);
+		if (linked == 0)
+			return;
+		if (errno != EXDEV && errno != ENOENT)
+			fail("Failed to link file '" + path + "'");
+	}
+	else
+	{
+		::fchmod(m_fd, 0644);
+		if (::rename(m_tempName.c_str(), path.c_str()) == 0)
+		{
+			m_tempName.clear(); // it's path now, not to be unlinked
+			return;
+		}
+		if (errno != EXDEV)
+			fail("Failed to move file '" + path + "'");
+	}
+	copyFile(m_fd, m_size, path);
+}
+
+// The temp file is anonymous where the filesystem supports it, a name
+// is only made up, and unlinked with the body, otherwise
+void RequestBody::openTempFile()
+{
+	m_fd = ::open(m_tempPath.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0666);
+	if (m_fd != -1)
+		return;
+	if (errno != EOPNOTSUPP && errno != EISDIR && errno != EINVAL)
+		fail("client_body_temp_path '" + m_tempPath + "'");
+
+	std::string name = m_tempPath + "/webserv_body_XXXXXX";
+	m_fd = ::mkostemp(name.data(), O_CLOEXEC);
+	if (m_fd == -1)
+		fail("client_body_temp_path '" + m_tempPath + "'");
+	m_tempName = std::move(name);
+}
+
+// Moves what is in memory to a new temp file
+void RequestBody::spool()
+{
+	openTempFile();
+	writeAll(m_memory);
+	std::string().swap(m_memory);
+}
+
+void RequestBody::writeAll(std::string_view data)
+{
+	writeFully(m_fd, data.data(), data.size(), "Failed to spool the request body");
+}
+
+void RequestBody::release()
+{
+	if (m_fd == -1)
+		return;
+	::close(m_fd);
+	m_fd = -1;
+	if (!m_tempName.empty())
+		::unlink(m_tempName.c_str());
+	m_tempName.clear();
+}
+
+// --------------------------OPERATORS----------------------------
+
+bool operator==(const RequestBody& body, std::string_view str)
+{
+	if (body.m_fd == -1)
+		return body.m_memory == str;
+	return body.m_size == str.size() && body.str() == str;
+}
+
+bool operator!=(const RequestBody& body, std::string_view str)
+{
+	return !(body == str);
+}
+
+std::ostream& operator<<(std::ostream& os, const RequestBody& body)
+{
+	if (body.m_fd == -1)
+		return os << body.m_memory;
+	return os << "<" << body.m_size << " bytes spooled to disk>";
+}
@@ -0,0 +1,77 @@
+#ifndef REQUESTBODY_HPP
+#define REQUESTBODY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+class MultipartParser;
+
+// A request body, kept in memory up to client_body_buffer_size and in a
+// temp file under client_body_temp_path past it, so a large upload only
+// costs the memory of the read buffer. The temp file is anonymous
+// (O_TMPFILE) where the filesystem allows it, it then never shows up in
+// the directory and disappears with its descriptor. A spooled body is
+// handed on without being read back: spliced into a CGI's stdin, or
+// linked in place as an uploaded file. A multipart upload can instead
+// be streamed to a MultipartParser, the body then isn't kept at all.
+class RequestBody
+{
+  private:
+    // Properties
+    std::string m_memory;
+    int m_fd; // -1 while in memory
+    std::string m_tempName; // of a named temp file, "" if anonymous
+    size_t m_size;
+    size_t m_bufferSize;
+    std::string m_tempPath;
+    std::unique_ptr<MultipartParser> m_multipart; // gets the bytes if set
+
+    // Methods
+    void spool();
+    void openTempFile();
+    void writeAll(std::string_view data);
+    void release();
+
+  public:
+    // Constants
+    // Never reserved up front past this, whatever the client announces
+    static constexpr size_t MAX_MEMORY_RESERVE = 64 * 1024 * 1024;
+
+    // Construction and destruction
+    RequestBody();
+    RequestBody(const RequestBody& other) = delete;
+    RequestBody& operator=(const RequestBody& other) = delete;
+    RequestBody(RequestBody&& other) noexcept;
+    RequestBody& operator=(RequestBody&& other) noexcept;
+    ~RequestBody();
+
+    // Accessors
+    size_t size() const;
+    bool empty() const;
+    bool isSpooled() const;
+    bool isStreamed() const;
+    int fd() const; // -1 if in memory
+    std::string_view memory() const; // "" once spooled
+    void setSpooling(size_t bufferSize, const std::string& tempPath);
+    void streamTo(std::unique_ptr<MultipartParser> parser);
+    std::unique_ptr<MultipartParser> takeMultipart();
+
+    // Methods
+    void reserve(size_t expected);
+    void append(std::string_view data);
+    void clear();
+    std::string str() const;
+    size_t read(size_t offset, char* buf, size_t n) const;
+    ssize_t writeTo(int fd, size_t offset, size_t max) const;
+    void saveAs(const std::string& path);
+
+    friend bool operator==(const RequestBody& body, std::string_view str);
+    friend bool operator!=(const RequestBody& body, std::string_view str);
+    friend std::ostream& operator<<(std::ostream& os, const RequestBody& body);
+};
+
+#endif
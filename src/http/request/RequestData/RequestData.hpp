@@ -6,6 +6,8 @@
 # include <unordered_map>
 
 # include "HttpMethod.hpp"
+# include "HeaderMap.hpp"
+# include "RequestBody.hpp"
 
 struct RequestData
 {
@@ -13,14 +15,13 @@ struct RequestData
 	std::string uri{};
 	std::string query{};
 	std::string httpVersion{};
-	std::unordered_map<std::string, std::string> headers{};
-	std::string body{};
+	HeaderMap headers{};
+	RequestBody body{};
 	ssize_t bytesSent{0};
 	
-	std::string getHeader(const std::string& key) const
+	const std::string& getHeader(std::string_view key) const
 	{
-		auto it = headers.find(key);
-		return (it != headers.end()) ? it->second : "";
+		return headers.get(key);
 	}
 };
 
@@ -8,7 +8,7 @@ namespace RequestHandler
 								RawResponse& redirResp,
 								CgiRequestResult& cgiResult)
 	{
-        FileInfo path = FileUtils::getFileInfo(ctx.resolved_path);
+        FileInfo path = OpenFileCache::local().stat(ctx.resolved_path);
 		if (!(path.exists && path.isFile && path.readable))
 		{
 			redirResp.addDefaultError(curRawResp.statusCode());
@@ -26,7 +26,7 @@ namespace RequestHandler
 		}
 	}
 
-	RawResponse handleSingleRequest(const RawRequest& rawReq,
+	RawResponse handleSingleRequest(RawRequest& rawReq,
 									 const Client& client,
 									 const Config& config,
 									CgiRequestResult& cgiResult)
@@ -39,6 +39,16 @@ namespace RequestHandler
 		if (curRawResp.isInternalRedirect())
 		{
 			std::string newUri = curRawResp.lookupErrorPageUri(ctx.error_pages, curRawResp.statusCode());
+
+			// Preloaded with the config: no second lookup, no disk access
+			CachedResponse page = config.errorPage(client.getListeningEndpoint(), rawReq.host(), newUri);
+			if (page.body)
+			{
+				curRawResp.setInternalRedirect(false);
+				curRawResp.setCachedBody(page);
+				return curRawResp;
+			}
+
 			RequestContext newCtx = config.createRequestContext(client.getListeningEndpoint(), rawReq.host(), newUri);
 			RawResponse redirResp;
 
@@ -9,7 +9,7 @@
 
 namespace RequestHandler
 {
-	RawResponse handleSingleRequest(const RawRequest& rawReq,
+	RawResponse handleSingleRequest(RawRequest& rawReq,
 									const Client& client,
 									const Config& config,
 									CgiRequestResult& cgiResult);
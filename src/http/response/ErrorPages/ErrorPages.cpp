@@ -0,0 +1,181 @@
+#include "ErrorPages.hpp"
+#include "GzipEncoder.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    const char* const SERVER = "APT-Server/1.0";
+
+    std::string renderDefaultBody(HttpStatusCode code)
+    {
+        const std::string title
+            = std::to_string(static_cast<int>(code)) + " " + codeToText(code);
+
+        return "<html>\n"
+               "<head><title>" + title + "</title></head>\n"
+               "<body>\n"
+               "<center><h1>" + title + "</h1></center>\n"
+               "<center><h3>(Default Error Page)</h3></center>\n"
+               "<hr><center>" + SERVER + "</center>\n"
+               "</body>\n"
+               "</html>\n";
+    }
+
+    std::string renderHeaders(const std::string& mimeType, size_t length,
+                              bool gzipped)
+    {
+        return std::string("Server: ") + SERVER + "\r\nContent-Type: " + mimeType
+            + "\r\nContent-Length: " + std::to_string(length)
+            + (gzipped ? "\r\nContent-Encoding: gzip\r\nVary: Accept-Encoding"
+                       : "")
+            + "\r\n\r\n";
+    }
+
+    // The page and its gzip variant
+    CachedResponse makePage(const std::string& mimeType, std::string body)
+    {
+        auto gzipped = std::make_shared<CachedResponse>();
+        gzipped->body = std::make_shared<const std::string>(
+            GzipEncoder::compress(body, ErrorPages::GZIP_LEVEL));
+        gzipped->headers = std::make_shared<const std::string>(
+            renderHeaders(mimeType, gzipped->body->size(), true));
+
+        CachedResponse page;
+        page.headers = std::make_shared<const std::string>(
+            renderHeaders(mimeType, body.size(), false));
+        page.body = std::make_shared<const std::string>(std::move(body));
+        page.gzipped = gzipped;
+        page.mimeType = mimeType;
+        return page;
+    }
+
+    CachedResponse renderDefaultPage(HttpStatusCode code)
+    {
+        return makePage("text/html", renderDefaultBody(code));
+    }
+
+    // Every code with a reason phrase, rendered before the first request
+    std::unordered_map<int, CachedResponse> renderDefaultPages()
+    {
+        std::unordered_map<int, CachedResponse> pages;
+        for (int code = 100; code < 600; ++code)
+        {
+            HttpStatusCode status = static_cast<HttpStatusCode>(code);
+            if (!statusLine(status).empty())
+                pages.emplace(code, renderDefaultPage(status));
+        }
+        return pages;
+    }
+
+    const std::unordered_map<int, CachedResponse> DEFAULT_PAGES
+        = renderDefaultPages();
+}
+
+// ---------------------------ACCESSORS-----------------------------
+
+CachedResponse ErrorPages::defaultPage(HttpStatusCode code)
+{
+    auto it = DEFAULT_PAGES.find(static_cast<int>(code));
+    if (it != DEFAULT_PAGES.end())
+        return it->second;
+    return renderDefaultPage(code);
+}
+
+// Empty when the page couldn't be read: the caller falls back to
+// serving the uri like any other request
+CachedResponse ErrorPages::customPage(size_t server,
+                                      const std::string& uri) const
+{
+    if (server >= m_pages.size())
+        return {};
+
+    auto it = m_pages[server].find(uri);
+    if (it == m_pages[server].end())
+        return {};
+
+    Page& page = *it->second;
+    refresh(page);
+
+    std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&page.snapshot);
+    return snapshot ? snapshot->response : CachedResponse();
+}
+
+// ---------------------------METHODS-----------------------------
+
+void ErrorPages::add(size_t server, const std::string& uri,
+                     const std::string& path, const std::string& mimeType)
+{
+    if (m_pages.size() <= server)
+        m_pages.resize(server + 1);
+
+    auto page = std::make_unique<Page>();
+    page->path = path;
+    page->mimeType = mimeType;
+    page->snapshot = load(*page);
+    page->checkedAt = std::time(nullptr);
+    m_pages[server][uri] = std::move(page);
+}
+
+// One thread per second gets to stat the file, the others keep
+// serving what they have
+void ErrorPages::refresh(Page& page)
+{
+    std::time_t now = std::time(nullptr);
+    std::time_t checked = page.checkedAt.load(std::memory_order_relaxed);
+    if (checked == now
+        || !page.checkedAt.compare_exchange_strong(checked, now))
+        return;
+
+    std::shared_ptr<const Snapshot> current = std::atomic_load(&page.snapshot);
+
+    struct stat s;
+    if (stat(page.path.c_str(), &s) != 0)
+    {
+        std::atomic_store(&page.snapshot, std::shared_ptr<const Snapshot>());
+        return;
+    }
+    if (current && current->ino == s.st_ino && current->size == s.st_size
+        && current->mtime.tv_sec == s.st_mtim.tv_sec
+        && current->mtime.tv_nsec == s.st_mtim.tv_nsec)
+        return;
+
+    std::atomic_store(&page.snapshot, load(page));
+}
+
+// nullptr when the file isn't a small readable regular file
+std::shared_ptr<const ErrorPages::Snapshot> ErrorPages::load(const Page& page)
+{
+    int fd = open(page.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat s;
+    if (fstat(fd, &s) != 0 || !S_ISREG(s.st_mode)
+        || static_cast<size_t>(s.st_size) > MAX_FILE_SIZE)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    std::string body(s.st_size, '\0');
+    size_t done = 0;
+    while (done < body.size())
+    {
+        ssize_t n = read(fd, &body[done], body.size() - done);
+        if (n <= 0)
+            break;
+        done += n;
+    }
+    close(fd);
+    if (done != body.size())
+        return nullptr;
+
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->response = makePage(page.mimeType, std::move(body));
+    snapshot->ino = s.st_ino;
+    snapshot->size = s.st_size;
+    snapshot->mtime = s.st_mtim;
+    return snapshot;
+}
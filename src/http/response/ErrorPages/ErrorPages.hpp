@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef ERRORPAGES_HPP
+# define ERRORPAGES_HPP
+
+# include <atomic>
+# include <ctime>
+# include <memory>
+# include <string>
+# include <unordered_map>
+# include <vector>
+# include <sys/stat.h>
+
+# include "HttpStatusCode.hpp"
+# include "ResponseCache.hpp"
+
+// Error page bodies as CachedResponses, ready to be shared by every
+// response that needs them. The default pages are rendered once per
+// status code. Pages never change, so each one is gzipped once, when
+// it is loaded, instead of on every response. The error_page targets of each server are read when the
+// Config is built, and read again when the file changes on disk; the
+// file is looked at no more than once per second. Shared by all reactor
+// threads.
+class ErrorPages
+{
+    // Construction and destruction
+  public:
+    ErrorPages() = default;
+    ErrorPages(const ErrorPages& other) = delete;
+    ErrorPages& operator=(const ErrorPages& other) = delete;
+    ErrorPages(ErrorPages&& other) noexcept = default;
+    ErrorPages& operator=(ErrorPages&& other) noexcept = default;
+    ~ErrorPages() = default;
+
+    // Class specific features
+  public:
+    // Constants
+    static constexpr size_t MAX_FILE_SIZE = 1024 * 1024;
+    static constexpr int GZIP_LEVEL = 9;
+    // Accessors
+    static CachedResponse defaultPage(HttpStatusCode code);
+    CachedResponse customPage(size_t server, const std::string& uri) const;
+    // Methods
+    void add(size_t server, const std::string& uri, const std::string& path,
+             const std::string& mimeType);
+
+  private:
+    struct Snapshot
+    {
+        CachedResponse response;
+        ino_t ino = 0;
+        off_t size = 0;
+        timespec mtime{};
+    };
+
+    struct Page
+    {
+        std::string path;
+        std::string mimeType;
+        std::shared_ptr<const Snapshot> snapshot; // atomic access only
+        std::atomic<std::time_t> checkedAt{0};
+    };
+
+    // Properties
+    std::vector<std::unordered_map<std::string, std::unique_ptr<Page>>>
+        m_pages; // per server, by uri
+    // Methods
+    static void refresh(Page& page);
+    static std::shared_ptr<const Snapshot> load(const Page& page);
+};
+
+#endif
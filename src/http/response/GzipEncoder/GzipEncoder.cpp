@@ -0,0 +1,53 @@
+#include "GzipEncoder.hpp"
+
+// 15 bits of window, +16 for a gzip header and trailer instead of zlib's
+GzipEncoder::GzipEncoder(int level)
+	: m_stream()
+{
+	if (deflateInit2(&m_stream, level, Z_DEFLATED, 15 + 16, 8,
+					 Z_DEFAULT_STRATEGY) != Z_OK)
+		throw std::runtime_error("deflateInit2 failed");
+}
+
+GzipEncoder::~GzipEncoder()
+{
+	deflateEnd(&m_stream);
+}
+
+// May return nothing: zlib keeps small inputs until it has a block
+std::string GzipEncoder::update(const char* data, size_t size)
+{
+	return deflateInput(data, size, Z_NO_FLUSH);
+}
+
+// The end of the stream, with the gzip trailer
+std::string GzipEncoder::finish()
+{
+	return deflateInput(nullptr, 0, Z_FINISH);
+}
+
+std::string GzipEncoder::compress(const std::string& data, int level)
+{
+	GzipEncoder encoder(level);
+	std::string out = encoder.update(data.data(), data.size());
+	return out + encoder.finish();
+}
+
+std::string GzipEncoder::deflateInput(const char* data, size_t size, int flush)
+{
+	std::string out;
+	char buf[16384];
+
+	m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	m_stream.avail_in = static_cast<uInt>(size);
+	do
+	{
+		m_stream.next_out = reinterpret_cast<Bytef*>(buf);
+		m_stream.avail_out = sizeof(buf);
+		if (deflate(&m_stream, flush) == Z_STREAM_ERROR)
+			throw std::runtime_error("deflate failed");
+		out.append(buf, sizeof(buf) - m_stream.avail_out);
+	} while (m_stream.avail_out == 0);
+
+	return out;
+}
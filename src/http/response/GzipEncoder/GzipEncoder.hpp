@@ -0,0 +1,29 @@
+#ifndef GZIPENCODER_HPP
+#define GZIPENCODER_HPP
+
+#include <string>
+#include <stdexcept>
+#include <zlib.h>
+
+// Incremental gzip compression: input goes in by pieces, compressed
+// bytes come out as soon as zlib has them
+class GzipEncoder
+{
+	public:
+		explicit GzipEncoder(int level);
+		GzipEncoder(const GzipEncoder& other) = delete;
+		GzipEncoder& operator=(const GzipEncoder& other) = delete;
+		~GzipEncoder();
+
+		std::string update(const char* data, size_t size);
+		std::string finish();
+
+		static std::string compress(const std::string& data, int level);
+
+	private:
+		z_stream m_stream;
+
+		std::string deflateInput(const char* data, size_t size, int flush);
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "GzipFileStream.hpp"
+
+GzipFileStream::GzipFileStream(const FileBody& file, int level)
+	: m_file(file), m_encoder(level), m_read(0), m_finished(false)
+{
+}
+
+bool GzipFileStream::finished() const
+{
+	return m_finished;
+}
+
+// Reads on until zlib gives something back, the file is shared with
+// other responses so it is read with pread
+bool GzipFileStream::next(std::string& out)
+{
+	std::string buf(READ_SIZE, '\0');
+
+	out.clear();
+	while (!m_finished && out.empty())
+	{
+		if (m_read == m_file.length)
+		{
+			out = chunk(m_encoder.finish()) + "0\r\n\r\n";
+			m_finished = true;
+			break;
+		}
+
+		size_t want = std::min(READ_SIZE, m_file.length - m_read);
+		ssize_t n = pread(m_file.fd->get(), &buf[0], want, m_file.offset + m_read);
+		if (n <= 0)
+		{
+			// Shorter than when it was opened: the body can't be completed
+			if (n == 0)
+				errno = EIO;
+			return false;
+		}
+		m_read += n;
+		out = chunk(m_encoder.update(buf.data(), n));
+	}
+	return true;
+}
+
+std::string GzipFileStream::chunk(const std::string& data)
+{
+	if (data.empty())
+		return "";
+
+	std::ostringstream size;
+	size << std::hex << data.size();
+	return size.str() + "\r\n" + data + "\r\n";
+}
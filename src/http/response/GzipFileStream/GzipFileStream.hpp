@@ -0,0 +1,35 @@
+#ifndef GZIPFILESTREAM_HPP
+#define GZIPFILESTREAM_HPP
+
+#include <string>
+#include <algorithm>
+#include <cerrno>
+#include <sstream>
+#include <unistd.h>
+
+#include "BodyStream.hpp"
+#include "FileBody.hpp"
+#include "GzipEncoder.hpp"
+
+// A file compressed while it is sent, a piece at a time, so that its
+// compressed size is never needed: the output is a chunked body
+class GzipFileStream : public BodyStream
+{
+	public:
+		static constexpr size_t READ_SIZE = 64 * 1024;
+
+		GzipFileStream(const FileBody& file, int level);
+
+		bool finished() const override;
+		bool next(std::string& out) override;
+
+	private:
+		FileBody m_file;
+		GzipEncoder m_encoder;
+		size_t m_read;
+		bool m_finished;
+
+		static std::string chunk(const std::string& data);
+};
+
+#endif
@@ -17,9 +17,9 @@ RawResponse::RawResponse()
 
 // ---------------------------ACCESSORS-----------------------------
 
-bool RawResponse::hasHeader(const std::string& key) const
+bool RawResponse::hasHeader(std::string_view key) const
 {
-	return m_headers.find(key) != m_headers.end();
+	return m_headers.count(key) != 0;
 }
 
 bool RawResponse::isInternalRedirect() const
@@ -29,8 +29,7 @@ bool RawResponse::isInternalRedirect() const
 
 bool RawResponse::shouldClose() const
 {
-	auto it = m_headers.find("Connection");
-	return it != m_headers.end() && it->second == "close";
+	return m_headers.get("Connection") == "close";
 }
 
 HttpStatusCode RawResponse::statusCode() const
@@ -43,13 +42,12 @@ const std::string& RawResponse::statusText() const
 	return m_statusText;
 }
 
-std::string RawResponse::header(const std::string& key) const
+const std::string& RawResponse::header(std::string_view key) const
 {
-	auto it = m_headers.find(key);
-	return it != m_headers.end() ? it->second : "";
+	return m_headers.get(key);
 }
 
-const std::unordered_map<std::string, std::string>& RawResponse::headers() const
+const HeaderMap& RawResponse::headers() const
 {
 	return m_headers;
 }
@@ -59,6 +57,11 @@ const std::string& RawResponse::body() const
 	return m_body;
 }
 
+const FileBody& RawResponse::fileBody() const
+{
+	return m_fileBody;
+}
+
 size_t RawResponse::fileSize() const
 {
 	return m_fileSize;
@@ -78,9 +81,47 @@ void RawResponse::setStatusCode(HttpStatusCode code)
 void RawResponse::setBody(const std::string& body)
 {
 	m_body = body;
+	m_fileBody = FileBody();
+	m_cached = CachedResponse();
+	m_parts.clear();
 	m_headers["Content-Length"] = std::to_string(body.size());
 }
 
+void RawResponse::setFileBody(const FileBody& file)
+{
+	m_body.clear();
+	m_fileBody = file;
+	m_cached = CachedResponse();
+	m_parts.clear();
+	m_headers["Content-Length"] = std::to_string(file.length);
+}
+
+// Content-Type, Content-Length and Server come with the cached headers
+void RawResponse::setCachedBody(const CachedResponse& cached)
+{
+	m_body.clear();
+	m_fileBody = FileBody();
+	m_cached = cached;
+	m_parts.clear();
+	m_headers.erase("Content-Length");
+	m_headers.erase("Content-Type");
+}
+
+void RawResponse::setMultipartBody(const std::vector<BodyPart>& parts,
+								   const std::string& boundary)
+{
+	m_body.clear();
+	m_fileBody = FileBody();
+	m_cached = CachedResponse();
+	m_parts = parts;
+
+	size_t length = 0;
+	for (const BodyPart& part : parts)
+		length += part.data.size() + part.file.length;
+	m_headers["Content-Length"] = std::to_string(length);
+	m_mimeType = "multipart/byteranges; boundary=" + boundary;
+}
+
 void RawResponse::setInternalRedirect(bool val)
 {
 	m_isInternalRedirect = val;
@@ -96,32 +137,25 @@ void RawResponse::setFileSize(size_t size)
 	m_fileSize = size;
 }
 
-// ---------------------------METHODS-----------------------------
-
-std::string getCurrentHttpDate()
+const GzipSettings& RawResponse::gzip() const
 {
-	// Get current time as system_clock time_point
-	auto now = std::chrono::system_clock::now();
-
-	// Convert to time_t (seconds since epoch)
-	std::time_t t = std::chrono::system_clock::to_time_t(now);
-
-	// Convert to GMT/UTC time
-	std::tm gmt = *std::gmtime(&t);
+	return m_gzip;
+}
 
-	// Format according to RFC 7231: "Day, DD Mon YYYY HH:MM:SS GMT"
-	std::ostringstream oss;
-	oss << std::put_time(&gmt, "%a, %d %b %Y %H:%M:%S GMT");
-	return oss.str();
+void RawResponse::setGzip(const GzipSettings& gzip)
+{
+	m_gzip = gzip;
 }
 
+// ---------------------------METHODS-----------------------------
+
 void RawResponse::addDefaultHeaders()
 {
-	addHeader("Date", getCurrentHttpDate());
+	addHeader("Date", HttpDate::cached());
 	addHeader("Server", "APT-Server/1.0");
 }
 
-void RawResponse::addHeader(const std::string& key, const std::string& value)
+void RawResponse::addHeader(std::string_view key, const std::string& value)
 {
 	if (!hasHeader(key))
 		m_headers[key] = value;
@@ -171,23 +205,10 @@ void RawResponse::addDefaultError(HttpStatusCode code)
 		<< static_cast<int>(code) << " (" << codeToText(code) << ")");
 	
 	setStatusCode(code);
+	setCachedBody(ErrorPages::defaultPage(code));
 
-	std::string htmlBody =
-		"<html>\n"
-		"<head><title>" + std::to_string(static_cast<int>(code)) + " " + m_statusText + "</title></head>\n"
-		"<body>\n"
-		"<center><h1>" + std::to_string(static_cast<int>(code)) + " " + m_statusText + "</h1></center>\n"
-		"<center><h3>(Default Error Page)</h3></center>\n"
-		"<hr><center>APT-Server/1.0</center>\n"
-		"</body>\n"
-		"</html>\n";
-
-	setBody(htmlBody);
-	m_mimeType = "text/html";
-	addHeader("Content-Length", std::to_string(m_body.size()));
-
-	DBG("[addDefaultError] Default error page generated, length = " 
-		<< _body.size());
+	DBG("[addDefaultError] Default error page set, length = "
+		<< m_cached.body->size());
 }
 
 ResponseData RawResponse::toResponseData() const
@@ -199,26 +220,86 @@ ResponseData RawResponse::toResponseData() const
 	data.statusText = codeToText(m_statusCode);
 	data.headers = m_headers;
 	data.shouldClose = shouldClose();
+	data.gzip = m_gzip;
 
 	// Determine if we should include a body
 	bool noBody = (m_statusCode == HttpStatusCode::NoContent) || 
 				  (m_statusCode == HttpStatusCode::NotModified) || 
 				  (static_cast<int>(m_statusCode) >= 100 && static_cast<int>(m_statusCode) < 200);
 
+	if (!noBody && m_cached.headers)
+	{
+		// Error pages come with their gzip variant
+		const CachedResponse& page
+			= m_cached.gzipped
+					  && m_gzip.appliesTo(m_cached.mimeType, m_cached.body->size())
+				  ? *m_cached.gzipped
+				  : m_cached;
+		data.cachedHeaders = page.headers;
+		data.cachedBody = page.body;
+		data.headers.erase("Server");
+		return data;
+	}
+
 	if (!noBody)
 		data.body = m_body;
 	else
 		data.body.clear();
 
-	if (!noBody)
+	if (!noBody && m_fileBody.isSet())
+	{
+		data.file = m_fileBody;
+		data.headers["Content-Length"] = std::to_string(m_fileBody.length);
+	}
+	else if (!noBody && !m_parts.empty())
+		data.parts = m_parts;
+	else if (!noBody)
 		data.headers["Content-Length"] = std::to_string(data.body.size());
 
-	data.headers["Content-Type"] = m_mimeType;
+	if (!noBody)
+		data.headers["Content-Type"] = m_mimeType;
+
+	// Ranges are ranges of the uncompressed file
+	if (!noBody && m_gzip.enabled && m_gzip.compresses(m_mimeType)
+		&& m_statusCode != HttpStatusCode::PartialContent
+		&& !hasHeader("Content-Encoding"))
+		compressBody(data);
 
 	return data;
 
 }
 
+// A file is compressed while it is sent, its compressed length isn't
+// known yet, so it goes out chunked
+void RawResponse::compressBody(ResponseData& data) const
+{
+	if (data.file.isSet())
+	{
+		if (data.file.length < m_gzip.minLength)
+			return;
+		data.stream = std::make_shared<GzipFileStream>(data.file, m_gzip.level);
+		data.file = FileBody();
+		data.headers.erase("Content-Length");
+		data.headers["Transfer-Encoding"] = "chunked";
+	}
+	else
+	{
+		if (data.body.size() < m_gzip.minLength)
+			return;
+		data.body = GzipEncoder::compress(data.body, m_gzip.level);
+		data.headers["Content-Length"] = std::to_string(data.body.size());
+	}
+
+	data.headers["Content-Encoding"] = "gzip";
+	data.headers["Vary"] = "Accept-Encoding";
+	data.headers.erase("Accept-Ranges");
+
+	// Not byte-for-byte the file anymore
+	auto etag = data.headers.find("ETag");
+	if (etag != data.headers.end() && etag->second.compare(0, 2, "W/") != 0)
+		etag->second = "W/" + etag->second;
+}
+
 void RawResponse::handleCgiScript()
 {
 	setStatusCode(HttpStatusCode::OK);
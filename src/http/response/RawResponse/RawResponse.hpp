@@ -14,6 +14,12 @@
 #include "HttpMethod.hpp"
 #include "HttpStatusCode.hpp"
 #include "CGIParser.hpp"
+#include "ResponseCache.hpp"
+#include "ErrorPages.hpp"
+#include "HttpDate.hpp"
+#include "GzipSettings.hpp"
+#include "GzipEncoder.hpp"
+#include "GzipFileStream.hpp"
 
 class RawResponse
 {
@@ -21,12 +27,19 @@ class RawResponse
 		// Properties
 		HttpStatusCode m_statusCode;
 		std::string m_statusText;
-		std::unordered_map<std::string, std::string> m_headers;
+		HeaderMap m_headers;
 		std::string m_body;
+		FileBody m_fileBody;
+		CachedResponse m_cached;
+		std::vector<BodyPart> m_parts;
+		GzipSettings m_gzip; // enabled if the client takes gzip
 		bool m_isInternalRedirect;
 		std::string m_mimeType;
 		size_t m_fileSize;
 
+		// Methods
+		void compressBody(ResponseData& data) const;
+
 	public:
 		// Construction and destruction
 		RawResponse();
@@ -37,25 +50,32 @@ class RawResponse
 		RawResponse& operator=(RawResponse&&) noexcept = default;
 		
 		// Accessors
-		bool hasHeader(const std::string& key) const;
+		bool hasHeader(std::string_view key) const;
 		bool isInternalRedirect() const;
 		bool shouldClose() const;
 		HttpStatusCode statusCode() const;
 		const std::string& statusText() const;
-		std::string header(const std::string& key) const;
-		const std::unordered_map<std::string, std::string>& headers() const;
+		const std::string& header(std::string_view key) const;
+		const HeaderMap& headers() const;
 		const std::string& body() const;
+		const FileBody& fileBody() const;
 		size_t fileSize() const;
 		const std::string& mimeType() const;
+		const GzipSettings& gzip() const;
 		void setStatusCode(HttpStatusCode code);
 		void setBody(const std::string& body);
+		void setFileBody(const FileBody& file);
+		void setCachedBody(const CachedResponse& cached);
+		void setMultipartBody(const std::vector<BodyPart>& parts,
+							  const std::string& boundary);
 		void setInternalRedirect(bool flag);
 		void setMimeType(const std::string& mime);
 		void setFileSize(size_t size);
+		void setGzip(const GzipSettings& gzip);
 		
 		// Methods
 		void addDefaultHeaders();
-		void addHeader(const std::string& key, const std::string& value);
+		void addHeader(std::string_view key, const std::string& value);
 		std::string lookupErrorPageUri(const std::map<HttpStatusCode, std::string>& error_pages,
 									HttpStatusCode status) const;
 		void addErrorDetails(const RequestContext& ctx, HttpStatusCode code);
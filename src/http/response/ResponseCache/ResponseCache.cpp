@@ -0,0 +1,159 @@
+#include "ResponseCache.hpp"
+
+// ---------------------------ACCESSORS-----------------------------
+
+ResponseCache& ResponseCache::local()
+{
+    static thread_local ResponseCache cache;
+    return cache;
+}
+
+bool ResponseCache::enabled() const
+{
+    return m_settings.maxBytes > 0;
+}
+
+size_t ResponseCache::bytes() const
+{
+    return m_bytes;
+}
+
+size_t ResponseCache::hits() const
+{
+    return m_hits;
+}
+
+size_t ResponseCache::misses() const
+{
+    return m_misses;
+}
+
+// ---------------------------METHODS-----------------------------
+
+void ResponseCache::configure(const Settings& settings)
+{
+    m_settings = settings;
+    clear();
+}
+
+// nullptr on a miss, or when the file changed since it was cached
+const CachedResponse* ResponseCache::lookup(const std::string& path,
+                                            const FileInfo& info)
+{
+    if (!enabled())
+        return nullptr;
+
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+    {
+        ++m_misses;
+        return nullptr;
+    }
+
+    Entry& entry = it->second;
+    if (!sameFile(entry, info))
+    {
+        invalidate(path);
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    m_lru.splice(m_lru.begin(), m_lru, entry.lruPos);
+    return &entry.response;
+}
+
+// Reads the file once. nullptr when it doesn't fit in the cache, or
+// when the open file isn't the one 'info' describes
+const CachedResponse* ResponseCache::insert(const std::string& path,
+                                            const FileBody& file,
+                                            const FileInfo& info,
+                                            const std::string& headers)
+{
+    if (!enabled() || !file.isSet() || file.length > m_settings.maxFileSize
+        || file.length + headers.size() > m_settings.maxBytes)
+        return nullptr;
+
+    struct stat s;
+    if (fstat(file.fd->get(), &s) != 0)
+        return nullptr;
+
+    Entry entry;
+    entry.dev = s.st_dev;
+    entry.ino = s.st_ino;
+    entry.size = s.st_size;
+    entry.mtime = s.st_mtim;
+    if (!sameFile(entry, info))
+        return nullptr;
+
+    std::string body;
+    if (!readAll(file, body))
+        return nullptr;
+
+    invalidate(path);
+
+    entry.response.headers = std::make_shared<const std::string>(headers);
+    entry.response.body = std::make_shared<const std::string>(std::move(body));
+
+    size_t needed = weight(entry.response);
+    evict(needed);
+    m_bytes += needed;
+
+    m_lru.push_front(path);
+    entry.lruPos = m_lru.begin();
+    return &m_entries.emplace(path, std::move(entry)).first->second.response;
+}
+
+void ResponseCache::invalidate(const std::string& path)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+        return;
+
+    m_bytes -= weight(it->second.response);
+    m_lru.erase(it->second.lruPos);
+    m_entries.erase(it);
+}
+
+void ResponseCache::clear()
+{
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+// Makes room for 'needed' more bytes
+void ResponseCache::evict(size_t needed)
+{
+    while (!m_lru.empty() && m_bytes + needed > m_settings.maxBytes)
+        invalidate(m_lru.back());
+}
+
+bool ResponseCache::sameFile(const Entry& entry, const FileInfo& info)
+{
+    return info.exists && entry.dev == info.device && entry.ino == info.inode
+        && entry.size == info.size && entry.mtime.tv_sec == info.mtime.tv_sec
+        && entry.mtime.tv_nsec == info.mtime.tv_nsec;
+}
+
+size_t ResponseCache::weight(const CachedResponse& response)
+{
+    return response.headers->size() + response.body->size();
+}
+
+// pread: the fd may be shared with responses that are being sent
+bool ResponseCache::readAll(const FileBody& file, std::string& out)
+{
+    out.resize(file.length);
+
+    size_t done = 0;
+    while (done < file.length)
+    {
+        ssize_t n = pread(file.fd->get(), &out[done], file.length - done,
+                          file.offset + done);
+        if (n <= 0)
+            return false;
+        done += n;
+    }
+    return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#ifndef RESPONSECACHE_HPP
+# define RESPONSECACHE_HPP
+
+# include <list>
+# include <memory>
+# include <string>
+# include <unordered_map>
+# include <sys/stat.h>
+# include <unistd.h>
+
+# include "FileBody.hpp"
+# include "FileUtils.hpp"
+
+// A small static file ready to be sent: the headers that don't change
+// between hits, already serialized, and the file contents. Immutable,
+// so responses in flight keep sharing it after it left the cache.
+struct CachedResponse
+{
+    std::shared_ptr<const std::string> headers; // ends with the empty line
+    std::shared_ptr<const std::string> body;
+    // Error pages only: the same page gzipped, and the type gzip_types
+    // is checked against
+    std::shared_ptr<const CachedResponse> gzipped;
+    std::string mimeType;
+};
+
+// Small static files kept in memory as CachedResponses, within a byte
+// budget. An entry is only used for the file the caller has stat'ed
+// (through the open file cache, no syscall here): same device, inode,
+// size and mtime as when it was read. So the body always matches the
+// validators sent with it. One cache per reactor thread.
+class ResponseCache
+{
+    // Construction and destruction
+  public:
+    ResponseCache() = default;
+    ResponseCache(const ResponseCache& other) = delete;
+    ResponseCache& operator=(const ResponseCache& other) = delete;
+    ResponseCache(ResponseCache&& other) noexcept = delete;
+    ResponseCache& operator=(ResponseCache&& other) noexcept = delete;
+    ~ResponseCache() = default;
+
+    // Class specific features
+  public:
+    struct Settings
+    {
+        size_t maxBytes = 0; // 0: the cache is off
+        size_t maxFileSize = 64 * 1024;
+    };
+
+    // Accessors
+    static ResponseCache& local();
+    bool enabled() const;
+    size_t bytes() const;
+    size_t hits() const;
+    size_t misses() const;
+    // Methods
+    void configure(const Settings& settings);
+    const CachedResponse* lookup(const std::string& path, const FileInfo& info);
+    const CachedResponse* insert(const std::string& path, const FileBody& file,
+                                 const FileInfo& info,
+                                 const std::string& headers);
+    void invalidate(const std::string& path);
+    void clear();
+
+  private:
+    struct Entry
+    {
+        CachedResponse response;
+        dev_t dev = 0;
+        ino_t ino = 0;
+        off_t size = 0;
+        timespec mtime{};
+        std::list<std::string>::iterator lruPos;
+    };
+
+    // Properties
+    Settings m_settings;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru; // most recently used first
+    size_t m_bytes = 0;
+    size_t m_hits = 0;
+    size_t m_misses = 0;
+    // Methods
+    void evict(size_t needed);
+    static bool sameFile(const Entry& entry, const FileInfo& info);
+    static size_t weight(const CachedResponse& response);
+    static bool readAll(const FileBody& file, std::string& out);
+};
+
+#endif
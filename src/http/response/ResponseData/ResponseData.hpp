@@ -3,8 +3,22 @@
 
 #include <string>
 #include <unordered_map>
+#include <memory>
+#include <vector>
 
 #include "FileUtils.hpp"
+#include "FileBody.hpp"
+#include "BodyStream.hpp"
+#include "GzipSettings.hpp"
+#include "HttpStatusCode.hpp"
+#include "HeaderMap.hpp"
+
+// A piece of a multipart body: inline bytes, then a region of a file
+struct BodyPart
+{
+	std::string data{};
+	FileBody file{};
+};
 
 struct ResponseData
 {
@@ -12,40 +26,73 @@ struct ResponseData
 	
 	int statusCode{200};
 	std::string statusText{"OK"};
-	std::unordered_map<std::string, std::string> headers{};
+	HeaderMap headers{};
 	std::string body{};
+	FileBody file{}; // instead of body, for static files
+	// Shared with the response cache: the fixed part of the headers,
+	// ending with the empty line, and the body
+	std::shared_ptr<const std::string> cachedHeaders{};
+	std::shared_ptr<const std::string> cachedBody{};
+	std::vector<BodyPart> parts{}; // sent after everything else
+	std::shared_ptr<BodyStream> stream{}; // instead of file, when compressed
+	GzipSettings gzip{}; // if the client takes gzip, for CGI output
 	
 	size_t fileSize{0};
 	bool shouldClose{false};
 
-	void addHeader(const std::string& key, const std::string& value)
+	void addHeader(std::string_view key, const std::string& value)
 	{
 		headers[key] = value;
 	}
 
-	bool hasHeader(const std::string& key) const
+	bool hasHeader(std::string_view key) const
 	{
-		return headers.find(key) != headers.end();
+		return headers.count(key) != 0;
 	}
 
-	std::string getHeader(const std::string& key) const
+	const std::string& getHeader(std::string_view key) const
 	{
-		auto it = headers.find(key);
-		return it != headers.end() ? it->second : "";
+		return headers.get(key);
 	}
 
-	std::string serialize() const
+	// Status line and headers, the body is sent from its own buffer.
+	// Sized up front, so the pieces are copied in without reallocating.
+	std::string serializeHead() const
 	{
-		std::string str = "HTTP/1.1 " + std::to_string(statusCode) + " "
-						  + statusText + "\r\n";
-		for (std::unordered_map<std::string, std::string>::const_iterator it
-			 = headers.begin();
-			 it != headers.end(); ++it)
-			str += it->first + ": " + it->second + "\r\n";
-		str += "\r\n";
-		str += body;
+		std::string_view line = statusLine(static_cast<HttpStatusCode>(statusCode));
+		std::string fallback;
+		if (line.empty())
+		{
+			fallback = "HTTP/1.1 " + std::to_string(statusCode) + " "
+					   + statusText + "\r\n";
+			line = fallback;
+		}
+
+		size_t size = line.size() + (cachedHeaders ? cachedHeaders->size() : 2);
+		for (const auto& header : headers)
+			size += header.first.size() + header.second.size() + 4;
+
+		std::string str;
+		str.reserve(size);
+		str.append(line);
+		for (const auto& header : headers)
+		{
+			str.append(header.first);
+			str.append(": ", 2);
+			str.append(header.second);
+			str.append("\r\n", 2);
+		}
+		if (cachedHeaders)
+			str.append(*cachedHeaders);
+		else
+			str.append("\r\n", 2);
 		return str;
 	}
+
+	std::string serialize() const
+	{
+		return serializeHead() + (cachedBody ? *cachedBody : body);
+	}
 };
 
 #endif
\ No newline at end of file
@@ -3,15 +3,24 @@
 namespace ResponseGenerator
 {
 
-void genResponse(const RawRequest& rawReq, const RequestContext& ctx,
+void genResponse(RawRequest& rawReq, const RequestContext& ctx,
 				 RawResponse& rawResp, CgiRequestResult& cgiResult)
 {
 	setConnectionHeader(rawReq, rawResp);
 
+	if (rawReq.isBodyTooLarge())
+		return handlePayloadTooLarge(ctx, rawResp);
+
+	if (rawReq.isServerError())
+		return handleServerError(ctx, rawResp);
+
 	if (rawReq.isBadRequest())
 		return handleBadRequest(ctx, rawResp);
 
-	const RequestData req = rawReq.buildRequestData();
+	RequestData req = rawReq.takeRequestData();
+
+	if (acceptsGzip(req, ctx))
+		rawResp.setGzip(ctx.gzip);
 
 	if (ctx.redirection.isSet)
 		return handleExternalRedirect(ctx, req.uri, rawResp);
@@ -32,6 +41,22 @@ void genResponse(const RawRequest& rawReq, const RequestContext& ctx,
 	}
 }
 
+// Whether genResponse would hand the request to the UploadModule, known
+// from the headers alone
+bool isUpload(HttpMethod method, const std::string& uri,
+			  const RequestContext& ctx)
+{
+	if (method != HttpMethod::POST || ctx.redirection.isSet
+		|| !isMethodAllowed(method, ctx.allowed_methods))
+		return false;
+
+	const std::string ext = FileUtils::getFileExtension(uri);
+	if (!ctx.cgi_pass.empty() && ctx.cgi_pass.count(ext))
+		return false;
+
+	return !ctx.upload_store.empty();
+}
+
 bool isMethodAllowed(HttpMethod method,
 					 const std::vector<HttpMethod>& allowed_methods)
 {
@@ -59,20 +84,20 @@ void addAllowHeader(RawResponse& rawResp,
 	rawResp.addHeader("Allow", allowed);
 }
 
-void processGet(const RequestData& req, const RequestContext& ctx,
+void processGet(RequestData& req, const RequestContext& ctx,
 				RawResponse& rawResp, CgiRequestResult& cgiResult)
 {
 	const std::string ext = FileUtils::getFileExtension(req.uri);
 	if (!ctx.cgi_pass.empty() && ctx.cgi_pass.count(ext))
 		return handleCGI(req, ctx, rawResp, cgiResult, ext);
 
-	const FileInfo path = FileUtils::getFileInfo(ctx.resolved_path);
+	const FileInfo path = OpenFileCache::local().stat(ctx.resolved_path);
 
 	if (path.exists && path.isFile)
-		return handleStaticFile(ctx, rawResp, path);
+		return handleStaticFile(req, ctx, rawResp, path);
 
 	if (path.exists && path.isDir)
-		return handleDirectory(ctx, rawResp);
+		return handleDirectory(req, ctx, rawResp);
 
 	handleNotFound(ctx, rawResp);
 }
@@ -90,6 +115,8 @@ void processDelete(const RequestContext& ctx, RawResponse& rawResp)
 	try
 	{
 		FileUtils::deleteFile(ctx.resolved_path);
+		OpenFileCache::local().invalidate(ctx.resolved_path);
+		ResponseCache::local().invalidate(ctx.resolved_path);
 		rawResp.setStatusCode(HttpStatusCode::NoContent);
 	}
 	catch (const std::exception& e)
@@ -98,7 +125,7 @@ void processDelete(const RequestContext& ctx, RawResponse& rawResp)
 	}
 }
 
-void processPost(const RequestData& req, const RequestContext& ctx,
+void processPost(RequestData& req, const RequestContext& ctx,
 				 RawResponse& rawResp, CgiRequestResult& cgiResult)
 {
 	if (ctx.client_max_body_size != 0
@@ -126,13 +153,34 @@ void processPost(const RequestData& req, const RequestContext& ctx,
 	}
 }
 
-void fillSuccessfulResponse(RawResponse& resp, const std::string& filePath)
+void fillSuccessfulResponse(RawResponse& resp, const std::string& filePath,
+							const FileInfo& file, const std::string& mimeType)
 {
-	const std::string body = FileReader::readFile(filePath);
-	resp.setBody(body);
-	resp.addHeader("Content-Length", std::to_string(body.size()));
-	resp.setMimeType(FileUtils::detectMimeType(filePath));
 	resp.setStatusCode(HttpStatusCode::OK);
+	addValidators(resp, file);
+	resp.addHeader("Accept-Ranges", "bytes");
+
+	// Compressed on the way out, the cache would only be in the way
+	const bool compressed = resp.gzip().enabled && resp.gzip().compresses(mimeType);
+
+	ResponseCache& cache = ResponseCache::local();
+	const CachedResponse* cached = compressed ? nullptr : cache.lookup(filePath, file);
+	if (cached)
+		return resp.setCachedBody(*cached);
+
+	const FileBody body = OpenFileCache::local().open(filePath);
+
+	if (cache.enabled() && !compressed)
+	{
+		const std::string headers = "Server: " + resp.header("Server")
+			+ "\r\nContent-Type: " + mimeType + "\r\nContent-Length: "
+			+ std::to_string(body.length) + "\r\n\r\n";
+		if (const CachedResponse* cached = cache.insert(filePath, body, file, headers))
+			return resp.setCachedBody(*cached);
+	}
+
+	resp.setFileBody(body);
+	resp.setMimeType(mimeType);
 }
 
 void fillAutoindexResponse(RawResponse& resp, const std::string& dirPath)
@@ -163,20 +211,57 @@ void handleExternalRedirect(const RequestContext& ctx,
 	}
 }
 
-void handleStaticFile(const RequestContext& ctx, RawResponse& rawResp,
-					  const FileInfo& file)
+void handleStaticFile(const RequestData& req, const RequestContext& ctx,
+					  RawResponse& rawResp, const FileInfo& file)
 {
 	if (!file.readable)
 		return handleNoPermission(ctx, rawResp);
 
-	serveStaticFile(ctx, rawResp);
+	serveFile(req, ctx, rawResp, ctx.resolved_path, file);
 }
 
-void serveStaticFile(const RequestContext& ctx, RawResponse& rawResp)
+// The file is already known to be there and readable
+void serveFile(const RequestData& req, const RequestContext& ctx,
+			   RawResponse& rawResp, const std::string& path,
+			   const FileInfo& file)
 {
+	// A precompressed sibling keeps the type of the original
+	const std::string mimeType = FileUtils::detectMimeType(path);
+	std::string sentPath = path;
+	FileInfo sent = file;
+	std::string encoding;
+	if (ctx.gzip_static != GzipStatic::Off)
+		encoding = selectPrecompressed(req, ctx, rawResp, sentPath, sent);
+
+	// On-the-fly gzip depends on Accept-Encoding, and a 304 must carry
+	// the validator of the variant the 200 would have been
+	bool gzipped = false;
+	if (encoding.empty() && ctx.gzip.appliesTo(mimeType, sent.size))
+	{
+		rawResp.addHeader("Vary", "Accept-Encoding");
+		gzipped = rawResp.gzip().appliesTo(mimeType, sent.size);
+	}
+
+	if (isNotModified(req, sent))
+		return handleNotModified(rawResp, sent, gzipped);
+
 	try
 	{
-		fillSuccessfulResponse(rawResp, ctx.resolved_path);
+		std::vector<ByteRange> ranges;
+		ByteRanges::Result result = ByteRanges::Result::Ignored;
+		if (isRangeApplicable(req, sent))
+			result = ByteRanges::parse(req.getHeader("Range"), sent.size, ranges);
+
+		if (result == ByteRanges::Result::Unsatisfiable)
+			return handleRangeNotSatisfiable(ctx, rawResp, sent);
+		if (result == ByteRanges::Result::Satisfiable)
+			fillPartialResponse(rawResp, sentPath, sent, mimeType, ranges);
+		else
+			fillSuccessfulResponse(rawResp, sentPath, sent, mimeType);
+
+		// Not before: an error page isn't encoded
+		if (!encoding.empty())
+			rawResp.addHeader("Content-Encoding", encoding);
 	}
 	catch (const std::exception& e)
 	{
@@ -184,12 +269,230 @@ void serveStaticFile(const RequestContext& ctx, RawResponse& rawResp)
 	}
 }
 
-void handleDirectory(const RequestContext& ctx, RawResponse& rawResp)
+// Same validators as nginx, plus the inode: a file replaced by another
+// one of the same size within the same second still gets a new tag
+std::string makeETag(const FileInfo& file)
+{
+	std::ostringstream oss;
+	oss << std::hex << '"' << file.inode << '-' << file.size << '-'
+		<< file.mtime.tv_sec << '.' << file.mtime.tv_nsec << '"';
+	return oss.str();
+}
+
+// RFC 7232, 6: If-None-Match wins over If-Modified-Since
+bool isNotModified(const RequestData& req, const FileInfo& file)
+{
+	const std::string ifNoneMatch = req.getHeader("If-None-Match");
+	if (!ifNoneMatch.empty())
+		return etagListMatches(ifNoneMatch, makeETag(file));
+
+	std::time_t since;
+	const std::string ifModifiedSince = req.getHeader("If-Modified-Since");
+	if (ifModifiedSince.empty() || !HttpDate::parse(ifModifiedSince, since))
+		return false;
+
+	return file.mtime.tv_sec <= since;
+}
+
+// Weak comparison: "W/" prefixes are ignored
+bool etagListMatches(const std::string& list, const std::string& etag)
+{
+	std::istringstream stream(list);
+	std::string tag;
+	while (std::getline(stream, tag, ','))
+	{
+		StrUtils::trimLeadingWhitespace(tag);
+		tag.erase(tag.find_last_not_of(" \t") + 1);
+		if (tag == "*")
+			return true;
+		if (tag.compare(0, 2, "W/") == 0)
+			tag.erase(0, 2);
+		if (tag == etag)
+			return true;
+	}
+	return false;
+}
+
+void addValidators(RawResponse& rawResp, const FileInfo& file)
+{
+	rawResp.addHeader("ETag", makeETag(file));
+	rawResp.addHeader("Last-Modified", HttpDate::format(file.mtime.tv_sec));
+}
+
+// The file is neither opened nor read. The ETag is weak when the 200
+// would have been compressed, as RawResponse::compressBody makes it
+void handleNotModified(RawResponse& rawResp, const FileInfo& file,
+					   bool gzipped)
+{
+	rawResp.setStatusCode(HttpStatusCode::NotModified);
+	if (gzipped)
+		rawResp.addHeader("ETag", "W/" + makeETag(file));
+	addValidators(rawResp, file);
+}
+
+// gzip_static: a precompressed sibling is sent in place of the file if
+// the client accepts its encoding. The lookups go through the open file
+// cache, missing siblings included with open_file_cache_errors on.
+// Returns the encoding of the sibling, empty to send the file itself.
+std::string selectPrecompressed(const RequestData& req, const RequestContext& ctx,
+						 RawResponse& rawResp, std::string& path,
+						 FileInfo& file)
+{
+	struct Precompressed
+	{
+		const char* encoding;
+		const char* suffix;
+	};
+	static const Precompressed siblings[] = {{"br", ".br"}, {"gzip", ".gz"}};
+
+	const std::string acceptEncoding = req.getHeader("Accept-Encoding");
+	bool hasSibling = false;
+
+	for (const Precompressed& sibling : siblings)
+	{
+		const std::string siblingPath = path + sibling.suffix;
+		const FileInfo info = OpenFileCache::local().stat(siblingPath);
+		if (!(info.exists && info.isFile && info.readable))
+			continue;
+		hasSibling = true;
+
+		bool always = ctx.gzip_static == GzipStatic::Always
+					  && std::string(sibling.encoding) == "gzip";
+		if (!always && !acceptsEncoding(acceptEncoding, sibling.encoding))
+			continue;
+
+		rawResp.addHeader("Vary", "Accept-Encoding");
+		path = siblingPath;
+		file = info;
+		return sibling.encoding;
+	}
+
+	// The answer depends on Accept-Encoding as soon as there is a choice
+	if (hasSibling)
+		rawResp.addHeader("Vary", "Accept-Encoding");
+	return "";
+}
+
+// gzip: chunked bodies need HTTP/1.1
+bool acceptsGzip(const RequestData& req, const RequestContext& ctx)
+{
+	return ctx.gzip.enabled && req.httpVersion != "HTTP/1.0"
+		   && acceptsEncoding(req.getHeader("Accept-Encoding"), "gzip");
+}
+
+// RFC 7231, 5.3.4: a coding is acceptable if listed, or covered by '*',
+// with a non-zero q-value
+bool acceptsEncoding(const std::string& header, const std::string& encoding)
+{
+	std::istringstream stream(header);
+	std::string item;
+	bool wildcard = false;
+
+	while (std::getline(stream, item, ','))
+	{
+		std::string name = item.substr(0, item.find(';'));
+		StrUtils::trimLeadingWhitespace(name);
+		name.erase(name.find_last_not_of(" \t") + 1);
+
+		bool rejected = false;
+		size_t q = item.find("q=");
+		if (q != std::string::npos)
+			rejected = std::strtod(item.c_str() + q + 2, nullptr) <= 0.0;
+
+		if (StrUtils::equalsIgnoreCase(name, encoding))
+			return !rejected;
+		if (name == "*")
+			wildcard = !rejected;
+	}
+	return wildcard;
+}
+
+// If-Range (RFC 7233, 3.2): the range only applies to the version the
+// client already has part of, otherwise the whole file is sent
+bool isRangeApplicable(const RequestData& req, const FileInfo& file)
+{
+	if (req.getHeader("Range").empty())
+		return false;
+
+	const std::string ifRange = req.getHeader("If-Range");
+	if (ifRange.empty())
+		return true;
+
+	if (ifRange[0] == '"')
+		return ifRange == makeETag(file);
+
+	std::time_t date;
+	return HttpDate::parse(ifRange, date) && date == file.mtime.tv_sec;
+}
+
+// Only the requested regions are sent, straight from the file
+void fillPartialResponse(RawResponse& resp, const std::string& filePath,
+						 const FileInfo& file, const std::string& mimeType,
+						 const std::vector<ByteRange>& ranges)
+{
+	resp.setStatusCode(HttpStatusCode::PartialContent);
+	addValidators(resp, file);
+	resp.addHeader("Accept-Ranges", "bytes");
+
+	const FileBody whole = OpenFileCache::local().open(filePath);
+
+	std::vector<BodyPart> parts;
+	for (const ByteRange& range : ranges)
+	{
+		BodyPart part;
+		part.file = whole;
+		part.file.offset = range.first;
+		part.file.length = range.length();
+		parts.push_back(part);
+	}
+
+	if (parts.size() == 1)
+	{
+		resp.addHeader("Content-Range", contentRange(ranges[0], file.size));
+		resp.setFileBody(parts[0].file);
+		resp.setMimeType(mimeType);
+		return;
+	}
+
+	// Numbered like nginx does
+	static thread_local unsigned long boundaryNumber = 0;
+	std::ostringstream boundary;
+	boundary << std::setfill('0') << std::setw(20) << ++boundaryNumber;
+
+	for (size_t i = 0; i < parts.size(); ++i)
+		parts[i].data = "\r\n--" + boundary.str() + "\r\nContent-Type: " + mimeType
+			+ "\r\nContent-Range: " + contentRange(ranges[i], file.size)
+			+ "\r\n\r\n";
+	BodyPart closing;
+	closing.data = "\r\n--" + boundary.str() + "--\r\n";
+	parts.push_back(closing);
+
+	resp.setMultipartBody(parts, boundary.str());
+}
+
+void handleRangeNotSatisfiable(const RequestContext& ctx, RawResponse& rawResp,
+							   const FileInfo& file)
+{
+	rawResp.addErrorDetails(ctx, HttpStatusCode::RangeNotSatisfiable);
+	rawResp.addHeader("Content-Range", "bytes */" + std::to_string(file.size));
+}
+
+std::string contentRange(const ByteRange& range, off_t size)
+{
+	return "bytes " + std::to_string(range.first) + "-"
+		+ std::to_string(range.last) + "/" + std::to_string(size);
+}
+
+void handleDirectory(const RequestData& req, const RequestContext& ctx,
+					 RawResponse& rawResp)
 {
 	std::string indexFilePath
 		= FileUtils::getFirstValidIndexFile(ctx.resolved_path, ctx.index_files);
 	if (!indexFilePath.empty())
-		return serveIndexFile(indexFilePath, ctx, rawResp);
+	{
+		const FileInfo index = OpenFileCache::local().stat(indexFilePath);
+		return serveFile(req, ctx, rawResp, indexFilePath, index);
+	}
 
 	if (ctx.autoindex_enabled)
 		return generateAutoIndex(ctx, rawResp);
@@ -233,19 +536,6 @@ void handleBadGateway(const RequestContext& ctx, RawResponse& rawResp)
 	rawResp.addErrorDetails(ctx, HttpStatusCode::BadGateway);
 }
 
-void serveIndexFile(const std::string& indexPath, const RequestContext& ctx,
-					RawResponse& rawResp)
-{
-	try
-	{
-		fillSuccessfulResponse(rawResp, indexPath);
-	}
-	catch (const std::exception& e)
-	{
-		handleServerError(ctx, rawResp);
-	}
-}
-
 void generateAutoIndex(const RequestContext& ctx, RawResponse& rawResp)
 {
 	try
@@ -267,7 +557,7 @@ void setConnectionHeader(const RawRequest& rawReq, RawResponse& rawResp)
 		rawResp.addHeader("Connection", "keep-alive");
 }
 
-void handleCGI(const RequestData& req, const RequestContext& ctx,
+void handleCGI(RequestData& req, const RequestContext& ctx,
 			   RawResponse& rawResp, CgiRequestResult& cgiResult,
 			   const std::string& ext)
 {
@@ -286,7 +576,7 @@ void handleCGI(const RequestData& req, const RequestContext& ctx,
 	cgiResult.spawnCgi = true;
 	cgiResult.cgiInterpreter = interpreter;
 	cgiResult.cgiScriptPath = requestedScript;
-	cgiResult.requestData = req;
+	cgiResult.requestData = std::move(req);
 }
 
 HttpStatusCode checkScriptValidity(const std::string& scriptPath)
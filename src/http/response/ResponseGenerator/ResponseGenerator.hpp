@@ -15,18 +15,28 @@
 #include "Client.hpp"
 #include "CgiRequestResult.hpp"
 #include "FileReader.hpp"
+#include "OpenFileCache.hpp"
+#include "ResponseCache.hpp"
+#include "HttpDate.hpp"
+#include "ByteRange.hpp"
 #include "debug.hpp"
 
 namespace ResponseGenerator
 {
     // Main entry point
     void genResponse(
-        const RawRequest& rawReq,
+        RawRequest& rawReq, // its body is moved out
         const RequestContext& ctx,
         RawResponse& rawResp,
         CgiRequestResult& cgiResult
     );
 
+	bool isUpload(
+		HttpMethod method,
+		const std::string& uri,
+		const RequestContext& ctx
+	);
+
 	bool isMethodAllowed(
 		HttpMethod method,
 		const std::vector<HttpMethod>& allowed_methods
@@ -38,14 +48,14 @@ namespace ResponseGenerator
     );
 
     void processGet(
-        const RequestData& req,
+        RequestData& req,
         const RequestContext& ctx,
         RawResponse& resp,
         CgiRequestResult& cgiResult
     );
 
     void processPost(
-        const RequestData& req,
+        RequestData& req,
         const RequestContext& ctx,
         RawResponse& resp,
         CgiRequestResult& cgiResult
@@ -70,7 +80,9 @@ namespace ResponseGenerator
 
 	void fillSuccessfulResponse(
 		RawResponse& resp,
-		const std::string& filePath
+		const std::string& filePath,
+		const FileInfo& file,
+		const std::string& mimeType
 	);
 
 	void fillAutoindexResponse(
@@ -90,17 +102,44 @@ namespace ResponseGenerator
     void handleMethodNotAllowed(const RequestContext& ctx, RawResponse& rawResp);
 
     // Static file
-    void handleStaticFile(const RequestContext& ctx, RawResponse& rawResp, const FileInfo& file);
-    void serveStaticFile(const RequestContext& ctx, RawResponse& rawResp);
+    void handleStaticFile(const RequestData& req, const RequestContext& ctx,
+                          RawResponse& rawResp, const FileInfo& file);
+    void serveFile(const RequestData& req, const RequestContext& ctx,
+                   RawResponse& rawResp, const std::string& path,
+                   const FileInfo& file);
+
+    // Conditional requests
+    std::string makeETag(const FileInfo& file);
+    bool isNotModified(const RequestData& req, const FileInfo& file);
+    bool etagListMatches(const std::string& list, const std::string& etag);
+    void addValidators(RawResponse& rawResp, const FileInfo& file);
+    void handleNotModified(RawResponse& rawResp, const FileInfo& file,
+                           bool gzipped);
+
+    // Precompressed files
+    std::string selectPrecompressed(const RequestData& req,
+                                    const RequestContext& ctx,
+                                    RawResponse& rawResp, std::string& path,
+                                    FileInfo& file);
+    bool acceptsEncoding(const std::string& header, const std::string& encoding);
+    bool acceptsGzip(const RequestData& req, const RequestContext& ctx);
+
+    // Range requests
+    bool isRangeApplicable(const RequestData& req, const FileInfo& file);
+    void fillPartialResponse(RawResponse& resp, const std::string& filePath,
+                             const FileInfo& file, const std::string& mimeType,
+                             const std::vector<ByteRange>& ranges);
+    void handleRangeNotSatisfiable(const RequestContext& ctx,
+                                   RawResponse& rawResp, const FileInfo& file);
+    std::string contentRange(const ByteRange& range, off_t size);
     
     // Directory
-    void handleDirectory(const RequestContext& ctx, RawResponse& rawResp);
-    void serveIndexFile(const std::string& indexPath, const RequestContext& ctx,
-                        RawResponse& rawResp);
+    void handleDirectory(const RequestData& req, const RequestContext& ctx,
+                         RawResponse& rawResp);
     void generateAutoIndex(const RequestContext& ctx, RawResponse& rawResp);
 
     // CGI
-    void handleCGI(const RequestData& req, const RequestContext& ctx,
+    void handleCGI(RequestData& req, const RequestContext& ctx,
                RawResponse& rawResp, CgiRequestResult& cgiResult, const std::string& ext);
 
     HttpStatusCode checkScriptValidity(const std::string& scriptPath);
@@ -0,0 +1,102 @@
+#include "ByteRange.hpp"
+
+namespace ByteRanges
+{
+	static bool parseOffset(const std::string& str, off_t& out)
+	{
+		if (str.empty() || str.find_first_not_of("0123456789") != std::string::npos)
+			return false;
+
+		errno = 0;
+		char* end;
+		unsigned long long value = std::strtoull(str.c_str(), &end, 10);
+		if (errno == ERANGE || value > static_cast<unsigned long long>(INT64_MAX))
+			return false;
+		out = static_cast<off_t>(value);
+		return true;
+	}
+
+	static std::string trim(const std::string& str)
+	{
+		size_t first = str.find_first_not_of(" \t");
+		if (first == std::string::npos)
+			return "";
+		return str.substr(first, str.find_last_not_of(" \t") - first + 1);
+	}
+
+	/**
+	* @brief Parses a "bytes=" Range header (RFC 7233, 2.1).
+	*
+	* Specs that start past the end of the file are dropped; if none is
+	* left the range is unsatisfiable. A syntax error anywhere makes the
+	* whole header ignored.
+	*
+	* @param header The value of the Range header.
+	* @param size The size of the file.
+	* @param out The satisfiable ranges, clamped to the file.
+	*/
+	Result parse(const std::string& header, off_t size,
+				 std::vector<ByteRange>& out)
+	{
+		out.clear();
+
+		const std::string unit = "bytes=";
+		if (header.compare(0, unit.size(), unit) != 0)
+			return Result::Ignored;
+
+		size_t count = 0;
+		size_t start = unit.size();
+		while (start <= header.size())
+		{
+			size_t comma = header.find(',', start);
+			if (comma == std::string::npos)
+				comma = header.size();
+			const std::string spec = trim(header.substr(start, comma - start));
+			start = comma + 1;
+
+			if (spec.empty())
+				continue;
+			if (++count > MAX_RANGES)
+				return Result::Ignored;
+
+			size_t dash = spec.find('-');
+			if (dash == std::string::npos)
+				return Result::Ignored;
+			const std::string firstStr = spec.substr(0, dash);
+			const std::string lastStr = spec.substr(dash + 1);
+
+			ByteRange range;
+			if (firstStr.empty())
+			{
+				// "-n": the last n bytes
+				off_t suffix;
+				if (!parseOffset(lastStr, suffix))
+					return Result::Ignored;
+				if (suffix == 0 || size == 0)
+					continue;
+				range.first = suffix < size ? size - suffix : 0;
+				range.last = size - 1;
+			}
+			else
+			{
+				if (!parseOffset(firstStr, range.first))
+					return Result::Ignored;
+				range.last = size - 1;
+				if (!lastStr.empty())
+				{
+					if (!parseOffset(lastStr, range.last) || range.last < range.first)
+						return Result::Ignored;
+					if (range.last >= size)
+						range.last = size - 1;
+				}
+				if (range.first >= size)
+					continue;
+			}
+			out.push_back(range);
+		}
+
+		if (count == 0)
+			return Result::Ignored;
+		return out.empty() ? Result::Unsatisfiable : Result::Satisfiable;
+	}
+}
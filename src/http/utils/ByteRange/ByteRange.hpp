@@ -0,0 +1,37 @@
+#ifndef BYTERANGE_HPP
+#define BYTERANGE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdint>
+#include <sys/types.h>
+
+// One range of a Range header, resolved against the file size
+struct ByteRange
+{
+	off_t first;
+	off_t last; // inclusive
+
+	size_t length() const { return static_cast<size_t>(last - first + 1); }
+};
+
+namespace ByteRanges
+{
+	// More ranges than that and the header is ignored, so that a client
+	// can't make a small request expand into a huge multipart response
+	constexpr size_t MAX_RANGES = 16;
+
+	enum class Result
+	{
+		Ignored,       // no header, another unit, or malformed: send it all
+		Satisfiable,   // 206
+		Unsatisfiable  // 416
+	};
+
+	Result parse(const std::string& header, off_t size,
+				 std::vector<ByteRange>& out);
+}
+
+#endif
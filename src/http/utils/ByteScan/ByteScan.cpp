@@ -0,0 +1,310 @@
+#include "ByteScan.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+# define BYTESCAN_X86
+# include <immintrin.h>
+#endif
+
+namespace ByteScan
+{
+	// Each kernel looks at [p, p + n) and returns an offset into it
+	struct Kernels
+	{
+		size_t (*findNeedle)(const char* p, size_t n, const char* needle, size_t k);
+		size_t (*findHeaderEnd)(const char* p, size_t n);
+		size_t (*findControl)(const char* p, size_t n);
+	};
+
+	static size_t shifted(size_t base, size_t offset)
+	{
+		return offset == npos ? npos : base + offset;
+	}
+
+	static bool isControl(unsigned char c)
+	{
+		return (c < 0x20 && c != '\t') || c == 0x7f;
+	}
+
+	// ---------------------------SCALAR-----------------------------
+
+	// Also what every level uses for single bytes: memchr is vectorized
+	// by the C library already, with its own runtime dispatch
+	static size_t findByteScalar(const char* p, size_t n, char c)
+	{
+		const void* hit = std::memchr(p, c, n);
+		return hit ? static_cast<const char*>(hit) - p : npos;
+	}
+
+	static size_t findNeedleScalar(const char* p, size_t n, const char* needle, size_t k)
+	{
+		return std::string_view(p, n).find(std::string_view(needle, k));
+	}
+
+	static size_t findHeaderEndScalar(const char* p, size_t n)
+	{
+		for (size_t i = 0; i + 4 <= n; ++i)
+		{
+			size_t cr = findByteScalar(p + i, n - i, '\r');
+			if (cr == npos)
+				return npos;
+			i += cr;
+			if (i + 4 <= n && std::memcmp(p + i, "\r\n\r\n", 4) == 0)
+				return i;
+		}
+		return npos;
+	}
+
+	static size_t findControlScalar(const char* p, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+			if (isControl(p[i]))
+				return i;
+		return npos;
+	}
+
+#ifdef BYTESCAN_X86
+	// ---------------------------SSE2-----------------------------
+
+	static __m128i load16(const char* p)
+	{
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	}
+
+	// Candidates match the first and the last byte of the needle,
+	// only those are compared in full
+	static size_t findNeedleSse2(const char* p, size_t n, const char* needle, size_t k)
+	{
+		const __m128i first = _mm_set1_epi8(needle[0]);
+		const __m128i last = _mm_set1_epi8(needle[k - 1]);
+		size_t i = 0;
+		for (; i + k - 1 + 16 <= n; i += 16)
+		{
+			unsigned mask = _mm_movemask_epi8(_mm_and_si128(
+				_mm_cmpeq_epi8(load16(p + i), first),
+				_mm_cmpeq_epi8(load16(p + i + k - 1), last)));
+			for (; mask; mask &= mask - 1)
+			{
+				size_t at = i + __builtin_ctz(mask);
+				if (std::memcmp(p + at + 1, needle + 1, k - 2) == 0)
+					return at;
+			}
+		}
+		return shifted(i, findNeedleScalar(p + i, n - i, needle, k));
+	}
+
+	static size_t findHeaderEndSse2(const char* p, size_t n)
+	{
+		const __m128i cr = _mm_set1_epi8('\r');
+		const __m128i lf = _mm_set1_epi8('\n');
+		size_t i = 0;
+		for (; i + 3 + 16 <= n; i += 16)
+		{
+			__m128i hits = _mm_and_si128(
+				_mm_and_si128(_mm_cmpeq_epi8(load16(p + i), cr),
+							  _mm_cmpeq_epi8(load16(p + i + 1), lf)),
+				_mm_and_si128(_mm_cmpeq_epi8(load16(p + i + 2), cr),
+							  _mm_cmpeq_epi8(load16(p + i + 3), lf)));
+			unsigned mask = _mm_movemask_epi8(hits);
+			if (mask)
+				return i + __builtin_ctz(mask);
+		}
+		return shifted(i, findHeaderEndScalar(p + i, n - i));
+	}
+
+	// Bytes up to 0x1f are those left unchanged by an unsigned min with it
+	static size_t findControlSse2(const char* p, size_t n)
+	{
+		const __m128i low = _mm_set1_epi8(0x1f);
+		const __m128i tab = _mm_set1_epi8('\t');
+		const __m128i del = _mm_set1_epi8(0x7f);
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+		{
+			__m128i v = load16(p + i);
+			__m128i hits = _mm_or_si128(
+				_mm_andnot_si128(_mm_cmpeq_epi8(v, tab),
+								 _mm_cmpeq_epi8(_mm_min_epu8(v, low), v)),
+				_mm_cmpeq_epi8(v, del));
+			unsigned mask = _mm_movemask_epi8(hits);
+			if (mask)
+				return i + __builtin_ctz(mask);
+		}
+		return shifted(i, findControlScalar(p + i, n - i));
+	}
+
+	// ---------------------------AVX2-----------------------------
+
+# define AVX2 __attribute__((target("avx2")))
+
+	AVX2 static __m256i load32(const char* p)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+	}
+
+	AVX2 static size_t findNeedleAvx2(const char* p, size_t n, const char* needle, size_t k)
+	{
+		const __m256i first = _mm256_set1_epi8(needle[0]);
+		const __m256i last = _mm256_set1_epi8(needle[k - 1]);
+		size_t i = 0;
+		for (; i + k - 1 + 32 <= n; i += 32)
+		{
+			unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(
+				_mm256_cmpeq_epi8(load32(p + i), first),
+				_mm256_cmpeq_epi8(load32(p + i + k - 1), last)));
+			for (; mask; mask &= mask - 1)
+			{
+				size_t at = i + __builtin_ctz(mask);
+				if (std::memcmp(p + at + 1, needle + 1, k - 2) == 0)
+					return at;
+			}
+		}
+		return shifted(i, findNeedleSse2(p + i, n - i, needle, k));
+	}
+
+	AVX2 static size_t findHeaderEndAvx2(const char* p, size_t n)
+	{
+		const __m256i cr = _mm256_set1_epi8('\r');
+		const __m256i lf = _mm256_set1_epi8('\n');
+		size_t i = 0;
+		for (; i + 3 + 32 <= n; i += 32)
+		{
+			__m256i hits = _mm256_and_si256(
+				_mm256_and_si256(_mm256_cmpeq_epi8(load32(p + i), cr),
+								 _mm256_cmpeq_epi8(load32(p + i + 1), lf)),
+				_mm256_and_si256(_mm256_cmpeq_epi8(load32(p + i + 2), cr),
+								 _mm256_cmpeq_epi8(load32(p + i + 3), lf)));
+			unsigned mask = _mm256_movemask_epi8(hits);
+			if (mask)
+				return i + __builtin_ctz(mask);
+		}
+		return shifted(i, findHeaderEndSse2(p + i, n - i));
+	}
+
+	AVX2 static size_t findControlAvx2(const char* p, size_t n)
+	{
+		const __m256i low = _mm256_set1_epi8(0x1f);
+		const __m256i tab = _mm256_set1_epi8('\t');
+		const __m256i del = _mm256_set1_epi8(0x7f);
+		size_t i = 0;
+		for (; i + 32 <= n; i += 32)
+		{
+			__m256i v = load32(p + i);
+			__m256i hits = _mm256_or_si256(
+				_mm256_andnot_si256(_mm256_cmpeq_epi8(v, tab),
+									_mm256_cmpeq_epi8(_mm256_min_epu8(v, low), v)),
+				_mm256_cmpeq_epi8(v, del));
+			unsigned mask = _mm256_movemask_epi8(hits);
+			if (mask)
+				return i + __builtin_ctz(mask);
+		}
+		return shifted(i, findControlSse2(p + i, n - i));
+	}
+
+# undef AVX2
+#endif
+
+	// ---------------------------DISPATCH-----------------------------
+
+	struct Active
+	{
+		Level level;
+		Kernels kernels;
+	};
+
+	static Kernels kernelsFor(Level level)
+	{
+		switch (level)
+		{
+#ifdef BYTESCAN_X86
+			case Level::Avx2:
+				return {findNeedleAvx2, findHeaderEndAvx2, findControlAvx2};
+			case Level::Sse2:
+				return {findNeedleSse2, findHeaderEndSse2, findControlSse2};
+#endif
+			default:
+				return {findNeedleScalar, findHeaderEndScalar, findControlScalar};
+		}
+	}
+
+	static Active& active()
+	{
+		static Active current{supportedLevels().back(),
+							  kernelsFor(supportedLevels().back())};
+		return current;
+	}
+
+	// ---------------------------SCANS-----------------------------
+
+	size_t find(std::string_view data, char c, size_t from)
+	{
+		if (from >= data.size())
+			return npos;
+		return shifted(from, findByteScalar(data.data() + from, data.size() - from, c));
+	}
+
+	size_t find(std::string_view data, std::string_view needle, size_t from)
+	{
+		if (needle.size() < 2)
+			return needle.empty() ? (from <= data.size() ? from : npos)
+								  : find(data, needle[0], from);
+		if (from >= data.size())
+			return npos;
+		return shifted(from, active().kernels.findNeedle(data.data() + from,
+			data.size() - from, needle.data(), needle.size()));
+	}
+
+	size_t findHeaderEnd(std::string_view data, size_t from)
+	{
+		if (from >= data.size())
+			return npos;
+		return shifted(from, active().kernels.findHeaderEnd(data.data() + from,
+															data.size() - from));
+	}
+
+	size_t findControl(std::string_view data, size_t from)
+	{
+		if (from >= data.size())
+			return npos;
+		return shifted(from, active().kernels.findControl(data.data() + from,
+														  data.size() - from));
+	}
+
+	// ---------------------------LEVELS-----------------------------
+
+	Level level()
+	{
+		return active().level;
+	}
+
+	// From the narrowest to the widest
+	std::vector<Level> supportedLevels()
+	{
+		std::vector<Level> levels{Level::Scalar};
+#ifdef BYTESCAN_X86
+		levels.push_back(Level::Sse2);
+		if (__builtin_cpu_supports("avx2"))
+			levels.push_back(Level::Avx2);
+#endif
+		return levels;
+	}
+
+	// Clamped to what the CPU supports
+	void setLevel(Level level)
+	{
+		level = std::min(level, supportedLevels().back());
+		active() = {level, kernelsFor(level)};
+	}
+
+	const char* levelName(Level level)
+	{
+		switch (level)
+		{
+			case Level::Avx2: return "avx2";
+			case Level::Sse2: return "sse2";
+			default: return "scalar";
+		}
+	}
+}
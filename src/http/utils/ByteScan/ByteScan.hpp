@@ -0,0 +1,36 @@
+#ifndef BYTESCAN_HPP
+#define BYTESCAN_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Scans over request bytes, 16 (SSE2) or 32 (AVX2) bytes at a time.
+// The widest kernel the CPU supports is picked on first use; other
+// architectures get the scalar one. Single bytes are left to memchr.
+// All scans return the position of the first match at or after 'from',
+// or npos.
+namespace ByteScan
+{
+	constexpr size_t npos = std::string_view::npos;
+
+	enum class Level
+	{
+		Scalar,
+		Sse2,
+		Avx2
+	};
+
+	size_t find(std::string_view data, char c, size_t from = 0);
+	size_t find(std::string_view data, std::string_view needle, size_t from = 0);
+	size_t findHeaderEnd(std::string_view data, size_t from = 0); // "\r\n\r\n"
+	size_t findControl(std::string_view data, size_t from = 0); // CTL but HTAB
+
+	// For tests and benchmarks: not thread safe
+	Level level();
+	std::vector<Level> supportedLevels();
+	void setLevel(Level level);
+	const char* levelName(Level level);
+}
+
+#endif
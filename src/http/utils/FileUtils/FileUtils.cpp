@@ -1,4 +1,5 @@
 #include "FileUtils.hpp"
+#include "OpenFileCache.hpp"
 
 namespace FileUtils
 {
@@ -17,6 +18,11 @@ namespace FileUtils
         info.readable   = (s.st_mode & S_IRUSR);
         info.writable   = (s.st_mode & S_IWUSR);
         info.executable = (s.st_mode & S_IXUSR);
+
+        info.device = s.st_dev;
+        info.inode = s.st_ino;
+        info.size  = s.st_size;
+        info.mtime = s.st_mtim;
     
         return info;
     }
@@ -36,7 +42,7 @@ namespace FileUtils
 		for (const auto& file : indexFiles)
 		{
 			std::string path = dir + file;
-            const FileInfo info = getFileInfo(path);
+            const FileInfo info = OpenFileCache::local().stat(path);
             if (info.exists && info.isFile && info.readable)
                 return path;
 		}
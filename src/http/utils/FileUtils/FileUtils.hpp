@@ -23,6 +23,11 @@ struct FileInfo
 	bool readable;
 	bool writable;
 	bool executable;
+	// Validators for conditional requests
+	dev_t device;
+	ino_t inode;
+	off_t size;
+	timespec mtime;
 };
 
 namespace FileUtils
@@ -0,0 +1,59 @@
+#include "HttpDate.hpp"
+
+namespace HttpDate
+{
+	static const char* const FORMAT = "%a, %d %b %Y %H:%M:%S GMT";
+
+	// One per reactor thread, refreshed by its event loop
+	static thread_local std::time_t t_cachedTime = -1;
+	static thread_local std::string t_cached;
+
+	std::string format(std::time_t time)
+	{
+		std::tm gmt;
+		gmtime_r(&time, &gmt);
+
+		char buf[64];
+		size_t len = std::strftime(buf, sizeof(buf), FORMAT, &gmt);
+		return std::string(buf, len);
+	}
+
+	/**
+	* @brief The current date, formatted at most once per second.
+	*
+	* Before the first refresh() the date is formatted on the spot.
+	*/
+	const std::string& cached()
+	{
+		if (t_cachedTime == -1)
+			refresh(std::time(nullptr));
+		return t_cached;
+	}
+
+	// Called by the event loop on every wakeup, cheap within a second
+	void refresh(std::time_t now)
+	{
+		if (now == t_cachedTime)
+			return;
+		t_cachedTime = now;
+		t_cached = format(now);
+	}
+
+	/**
+	* @brief Parses an IMF-fixdate.
+	*
+	* @param str The date, as found in a header.
+	* @param out Seconds since the epoch, set on success.
+	* @return False if the date is malformed; the header must be ignored then.
+	*/
+	bool parse(const std::string& str, std::time_t& out)
+	{
+		std::tm gmt{};
+		const char* end = strptime(str.c_str(), FORMAT, &gmt);
+		if (!end || *end != '\0')
+			return false;
+
+		out = timegm(&gmt);
+		return out != static_cast<std::time_t>(-1);
+	}
+}
@@ -0,0 +1,16 @@
+#ifndef HTTPDATE_HPP
+#define HTTPDATE_HPP
+
+#include <ctime>
+#include <string>
+
+// Dates in the IMF-fixdate form of RFC 7231: "Sun, 06 Nov 1994 08:49:37 GMT"
+namespace HttpDate
+{
+	std::string format(std::time_t time);
+	const std::string& cached();
+	void refresh(std::time_t now);
+	bool parse(const std::string& str, std::time_t& out);
+}
+
+#endif
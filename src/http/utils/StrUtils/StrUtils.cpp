@@ -10,7 +10,7 @@ namespace StrUtils
     * @param b Second string to compare.
     * @return True if the strings are equal ignoring case; false otherwise.
     */
-	bool equalsIgnoreCase(const std::string& a, const std::string& b)
+	bool equalsIgnoreCase(std::string_view a, std::string_view b)
 	{
 		if (a.size() != b.size()) return false;
 		for (size_t i = 0; i < a.size(); ++i)
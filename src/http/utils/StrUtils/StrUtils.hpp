@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <string_view>
 
 #include "RawRequest.hpp"
 #include "RawResponse.hpp"
@@ -13,7 +14,7 @@
 
 namespace StrUtils
 {
-	bool equalsIgnoreCase(const std::string& a, const std::string& b);
+	bool equalsIgnoreCase(std::string_view a, std::string_view b);
 	void removeCarriageReturns(std::string& str);
 	void trimLeadingWhitespace(std::string& str);
 }
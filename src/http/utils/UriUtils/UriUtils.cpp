@@ -10,12 +10,16 @@ namespace UriUtils
 		// Fully decode percent-encoded sequences first
 		std::string decoded = fullyDecodePercent(rawUri);
 
-		std::vector<std::string> stack;
-		std::istringstream iss(decoded);
-		std::string segment;
+		// Segments are views into 'decoded'
+		std::vector<std::string_view> stack;
+		const std::string_view path(decoded);
 
-		while (std::getline(iss, segment, '/'))
+		for (size_t pos = 0; pos < path.size();)
 		{
+			size_t slash = std::min(ByteScan::find(path, '/', pos), path.size());
+			std::string_view segment = path.substr(pos, slash - pos);
+			pos = slash + 1;
+
 			if (segment.empty() || segment == ".")
 				continue;
 
@@ -35,43 +39,52 @@ namespace UriUtils
 		}
 
 		// Rebuild normalized path
-		std::ostringstream oss;
-		oss << "/";
+		std::string normalized;
+		normalized.reserve(decoded.size() + 1);
+		normalized += '/';
 		for (size_t i = 0; i < stack.size(); ++i)
 		{
-			oss << stack[i];
+			normalized.append(stack[i]);
 			if (i + 1 < stack.size())
-				oss << "/";
+				normalized += '/';
 		}
 
 		// Preserve trailing slash if original URI had it
 		if (rawUri.size() > 1 && rawUri.back() == '/' && !stack.empty())
-			oss << "/";
+			normalized += '/';
 
-		DBG("[normalizePath] normalized path: " << oss.str());
-		return oss.str();
+		DBG("[normalizePath] normalized path: " << normalized);
+		return normalized;
 	}
 	
+	// Copies the runs between escapes in one go
 	std::string decodePercentOnce(const std::string& s)
 	{
 		std::string out;
 		out.reserve(s.size());
 
-		for (size_t i = 0; i < s.size(); ++i)
+		size_t i = 0;
+		while (true)
 		{
-			if (s[i] == '%' && i + 2 < s.size() && isHex(s[i + 1]) && isHex(s[i + 2]))
+			size_t pct = ByteScan::find(s, '%', i);
+			if (pct == ByteScan::npos)
+			{
+				out.append(s, i, std::string::npos);
+				return out;
+			}
+			out.append(s, i, pct - i);
+
+			if (pct + 2 < s.size() && isHex(s[pct + 1]) && isHex(s[pct + 2]))
 			{
-				std::string hex = s.substr(i + 1, 2);
-				char decoded = static_cast<char>(std::strtol(hex.c_str(), NULL, 16));
-				out += decoded;
-				i += 2;
+				out += static_cast<char>(hexValue(s[pct + 1]) * 16 + hexValue(s[pct + 2]));
+				i = pct + 3;
 			}
 			else
 			{
-				out += s[i];
+				out += '%';
+				i = pct + 1;
 			}
 		}
-		return out;
 	}
 	
 	std::string fullyDecodePercent(const std::string& rawUri)
@@ -80,7 +93,7 @@ namespace UriUtils
 		const int MAX_DECODE_PASSES = 4;
 		int passes = 0;
 
-		while (decoded.find('%') != std::string::npos && passes < MAX_DECODE_PASSES)
+		while (ByteScan::find(decoded, '%') != ByteScan::npos && passes < MAX_DECODE_PASSES)
 		{
 			std::string once = decodePercentOnce(decoded);
 			if (once == decoded)
@@ -89,7 +102,7 @@ namespace UriUtils
 			++passes;
 		}
 
-		if (decoded.find('%') != std::string::npos)
+		if (ByteScan::find(decoded, '%') != ByteScan::npos)
 			throw std::runtime_error("Bad request: invalid percent-encoding or too many nested encodings");
 
 		return decoded;
@@ -101,4 +114,13 @@ namespace UriUtils
 		   (c >= 'A' && c <= 'F') ||
 		   (c >= 'a' && c <= 'f');
 	}
+
+	int hexValue(char c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if (c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		return c - 'A' + 10;
+	}
 }
\ No newline at end of file
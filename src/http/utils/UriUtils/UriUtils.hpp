@@ -2,6 +2,8 @@
 #define URIUTILS_HPP
 
 #include <string>
+#include <string_view>
+#include <algorithm>
 #include <stdexcept>
 #include <cctype>
 #include <sstream>
@@ -9,6 +11,7 @@
 #include <vector>
 #include <cstdlib> // for std::strtol
 
+#include "ByteScan.hpp"
 #include "debug.hpp"
 
 namespace UriUtils
@@ -23,6 +26,7 @@ namespace UriUtils
     std::string fullyDecodePercent(const std::string& s);
 	
 	bool isHex(char c);
+	int hexValue(char c); // of a hex digit
 }
 
 #endif
\ No newline at end of file
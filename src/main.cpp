@@ -1,13 +1,18 @@
 #include <iostream>
 #include <string.h>
 #include "Server.hpp"
+#include "ReactorPool.hpp"
+#include "MasterProcess.hpp"
 #include "Config.hpp"
 
 bool validateArgumentsCount(int argc, char** argv);
 bool initializeConfig(Config& config, const char* filepath);
 void setupSignalHandlers();
 
-volatile std::sig_atomic_t g_running = false;
+// Read by every reactor and cleared from any thread, lock-free so the
+// signal handler may still set it
+std::atomic<bool> g_running{false};
+static_assert(std::atomic<bool>::is_always_lock_free);
 
 void stopServer(int)
 {
@@ -25,26 +30,24 @@ int main(int argc, char** argv)
     if (!initializeConfig(config, filepath))
         return EXIT_FAILURE;
 
+    g_running = true;
     setupSignalHandlers();
-    while (true)
+    try
     {
-        try
-        {
-            Server s(config);
-            s.run();
-        }
-        catch (const std::runtime_error& e)
+        if (config.workerProcesses() > 0)
         {
-            std::cerr << "Error: " << e.what() << ": " << strerror(errno)
-                      << "\n";
+            MasterProcess master(config, config.workerProcesses());
+            master.run();
         }
-        catch (const std::exception& e)
+        else
         {
-            std::cerr << "Error: " << e.what() << "\n";
+            ReactorPool pool(config, config.workerThreads());
+            pool.run();
         }
-
-        if (!g_running)
-            break;
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "Error: " << e.what() << ": " << strerror(errno) << "\n";
     }
     return EXIT_FAILURE;
 }
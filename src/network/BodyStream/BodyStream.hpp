@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef BODYSTREAM_HPP
+# define BODYSTREAM_HPP
+
+# include <string>
+
+// A body that is produced while it is sent, when its length isn't known
+// in advance. What it produces is ready to go on the wire as it is
+// (already chunk-framed, for instance).
+class BodyStream
+{
+    // Construction and destruction
+  public:
+    BodyStream() = default;
+    BodyStream(const BodyStream& other) = delete;
+    BodyStream& operator=(const BodyStream& other) = delete;
+    virtual ~BodyStream() = default;
+
+    // Class specific features
+  public:
+    // Accessors
+    virtual bool finished() const = 0;
+    // Methods
+    // Produces the next bytes into 'out', at least one unless the
+    // stream just finished. False on error, errno is set then
+    virtual bool next(std::string& out) = 0;
+};
+
+#endif
@@ -2,29 +2,28 @@
 #include <stdexcept>
 #include <iostream>
 #include <arpa/inet.h> // inet_ntoa
+#include <cstring>
+#include <sys/socket.h>
 
-Client::Client(int fd, int epoll_fd, const sockaddr_in& addr,
-               const NetworkEndpoint& listeningEndpoint)
+Client::Client(int fd, const NetworkEndpoint& listeningEndpoint)
   : socket_fd(fd)
-  , epoll_fd(epoll_fd)
-  , address(addr)
+  , address()
   , listeningEndpoint(listeningEndpoint)
   , _shouldClose(false)
-  , out_buffer("")
 {
     if (fd < 0)
         throw std::invalid_argument("Invalid socket descriptor");
-    updateLastActivity();
 }
 
 Client::Client(Client&& other) noexcept
   : socket_fd(other.socket_fd)
-  , epoll_fd(other.epoll_fd)
   , address(other.address)
+  , address_known(other.address_known)
   , listeningEndpoint(std::move(other.listeningEndpoint))
   , _shouldClose(other._shouldClose)
-  , out_buffer(std::move(other.out_buffer))
-  , lastActivity(other.lastActivity)
+  , out_queue(std::move(other.out_queue))
+  , timeout_timer(other.timeout_timer)
+  , timeout_phase(other.timeout_phase)
 {
     other.socket_fd = -1;
 }
@@ -34,12 +33,13 @@ Client& Client::operator=(Client&& other) noexcept
     if (this != &other)
     {
         socket_fd = other.socket_fd;
-        epoll_fd = other.epoll_fd;
         address = other.address;
+        address_known = other.address_known;
         listeningEndpoint = std::move(other.listeningEndpoint);
         _shouldClose = other._shouldClose;
-        out_buffer = std::move(other.out_buffer);
-        lastActivity = other.lastActivity;
+        out_queue = std::move(other.out_queue);
+        timeout_timer = other.timeout_timer;
+        timeout_phase = other.timeout_phase;
 
         other.socket_fd = -1;
     }
@@ -57,39 +57,44 @@ int Client::socket() const
     return socket_fd;
 }
 
-int Client::getEpollFd() const
-{
-    return epoll_fd;
-}
-
 const NetworkEndpoint& Client::getListeningEndpoint() const
 {
     return listeningEndpoint;
 }
 
+// Only CGIs need the peer address, and a connection accepted by
+// io_uring comes without it
 const sockaddr_in& Client::getAddress() const
 {
+    if (!address_known)
+    {
+        socklen_t len = sizeof(address);
+        if (getpeername(socket_fd, reinterpret_cast<sockaddr*>(&address),
+                        &len) == -1)
+            std::memset(&address, 0, sizeof(address));
+        address_known = true;
+    }
     return address;
 }
 
-std::string& Client::outBuffer()
+OutputQueue& Client::output()
 {
-    return out_buffer;
+    return out_queue;
 }
 
-void Client::appendToOutBuffer(const std::string& data)
+TimerNode& Client::timer()
 {
-    out_buffer += data;
+    return timeout_timer;
 }
 
-void Client::updateLastActivity()
+Client::TimeoutPhase Client::timeoutPhase() const
 {
-    lastActivity = std::chrono::steady_clock::now();
+    return timeout_phase;
 }
 
-bool Client::isTimedOut(std::chrono::seconds timeout) const
+void Client::setTimeoutPhase(TimeoutPhase phase)
 {
-    return (std::chrono::steady_clock::now() - lastActivity) > timeout;
+    timeout_phase = phase;
 }
 
 void Client::setShouldClose(bool shouldClose)
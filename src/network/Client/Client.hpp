@@ -8,14 +8,24 @@
 # include <netinet/in.h>
 # include <unistd.h>
 # include <iostream>
-# include <chrono>
 # include "NetworkEndpoint.hpp"
+# include "TimerWheel.hpp"
+# include "OutputQueue.hpp"
 
 class Client
 {
   public:
-    Client(int fd, int epoll_fd, const sockaddr_in& addr,
-           const NetworkEndpoint& listeningEndpoint);
+    // Which timeout the connection is waiting under
+    enum class TimeoutPhase
+    {
+        None,
+        Header,
+        Body,
+        Send,
+        Keepalive
+    };
+
+    Client(int fd, const NetworkEndpoint& listeningEndpoint);
     ~Client();
     // Move semantics
     Client(Client&& other) noexcept;
@@ -26,15 +36,14 @@ class Client
 
     // Accessors
     int socket() const;
-    int getEpollFd() const;
-    const sockaddr_in& getAddress() const;
+    const sockaddr_in& getAddress() const; // looked up on first use
     const NetworkEndpoint& getListeningEndpoint() const;
-    std::string& outBuffer();
+    OutputQueue& output();
+    TimerNode& timer();
+    TimeoutPhase timeoutPhase() const;
 
     // Methods
-    void appendToOutBuffer(const std::string& data);
-    void updateLastActivity();
-    bool isTimedOut(std::chrono::seconds timeout) const;
+    void setTimeoutPhase(TimeoutPhase phase);
 
     void setShouldClose(bool shouldClose);
     bool shouldClose() const;
@@ -42,12 +51,13 @@ class Client
   private:
     // Properties
     int socket_fd = -1;
-    int epoll_fd = -1;
-    sockaddr_in address;
+    mutable sockaddr_in address;
+    mutable bool address_known = false;
     NetworkEndpoint listeningEndpoint;
     bool _shouldClose;
-    std::string out_buffer;
-    std::chrono::steady_clock::time_point lastActivity;
+    OutputQueue out_queue;
+    TimerNode timeout_timer;
+    TimeoutPhase timeout_phase = TimeoutPhase::None;
 };
 
 #endif
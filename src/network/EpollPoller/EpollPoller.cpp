@@ -0,0 +1,44 @@
+#include "EpollPoller.hpp"
+
+// -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
+
+EpollPoller::EpollPoller()
+{
+    m_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epfd == -1)
+        throw std::runtime_error("epoll_create");
+}
+
+EpollPoller::~EpollPoller()
+{
+    if (m_epfd != -1)
+        close(m_epfd);
+}
+
+// ---------------------------METHODS-----------------------------
+
+int EpollPoller::add(int fd, uint32_t events)
+{
+    t_event e;
+    e.data.fd = fd;
+    e.events = events;
+    return epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &e);
+}
+
+int EpollPoller::modify(int fd, uint32_t events)
+{
+    t_event e;
+    e.data.fd = fd;
+    e.events = events;
+    return epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &e);
+}
+
+int EpollPoller::remove(int fd)
+{
+    return epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int EpollPoller::wait(t_event* events, int maxEvents, int timeoutMs)
+{
+    return epoll_wait(m_epfd, events, maxEvents, timeoutMs);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef EPOLLPOLLER_HPP
+# define EPOLLPOLLER_HPP
+
+# include <stdexcept>
+# include <sys/epoll.h>
+# include <unistd.h>
+
+# include "Poller.hpp"
+
+class EpollPoller : public Poller
+{
+    // Construction and destruction
+  public:
+    EpollPoller();
+    EpollPoller(const EpollPoller& other) = delete;
+    EpollPoller& operator=(const EpollPoller& other) = delete;
+    EpollPoller(EpollPoller&& other) noexcept = delete;
+    EpollPoller& operator=(EpollPoller&& other) noexcept = delete;
+    ~EpollPoller();
+
+    // Class specific features
+  public:
+    // Methods
+    int add(int fd, uint32_t events) override;
+    int modify(int fd, uint32_t events) override;
+    int remove(int fd) override;
+    int wait(t_event* events, int maxEvents, int timeoutMs) override;
+
+  private:
+    // Properties
+    int m_epfd = -1; // event poll fd
+};
+
+#endif
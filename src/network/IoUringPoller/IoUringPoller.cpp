@@ -0,0 +1,477 @@
+#include "IoUringPoller.hpp"
+
+#ifdef WEBSERV_HAS_IO_URING
+
+// -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
+
+IoUringPoller::IoUringPoller()
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    m_ringfd = syscall(__NR_io_uring_setup, QUEUE_DEPTH, &params);
+    if (m_ringfd == -1)
+        throw std::runtime_error(std::string("io_uring_setup: ")
+                                 + strerror(errno));
+
+    // EXT_ARG (5.11) is needed for waiting with a timeout, RSRC_TAGS
+    // came with poll updates (5.13), NODROP keeps completions that
+    // don't fit in the ring
+    if (!(params.features & IORING_FEAT_EXT_ARG)
+        || !(params.features & IORING_FEAT_RSRC_TAGS)
+        || !(params.features & IORING_FEAT_NODROP))
+    {
+        close(m_ringfd);
+        throw std::runtime_error("kernel is too old");
+    }
+
+    try
+    {
+        mapRings(params);
+    }
+    catch (...)
+    {
+        unmapRings();
+        close(m_ringfd);
+        throw;
+    }
+}
+
+IoUringPoller::~IoUringPoller()
+{
+    for (auto& it : m_accepted)
+        closeAccepted(it.second);
+    unmapRings();
+    if (m_ringfd != -1)
+        close(m_ringfd);
+}
+
+// ---------------------------METHODS-----------------------------
+
+int IoUringPoller::add(int fd, uint32_t events)
+{
+    if (m_registrations.count(fd))
+    {
+        errno = EEXIST;
+        return -1;
+    }
+
+    Registration& reg = m_registrations[fd];
+    reg.events = events;
+    reg.generation = m_nextGeneration++;
+    reg.armed = false;
+    reg.accepting = false;
+    pollAdd(fd, reg);
+    return 0;
+}
+
+int IoUringPoller::modify(int fd, uint32_t events)
+{
+    auto it = m_registrations.find(fd);
+    if (it == m_registrations.end())
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    Registration& reg = it->second;
+    bool changed = reg.events != events;
+    reg.events = events;
+    if (reg.accepting)
+        return 0;
+    if (!reg.armed)
+        pollAdd(fd, reg);
+    else if (changed)
+        pollUpdate(fd, reg);
+    return 0;
+}
+
+int IoUringPoller::remove(int fd)
+{
+    auto it = m_registrations.find(fd);
+    if (it == m_registrations.end())
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    Registration& reg = it->second;
+    if (reg.armed && reg.accepting)
+        acceptCancel(reg, fd);
+    else if (reg.armed)
+        pollRemove(reg, fd);
+    m_registrations.erase(it);
+
+    auto accepted = m_accepted.find(fd);
+    if (accepted != m_accepted.end())
+    {
+        closeAccepted(accepted->second);
+        m_accepted.erase(accepted);
+    }
+    return 0;
+}
+
+int IoUringPoller::wait(t_event* events, int maxEvents, int timeoutMs)
+{
+    for (int fd : m_rearm)
+    {
+        auto it = m_registrations.find(fd);
+        if (it == m_registrations.end() || it->second.armed)
+            continue;
+        if (it->second.accepting)
+            acceptAdd(fd, it->second);
+        else
+            pollAdd(fd, it->second);
+    }
+    m_rearm.clear();
+
+    unsigned minComplete
+        = (timeoutMs == 0 || hasCompletions() || hasAccepted()) ? 0 : 1;
+    if (pendingSubmissions() > 0 || minComplete > 0)
+    {
+        int ret = enter(minComplete, timeoutMs);
+        if (ret == -1 && errno != ETIME && errno != EBUSY && errno != EAGAIN)
+            return -1;
+    }
+
+    unsigned head = *m_cqHead;
+    unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    int count = 0;
+
+    for (; head != tail && count < maxEvents; ++head)
+    {
+        const io_uring_cqe& cqe = m_cqes[head & *m_cqMask];
+        if (cqe.user_data == REMOVE_TAG)
+            continue;
+
+        int fd = static_cast<int>(cqe.user_data & (ACCEPT_TAG - 1));
+        uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 32);
+        bool isAccept = cqe.user_data & ACCEPT_TAG;
+
+        // Completion of a request that was removed since; a connection
+        // it accepted has no one to go to
+        auto it = m_registrations.find(fd);
+        if (it == m_registrations.end() || it->second.generation != generation)
+        {
+            if (isAccept && cqe.res >= 0)
+                close(cqe.res);
+            continue;
+        }
+
+        Registration& reg = it->second;
+        if (!(cqe.flags & IORING_CQE_F_MORE))
+            reg.armed = false;
+
+        if (isAccept)
+        {
+            onAccept(fd, reg, cqe.res);
+            continue;
+        }
+
+        // A failing poll is reported once and not re-armed
+        // so it can't keep the loop spinning
+        if (cqe.res < 0)
+        {
+            events[count].events = EPOLLERR;
+            events[count].data.fd = fd;
+            ++count;
+            continue;
+        }
+
+        if (!reg.armed)
+            m_rearm.push_back(fd);
+
+        events[count].events = static_cast<uint32_t>(cqe.res);
+        events[count].data.fd = fd;
+        ++count;
+    }
+
+    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+
+    // Listeners are reported as long as they have connections,
+    // like a level-triggered accept queue
+    for (auto& it : m_accepted)
+    {
+        if (count == maxEvents)
+            break;
+        if (it.second.empty())
+            continue;
+        events[count].events = EPOLLIN;
+        events[count].data.fd = it.first;
+        ++count;
+    }
+    return count;
+}
+
+int IoUringPoller::addListener(int fd, uint32_t events)
+{
+#ifdef IORING_ACCEPT_MULTISHOT
+    if (m_registrations.count(fd))
+    {
+        errno = EEXIST;
+        return -1;
+    }
+
+    Registration& reg = m_registrations[fd];
+    reg.events = events;
+    reg.generation = m_nextGeneration++;
+    reg.armed = false;
+    reg.accepting = true;
+    m_accepted[fd];
+    acceptAdd(fd, reg);
+    return 0;
+#else
+    return Poller::addListener(fd, events);
+#endif
+}
+
+int IoUringPoller::acceptClient(int listenFd)
+{
+    auto it = m_accepted.find(listenFd);
+    if (it == m_accepted.end() || it->second.empty())
+    {
+        auto reg = m_registrations.find(listenFd);
+        if (reg != m_registrations.end() && reg->second.accepting)
+        {
+            errno = EAGAIN;
+            return -1;
+        }
+        return Poller::acceptClient(listenFd);
+    }
+
+    int res = it->second.front();
+    it->second.pop_front();
+    if (res < 0)
+    {
+        errno = -res;
+        return -1;
+    }
+    return res;
+}
+
+void IoUringPoller::mapRings(const io_uring_params& params)
+{
+    m_sqEntries = params.sq_entries;
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingSize
+        = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap)
+    {
+        m_sqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+        m_cqRingSize = 0;
+    }
+
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, m_ringfd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED)
+        throw std::runtime_error("mmap sq ring");
+
+    if (singleMmap)
+        m_cqRing = m_sqRing;
+    else
+    {
+        m_cqRing
+            = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, m_ringfd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED)
+            throw std::runtime_error("mmap cq ring");
+    }
+
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, m_ringfd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        throw std::runtime_error("mmap sqes");
+    m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(m_sqRing);
+    m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    char* cq = static_cast<char*>(m_cqRing);
+    m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+void IoUringPoller::unmapRings()
+{
+    if (m_sqes != MAP_FAILED)
+        munmap(m_sqes, m_sqesSize);
+    if (m_cqRing != MAP_FAILED && m_cqRing != m_sqRing)
+        munmap(m_cqRing, m_cqRingSize);
+    if (m_sqRing != MAP_FAILED)
+        munmap(m_sqRing, m_sqRingSize);
+
+    m_sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    m_cqRing = MAP_FAILED;
+    m_sqRing = MAP_FAILED;
+}
+
+// Submits what is queued when the ring is full
+io_uring_sqe* IoUringPoller::nextSqe()
+{
+    while (pendingSubmissions() >= m_sqEntries)
+        if (enter(0, 0) == -1 && errno != EINTR && errno != EBUSY
+            && errno != EAGAIN)
+            throw std::runtime_error("io_uring_enter");
+
+    unsigned tail = *m_sqTail;
+    unsigned index = tail & *m_sqMask;
+
+    io_uring_sqe* sqe = &m_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    m_sqArray[index] = index;
+    __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+void IoUringPoller::pollAdd(int fd, Registration& reg)
+{
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = pollMask(reg.events);
+    if (reg.events & EPOLLET)
+        sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = userData(fd, reg.generation);
+    reg.armed = true;
+}
+
+// Changes the events of the armed poll, which keeps its user_data.
+// If it completes first, the update fails and the poll is armed again
+// with the new events on the next wait
+void IoUringPoller::pollUpdate(int fd, const Registration& reg)
+{
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = userData(fd, reg.generation);
+    sqe->poll32_events = pollMask(reg.events);
+    sqe->len = IORING_POLL_UPDATE_EVENTS;
+    if (reg.events & EPOLLET)
+        sqe->len |= IORING_POLL_ADD_MULTI;
+    sqe->user_data = REMOVE_TAG;
+}
+
+void IoUringPoller::pollRemove(Registration& reg, int fd)
+{
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = userData(fd, reg.generation);
+    sqe->user_data = REMOVE_TAG;
+    reg.armed = false;
+}
+
+void IoUringPoller::acceptAdd(int fd, Registration& reg)
+{
+#ifdef IORING_ACCEPT_MULTISHOT
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = userData(fd, reg.generation) | ACCEPT_TAG;
+    reg.armed = true;
+#else
+    (void)fd;
+    (void)reg;
+#endif
+}
+
+void IoUringPoller::acceptCancel(Registration& reg, int fd)
+{
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = userData(fd, reg.generation) | ACCEPT_TAG;
+    sqe->user_data = REMOVE_TAG;
+    reg.armed = false;
+}
+
+// A multishot accept ends on an error, and when the completion ring
+// overflows; it's submitted again on the next wait. The error is
+// handed to acceptClient, as accept4 would have returned it
+void IoUringPoller::onAccept(int fd, Registration& reg, int res)
+{
+    if (res == -EINVAL && !reg.armed)
+    {
+        // Multishot accept isn't supported, poll the listener instead
+        reg.accepting = false;
+        m_rearm.push_back(fd);
+        return;
+    }
+
+    m_accepted[fd].push_back(res);
+    if (!reg.armed)
+        m_rearm.push_back(fd);
+}
+
+void IoUringPoller::closeAccepted(std::deque<int>& accepted)
+{
+    for (int fd : accepted)
+        if (fd >= 0)
+            close(fd);
+    accepted.clear();
+}
+
+bool IoUringPoller::hasAccepted() const
+{
+    for (const auto& it : m_accepted)
+        if (!it.second.empty())
+            return true;
+    return false;
+}
+
+uint32_t IoUringPoller::pollMask(uint32_t events)
+{
+    return events & ~(EPOLLET | EPOLLEXCLUSIVE);
+}
+
+int IoUringPoller::enter(unsigned minComplete, int timeoutMs)
+{
+    unsigned flags = 0;
+    if (minComplete > 0)
+        flags |= IORING_ENTER_GETEVENTS;
+
+    io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof(arg));
+    __kernel_timespec ts;
+    if (minComplete > 0 && timeoutMs > 0)
+    {
+        ts.tv_sec = timeoutMs / 1000;
+        ts.tv_nsec = (timeoutMs % 1000) * 1000000L;
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+        flags |= IORING_ENTER_EXT_ARG;
+    }
+
+    void* argp = (flags & IORING_ENTER_EXT_ARG) ? &arg : nullptr;
+    size_t argsz = (flags & IORING_ENTER_EXT_ARG) ? sizeof(arg) : 0;
+
+    return syscall(__NR_io_uring_enter, m_ringfd, pendingSubmissions(),
+                   minComplete, flags, argp, argsz);
+}
+
+unsigned IoUringPoller::pendingSubmissions() const
+{
+    return *m_sqTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+}
+
+bool IoUringPoller::hasCompletions() const
+{
+    return *m_cqHead != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+}
+
+uint64_t IoUringPoller::userData(int fd, uint32_t generation)
+{
+    return (static_cast<uint64_t>(generation) << 32)
+         | static_cast<uint32_t>(fd);
+}
+
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+
+#ifndef IOURINGPOLLER_HPP
+# define IOURINGPOLLER_HPP
+
+# if __has_include(<linux/io_uring.h>) && !defined(WEBSERV_NO_IO_URING)
+#  define WEBSERV_HAS_IO_URING
+# endif
+
+# ifdef WEBSERV_HAS_IO_URING
+
+#  include <algorithm>
+#  include <cerrno>
+#  include <cstring>
+#  include <ctime>
+#  include <deque>
+#  include <stdexcept>
+#  include <unordered_map>
+#  include <vector>
+#  include <linux/io_uring.h>
+#  include <signal.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+#  include "Poller.hpp"
+
+// Poller on top of io_uring poll requests, talking to the kernel through
+// the raw syscalls. Registrations are queued in the submission ring and
+// handed to the kernel together with the wait, so add/modify/remove cost
+// no syscall of their own. A modify updates the armed poll in place.
+// EPOLLET registrations become multishot polls, the others one-shot polls
+// that are re-armed on the next wait, which gives level-triggered results.
+// Listening sockets get a multishot accept (5.19): the kernel accepts the
+// connections and acceptClient hands them out without a syscall. Older
+// kernels reject it, and the listener is polled instead.
+class IoUringPoller : public Poller
+{
+    // Construction and destruction
+  public:
+    IoUringPoller();
+    IoUringPoller(const IoUringPoller& other) = delete;
+    IoUringPoller& operator=(const IoUringPoller& other) = delete;
+    IoUringPoller(IoUringPoller&& other) noexcept = delete;
+    IoUringPoller& operator=(IoUringPoller&& other) noexcept = delete;
+    ~IoUringPoller();
+
+    // Class specific features
+  public:
+    // Constants
+    static constexpr unsigned QUEUE_DEPTH = 1024;
+    // Methods
+    int add(int fd, uint32_t events) override;
+    int modify(int fd, uint32_t events) override;
+    int remove(int fd) override;
+    int wait(t_event* events, int maxEvents, int timeoutMs) override;
+    int addListener(int fd, uint32_t events) override;
+    int acceptClient(int listenFd) override;
+
+  private:
+    // Types
+    struct Registration
+    {
+        uint32_t events;
+        uint32_t generation; // tells completions of older polls apart
+        bool armed;
+        bool accepting; // multishot accept instead of a poll
+    };
+    // Constants
+    static constexpr uint64_t REMOVE_TAG = ~0ULL; // removals and updates
+    static constexpr uint64_t ACCEPT_TAG = 1ULL << 31; // fds are positive
+    // Properties
+    int m_ringfd = -1;
+    void* m_sqRing = MAP_FAILED;
+    void* m_cqRing = MAP_FAILED;
+    size_t m_sqRingSize = 0;
+    size_t m_cqRingSize = 0;
+    io_uring_sqe* m_sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t m_sqesSize = 0;
+    unsigned m_sqEntries = 0;
+    unsigned* m_sqHead = nullptr;
+    unsigned* m_sqTail = nullptr;
+    unsigned* m_sqMask = nullptr;
+    unsigned* m_sqArray = nullptr;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned* m_cqMask = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+    uint32_t m_nextGeneration = 1;
+    std::unordered_map<int, Registration> m_registrations;
+    std::vector<int> m_rearm; // one-shot polls that fired since last wait
+    // Connections accepted per listener, -errno for a failed accept
+    std::unordered_map<int, std::deque<int>> m_accepted;
+    // Methods
+    void mapRings(const io_uring_params& params);
+    void unmapRings();
+    io_uring_sqe* nextSqe();
+    void pollAdd(int fd, Registration& reg);
+    void pollUpdate(int fd, const Registration& reg);
+    void pollRemove(Registration& reg, int fd);
+    void acceptAdd(int fd, Registration& reg);
+    void acceptCancel(Registration& reg, int fd);
+    void onAccept(int fd, Registration& reg, int res);
+    void closeAccepted(std::deque<int>& accepted);
+    bool hasAccepted() const;
+    static uint32_t pollMask(uint32_t events);
+    int enter(unsigned minComplete, int timeoutMs);
+    unsigned pendingSubmissions() const;
+    bool hasCompletions() const;
+    static uint64_t userData(int fd, uint32_t generation);
+};
+
+# endif
+
+#endif
@@ -0,0 +1,142 @@
+#include "MasterProcess.hpp"
+
+static void onChildExited(int) {}
+
+// -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
+
+MasterProcess::MasterProcess(const Config& config, size_t workersCount)
+  : m_config(config)
+  , m_workersCount(workersCount == 0 ? 1 : workersCount)
+{
+    sigemptyset(&m_previousMask);
+}
+
+MasterProcess::~MasterProcess()
+{
+    stopWorkers();
+}
+
+// ---------------------------METHODS-----------------------------
+
+void MasterProcess::run()
+{
+    bindListeners();
+    blockSignals();
+
+    for (size_t i = 0; i < m_workersCount; ++i)
+        spawnWorker();
+
+    // Signals stay blocked outside of sigsuspend,
+    // so none of them can slip in between the check and the wait
+    while (g_running)
+    {
+        reapWorkers();
+        if (g_running)
+            sigsuspend(&m_previousMask);
+    }
+
+    stopWorkers();
+    sigprocmask(SIG_SETMASK, &m_previousMask, nullptr);
+}
+
+void MasterProcess::bindListeners()
+{
+    std::vector<NetworkEndpoint> endpoints = m_config.getAllEndpoints();
+    for (const auto& endpoint : endpoints)
+        m_listeners.emplace_back(endpoint, QUEUE_SIZE);
+}
+
+void MasterProcess::blockSignals()
+{
+    std::signal(SIGCHLD, onChildExited);
+
+    sigset_t blocked;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGCHLD);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    sigprocmask(SIG_BLOCK, &blocked, &m_previousMask);
+}
+
+void MasterProcess::spawnWorker()
+{
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        std::cerr << "[Master] fork failed: " << strerror(errno) << "\n";
+        return;
+    }
+
+    if (pid == 0)
+    {
+        runWorker();
+        std::exit(EXIT_SUCCESS);
+    }
+
+    m_workers[pid] = std::time(nullptr);
+}
+
+void MasterProcess::runWorker()
+{
+    // The siblings belong to the master, not to this copy of it
+    m_workers.clear();
+
+    std::signal(SIGCHLD, SIG_DFL);
+    sigprocmask(SIG_SETMASK, &m_previousMask, nullptr);
+
+    try
+    {
+        ReactorPool pool(m_config, m_config.workerThreads(), m_listeners);
+        pool.run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+void MasterProcess::reapWorkers()
+{
+    int status;
+    pid_t pid;
+
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+    {
+        auto it = m_workers.find(pid);
+        if (it == m_workers.end())
+            continue;
+
+        time_t startTime = it->second;
+        m_workers.erase(it);
+
+        if (!g_running)
+            continue;
+
+        std::cerr << "[Master] worker " << pid;
+        if (WIFSIGNALED(status))
+            std::cerr << " killed by signal " << WTERMSIG(status);
+        else
+            std::cerr << " exited with code " << WEXITSTATUS(status);
+        std::cerr << ", respawning\n";
+
+        // A worker that dies right away will most likely die again,
+        // don't turn that into a fork loop
+        if (std::time(nullptr) - startTime < RESPAWN_DELAY)
+            sleep(RESPAWN_DELAY);
+
+        spawnWorker();
+    }
+}
+
+void MasterProcess::stopWorkers()
+{
+    for (const auto& it : m_workers)
+        kill(it.first, SIGTERM);
+
+    for (const auto& it : m_workers)
+        while (waitpid(it.first, nullptr, 0) == -1 && errno == EINTR)
+            ;
+
+    m_workers.clear();
+}
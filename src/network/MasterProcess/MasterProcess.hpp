@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef MASTERPROCESS_HPP
+# define MASTERPROCESS_HPP
+
+# include <iostream>
+# include <cstring>
+# include <csignal>
+# include <ctime>
+# include <cstdlib>
+# include <vector>
+# include <unordered_map>
+# include <sys/wait.h>
+# include <unistd.h>
+
+# include "Config.hpp"
+# include "ServerSocket.hpp"
+# include "ReactorPool.hpp"
+
+// Binds every listening socket once and forks worker processes that
+// serve them. A worker that dies is replaced, so a crash only takes
+// down the connections of that worker.
+class MasterProcess
+{
+    // Construction and destruction
+  public:
+    MasterProcess(const Config& config, size_t workersCount);
+    MasterProcess(const MasterProcess& other) = delete;
+    MasterProcess& operator=(const MasterProcess& other) = delete;
+    MasterProcess(MasterProcess&& other) noexcept = delete;
+    MasterProcess& operator=(MasterProcess&& other) noexcept = delete;
+    ~MasterProcess();
+
+    // Class specific features
+  public:
+    // Constants
+    static constexpr int QUEUE_SIZE = 100;
+    static constexpr time_t RESPAWN_DELAY = 1; // seconds
+    // Methods
+    void run();
+
+  private:
+    // Properties
+    const Config& m_config;
+    size_t m_workersCount;
+    std::vector<ServerSocket> m_listeners;
+    std::unordered_map<pid_t, time_t> m_workers; // pid -> start time
+    sigset_t m_previousMask;
+    // Methods
+    void bindListeners();
+    void blockSignals();
+    void spawnWorker();
+    void runWorker();
+    void reapWorkers();
+    void stopWorkers();
+};
+
+#endif
@@ -0,0 +1,180 @@
+#include "OutputQueue.hpp"
+
+// ---------------------------ACCESSORS-----------------------------
+
+bool OutputQueue::empty() const
+{
+    return m_segments.empty();
+}
+
+size_t OutputQueue::size() const
+{
+    return m_size;
+}
+
+// ---------------------------METHODS-----------------------------
+
+// The buffer is taken over, not copied
+void OutputQueue::push(std::string&& data)
+{
+    if (data.empty())
+        return;
+
+    m_size += data.size();
+    m_segments.push_back(
+        {std::make_shared<const std::string>(std::move(data)), 0, FileBody(),
+         nullptr});
+}
+
+void OutputQueue::push(const std::string& data)
+{
+    push(std::string(data));
+}
+
+void OutputQueue::push(const std::shared_ptr<const std::string>& data)
+{
+    if (!data || data->empty())
+        return;
+
+    m_size += data->size();
+    m_segments.push_back({data, 0, FileBody(), nullptr});
+}
+
+void OutputQueue::push(const FileBody& file)
+{
+    if (!file.isSet() || file.length == 0)
+        return;
+
+    m_size += file.length;
+    m_segments.push_back({nullptr, 0, file, nullptr});
+}
+
+void OutputQueue::push(const std::shared_ptr<BodyStream>& stream)
+{
+    if (!stream)
+        return;
+
+    m_segments.push_back({nullptr, 0, FileBody(), stream});
+}
+
+// One writev for the buffers up to the next file, or one sendfile
+// for the file in front. Returns what the syscall returned, errno is
+// left as it set it
+ssize_t OutputQueue::flush(int fd)
+{
+    if (m_segments.front().stream && !pullStream())
+        return -1;
+    if (m_segments.front().file.isSet())
+        return sendFile(fd);
+    return writeBuffers(fd);
+}
+
+void OutputQueue::clear()
+{
+    m_segments.clear();
+    m_size = 0;
+}
+
+ssize_t OutputQueue::writeBuffers(int fd)
+{
+    iovec iov[MAX_IOV];
+    size_t count = 0;
+    bool fileFollows = false;
+
+    for (auto it = m_segments.begin();
+         it != m_segments.end() && count < MAX_IOV; ++it, ++count)
+    {
+        if (it->stream)
+            break;
+        if (it->file.isSet())
+        {
+            fileFollows = true;
+            break;
+        }
+        iov[count].iov_base = const_cast<char*>(it->data->data() + it->offset);
+        iov[count].iov_len = it->data->size() - it->offset;
+    }
+
+    // Headers wait for the first bytes of the file
+    // instead of leaving in a packet of their own
+    if (fileFollows)
+        setCork(fd, true);
+
+    ssize_t sent = writev(fd, iov, count);
+    if (sent > 0)
+        consume(sent);
+    return sent;
+}
+
+ssize_t OutputQueue::sendFile(int fd)
+{
+    Segment& front = m_segments.front();
+    off_t offset = front.file.offset + front.offset;
+    size_t left = front.file.length - front.offset;
+
+    ssize_t sent = sendfile(fd, front.file.fd->get(), &offset, left);
+    // The file got shorter since it was opened: the promised
+    // Content-Length can't be kept anymore
+    if (sent == 0)
+    {
+        errno = EIO;
+        return -1;
+    }
+    if (sent < 0)
+        return sent;
+
+    bool fileDone = (static_cast<size_t>(sent) == left);
+    consume(sent);
+    if (fileDone)
+        setCork(fd, false);
+    return sent;
+}
+
+// The next bytes of the stream in front go in a buffer before it,
+// the stream leaves the queue with its last bytes
+bool OutputQueue::pullStream()
+{
+    std::shared_ptr<BodyStream> stream = m_segments.front().stream;
+    std::string data;
+
+    if (!stream->next(data))
+        return false;
+    if (stream->finished())
+        m_segments.pop_front();
+
+    m_size += data.size();
+    m_segments.push_front(
+        {std::make_shared<const std::string>(std::move(data)), 0, FileBody(),
+         nullptr});
+    return true;
+}
+
+void OutputQueue::consume(size_t n)
+{
+    m_size -= n;
+    while (n > 0)
+    {
+        Segment& front = m_segments.front();
+        size_t total = front.file.isSet() ? front.file.length
+                                          : front.data->size();
+        size_t left = total - front.offset;
+        if (n < left)
+        {
+            front.offset += n;
+            return;
+        }
+        n -= left;
+        m_segments.pop_front();
+    }
+}
+
+// Not a TCP socket (tests use pipes): nothing to cork, nothing to do
+void OutputQueue::setCork(int fd, bool on)
+{
+    if (m_corked == on)
+        return;
+
+    int value = on ? 1 : 0;
+    setsockopt(fd, IPPROTO_TCP, TCP_CORK, &value, sizeof(value));
+    m_corked = on;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#ifndef OUTPUTQUEUE_HPP
+# define OUTPUTQUEUE_HPP
+
+# include <deque>
+# include <memory>
+# include <string>
+# include <sys/types.h>
+# include <sys/uio.h>
+# include <sys/sendfile.h>
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+
+# include "FileBody.hpp"
+# include "BodyStream.hpp"
+
+// Bytes waiting to be sent on a socket, kept as the separate buffers
+// they were produced in (header block, body, ...) and sent with one
+// writev. Sent bytes are skipped by moving an offset, never erased.
+// File bodies go straight from the page cache to the socket with sendfile.
+// Streamed bodies are asked for their bytes when their turn comes.
+class OutputQueue
+{
+    // Construction and destruction
+  public:
+    OutputQueue() = default;
+    OutputQueue(const OutputQueue& other) = delete;
+    OutputQueue& operator=(const OutputQueue& other) = delete;
+    OutputQueue(OutputQueue&& other) noexcept = default;
+    OutputQueue& operator=(OutputQueue&& other) noexcept = default;
+    ~OutputQueue() = default;
+
+    // Class specific features
+  public:
+    // Constants
+    static constexpr size_t MAX_IOV = 64;
+    // Accessors
+    bool empty() const;
+    size_t size() const;
+    // Methods
+    void push(std::string&& data);
+    void push(const std::string& data);
+    void push(const std::shared_ptr<const std::string>& data);
+    void push(const FileBody& file);
+    void push(const std::shared_ptr<BodyStream>& stream);
+    ssize_t flush(int fd);
+    void clear();
+
+  private:
+    // Buffers may be shared with other queues (cached responses)
+    struct Segment
+    {
+        std::shared_ptr<const std::string> data;
+        size_t offset = 0; // bytes already sent
+        FileBody file;     // set for file segments, data is null then
+        std::shared_ptr<BodyStream> stream; // same for streamed bodies
+    };
+
+    // Properties
+    std::deque<Segment> m_segments;
+    size_t m_size = 0; // unsent bytes, streams not counted
+    bool m_corked = false;
+    // Methods
+    ssize_t writeBuffers(int fd);
+    ssize_t sendFile(int fd);
+    bool pullStream();
+    void consume(size_t n);
+    void setCork(int fd, bool on);
+};
+
+#endif
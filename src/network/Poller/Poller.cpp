@@ -0,0 +1,46 @@
+#include "Poller.hpp"
+#include "EpollPoller.hpp"
+#include "IoUringPoller.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <sys/socket.h>
+
+// ---------------------------METHODS-----------------------------
+
+int Poller::addListener(int fd, uint32_t events)
+{
+    return add(fd, events);
+}
+
+// The peer address isn't asked for, Client looks it up when needed
+int Poller::acceptClient(int listenFd)
+{
+    return accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+}
+
+// Falls back to epoll when io_uring is compiled out,
+// disabled by the kernel or too old
+std::unique_ptr<Poller> Poller::create(EventBackend backend)
+{
+#ifdef WEBSERV_HAS_IO_URING
+    if (backend == EventBackend::IoUring)
+    {
+        try
+        {
+            return std::make_unique<IoUringPoller>();
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << "Warning: io_uring unavailable (" << e.what()
+                      << "), using epoll" << std::endl;
+        }
+    }
+#else
+    if (backend == EventBackend::IoUring)
+        std::cerr << "Warning: built without io_uring, using epoll"
+                  << std::endl;
+#endif
+
+    return std::make_unique<EpollPoller>();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#ifndef POLLER_HPP
+# define POLLER_HPP
+
+# include <cstdint>
+# include <memory>
+# include <sys/epoll.h>
+
+typedef struct epoll_event t_event;
+
+enum class EventBackend
+{
+    Epoll,
+    IoUring
+};
+
+// Readiness notification backend of the Server. The calls mirror
+// epoll_ctl/epoll_wait: they return -1 and set errno on failure, and
+// events use the EPOLL* flags whatever the backend is.
+// A listening socket is reported readable while connections wait on
+// it; acceptClient takes them one at a time, from the socket itself or
+// from what the backend has already accepted.
+class Poller
+{
+    // Construction and destruction
+  public:
+    virtual ~Poller() = default;
+
+    // Class specific features
+  public:
+    // Methods
+    virtual int add(int fd, uint32_t events) = 0;
+    virtual int modify(int fd, uint32_t events) = 0;
+    virtual int remove(int fd) = 0;
+    virtual int wait(t_event* events, int maxEvents, int timeoutMs) = 0;
+    virtual int addListener(int fd, uint32_t events);
+    virtual int acceptClient(int listenFd); // -1 and EAGAIN: none left
+
+    static std::unique_ptr<Poller> create(EventBackend backend);
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "ReactorPool.hpp"
+
+// -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
+
+ReactorPool::ReactorPool(const Config& config, size_t reactorsCount)
+  : m_config(config)
+  , m_reactorsCount(reactorsCount == 0 ? 1 : reactorsCount)
+{
+}
+
+ReactorPool::ReactorPool(const Config& config, size_t reactorsCount,
+                         const std::vector<ServerSocket>& listeners)
+  : m_config(config)
+  , m_reactorsCount(reactorsCount == 0 ? 1 : reactorsCount)
+  , m_listeners(&listeners)
+{
+}
+
+ReactorPool::~ReactorPool()
+{
+    if (m_wakeupfd != -1)
+        close(m_wakeupfd);
+}
+
+// ---------------------------METHODS-----------------------------
+
+void ReactorPool::run()
+{
+    if (m_reactorsCount == 1)
+        return runReactor();
+
+    m_wakeupfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeupfd == -1)
+        throw std::runtime_error("eventfd");
+
+    // Signals are only delivered to the main thread, the others learn
+    // about the shutdown through the wakeup eventfd
+    sigset_t blocked, previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+
+    std::vector<std::thread> threads;
+    try
+    {
+        for (size_t i = 1; i < m_reactorsCount; ++i)
+            threads.emplace_back(&ReactorPool::runReactor, this);
+    }
+    catch (const std::system_error& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+    }
+
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+
+    runReactor();
+
+    stop();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void ReactorPool::runReactor()
+{
+    bool started = false;
+
+    while (g_running)
+    {
+        try
+        {
+            Server s = m_listeners ? Server(m_config, *m_listeners)
+                                   : Server(m_config, m_reactorsCount > 1);
+            s.setWakeupFd(m_wakeupfd);
+            started = true;
+            s.run();
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << "Error: " << e.what() << ": " << strerror(errno)
+                      << "\n";
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Error: " << e.what() << "\n";
+        }
+
+        // A reactor that couldn't even be set up won't do better on retry
+        if (!started)
+            stop();
+    }
+}
+
+void ReactorPool::stop()
+{
+    g_running = false;
+
+    if (m_wakeupfd == -1)
+        return;
+
+    uint64_t one = 1;
+    if (write(m_wakeupfd, &one, sizeof(one)) == -1 && errno != EAGAIN)
+        std::cerr << "Error: eventfd write: " << strerror(errno) << "\n";
+}
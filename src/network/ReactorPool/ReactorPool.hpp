@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef REACTORPOOL_HPP
+# define REACTORPOOL_HPP
+
+# include <iostream>
+# include <cstring>
+# include <stdexcept>
+# include <thread>
+# include <vector>
+# include <csignal>
+# include <pthread.h>
+# include <sys/eventfd.h>
+# include <unistd.h>
+
+# include "Config.hpp"
+# include "Server.hpp"
+
+// Runs one Server (an epoll reactor) per thread. Every reactor binds
+// its own SO_REUSEPORT listeners, so connections never migrate between
+// threads and the reactors share nothing but the read-only Config.
+// In a worker process the reactors share the listeners of the master.
+class ReactorPool
+{
+    // Construction and destruction
+  public:
+    ReactorPool(const Config& config, size_t reactorsCount);
+    ReactorPool(const Config& config, size_t reactorsCount,
+                const std::vector<ServerSocket>& listeners);
+    ReactorPool(const ReactorPool& other) = delete;
+    ReactorPool& operator=(const ReactorPool& other) = delete;
+    ReactorPool(ReactorPool&& other) noexcept = delete;
+    ReactorPool& operator=(ReactorPool&& other) noexcept = delete;
+    ~ReactorPool();
+
+    // Class specific features
+  public:
+    // Methods
+    void run();
+
+  private:
+    // Properties
+    const Config& m_config;
+    size_t m_reactorsCount;
+    const std::vector<ServerSocket>* m_listeners = nullptr; // not owned
+    int m_wakeupfd = -1;
+    // Methods
+    void runReactor();
+    void stop();
+};
+
+#endif
@@ -3,33 +3,62 @@
 // --------------CONSTRUCTION AND DESTRUCTION--------------
 
 // Default constructor
-Server::Server(const Config& config)
-  : m_connMgr(config)
+Server::Server(const Config& config, bool reusePort)
+  : m_reusePort(reusePort)
+  , m_edgeTriggered(config.edgeTriggered())
+  , m_eventBackend(config.eventBackend())
+  , m_timeouts(config.timeouts())
+  , m_connMgr(config)
 {
+    // Servers are built in the thread that runs them
+    OpenFileCache::local().configure(config.openFileCache());
+    ResponseCache::local().configure(config.responseCache());
+
     std::vector<NetworkEndpoint> endpoints = config.getAllEndpoints();
     for (const auto& endpoint : endpoints)
         addEndpoint(endpoint);
 }
 
+// Serves sockets bound by someone else (the master process),
+// possibly shared with other reactors
+Server::Server(const Config& config, const std::vector<ServerSocket>& listeners)
+  : m_sharedListeners(true)
+  , m_edgeTriggered(config.edgeTriggered())
+  , m_eventBackend(config.eventBackend())
+  , m_timeouts(config.timeouts())
+  , m_connMgr(config)
+{
+    OpenFileCache::local().configure(config.openFileCache());
+    ResponseCache::local().configure(config.responseCache());
+
+    for (const auto& listener : listeners)
+    {
+        ServerSocket s = listener.duplicate();
+        m_listeners.emplace(s.fd(), std::move(s));
+    }
+}
+
 // Destructor
 Server::~Server()
 {
-    for (auto& it : m_clients)
-        if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, it.first, nullptr) == -1)
-            std::cerr << "epoll_ctl DEL client failed" << std::endl;
-
-    for (auto& it : m_listeners)
-        if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, it.first, nullptr) == -1)
-            std::cerr << "epoll_ctl DEL listener failed" << std::endl;
+    if (m_poller)
+    {
+        for (auto& it : m_clients)
+            if (m_poller->remove(it.first) == -1)
+                std::cerr << "poller DEL client failed" << std::endl;
 
-    if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, m_timerfd, nullptr) == -1)
-        std::cerr << "epoll_ctl DEL timer failed" << std::endl;
+        for (auto& it : m_listeners)
+            if (m_poller->remove(it.first) == -1)
+                std::cerr << "poller DEL listener failed" << std::endl;
+    }
 
-    if (m_timerfd != -1)
-        close(m_timerfd);
+    for (auto& it : m_cgiExitFds)
+        close(it.second);
 
-    if (m_epfd != -1)
-        close(m_epfd);
+    const ResponseCache& cache = ResponseCache::local();
+    if (cache.enabled())
+        std::cout << "Response cache: " << cache.hits() << " hits, "
+                  << cache.misses() << " misses" << std::endl;
 
     std::cout << "Server stopped." << std::endl;
 }
@@ -38,13 +67,29 @@ Server::~Server()
 
 void Server::run(void)
 {
-    createEpoll();
-    createTimer();
+    createPoller();
+
+    // EPOLLEXCLUSIVE: a new connection on a shared socket
+    // wakes up one reactor instead of all of them
+    uint32_t listenerEvents = EPOLLIN;
+    if (m_sharedListeners)
+        listenerEvents |= EPOLLEXCLUSIVE;
+    if (m_edgeTriggered)
+        listenerEvents |= EPOLLET;
 
     for (auto& it : m_listeners)
-        addFdToEPoll(it.first, EPOLLIN);
+    {
+        if (m_poller->addListener(it.first, listenerEvents) == -1)
+            throw std::runtime_error("poller add listener");
+        setHandler(it.first, {FdHandler::Type::Listener, nullptr, nullptr});
+    }
+
+    if (m_wakeupfd != -1)
+    {
+        addFdToPoller(m_wakeupfd, EPOLLIN);
+        setHandler(m_wakeupfd, {FdHandler::Type::Wakeup, nullptr, nullptr});
+    }
 
-    g_running = true;
     monitorEvents();
 }
 
@@ -53,35 +98,39 @@ void Server::monitorEvents()
     t_event events[MAX_EVENTS];
     while (g_running)
     {
-        int readyFDs = epoll_wait(m_epfd, events, MAX_EVENTS, -1);
+        int timeout = hasPendingWork() ? 0 : m_timers.nextTimeoutMs();
+        int readyFDs = m_poller->wait(events, MAX_EVENTS, timeout);
         if (readyFDs == -1)
         {
             if (errno == EINTR)
                 continue; // interrupted by signal, retry
-            throw std::runtime_error("epoll_wait");
+            throw std::runtime_error("poller wait");
         }
 
+        // Responses of this round share one formatted Date
+        HttpDate::refresh(std::time(nullptr));
+
         for (int i = 0; i < readyFDs; ++i)
             processEvent(events[i]);
 
-        reapDeadCgis();
+        m_timers.advance(TimerWheel::nowMs());
 
-        for (auto& it : m_clients)
-            fillBuffer(it.second);
-    }
-}
+        reapUnwatchedCgis();
 
-void Server::createEpoll()
-{
-    m_epfd = epoll_create(1);
-    if (m_epfd == -1)
-        throw std::runtime_error("epoll_create");
+        for (int fd : m_connMgr.takeReadyClients())
+        {
+            auto it = m_clients.find(fd);
+            if (it != m_clients.end())
+                fillBuffer(it->second);
+        }
+
+        resumePendingWork();
+    }
 }
 
-void Server::createTimer()
+void Server::createPoller()
 {
-    m_timerfd = createTimerFd(5);
-    addFdToEPoll(m_timerfd, EPOLLIN);
+    m_poller = Poller::create(m_eventBackend);
 }
 
 void Server::processEvent(const t_event& event)
@@ -89,30 +138,29 @@ void Server::processEvent(const t_event& event)
     int fd = event.data.fd;
     uint32_t ev = event.events;
 
-    if (fd == m_timerfd)
-        return processTimer();
-
-    if (m_listeners.count(fd))
-        return acceptNewClient(fd, m_epfd);
-
-    if (auto* cgiByIn = m_connMgr.findCgiByStdinFd(fd))
-        return processCgiInput(ev, *cgiByIn);
-
-    if (auto* cgiByOut = m_connMgr.findCgiByStdoutFd(fd))
-        return processCgiOutput(ev, *cgiByOut);
-
-    processClient(fd, ev);
-}
+    // None: the fd was closed by an earlier event of the same batch
+    if (fd < 0 || static_cast<size_t>(fd) >= m_handlers.size())
+        return;
+    const FdHandler handler = m_handlers[fd];
 
-void Server::processTimer()
-{
-    uint64_t expirations;
-    ssize_t n = read(m_timerfd, &expirations, sizeof(expirations));
-    if (n != sizeof(expirations))
-        std::cerr << "Warning: timerfd read returned unexpected size: " << n
-                  << std::endl;
-    checkClientTimeouts();
-    checkCGITimeouts();
+    switch (handler.type)
+    {
+        // Only signals that g_running changed, the loop condition handles it
+        case FdHandler::Type::Wakeup:
+            return;
+        case FdHandler::Type::Listener:
+            return acceptNewClients(fd);
+        case FdHandler::Type::CgiStdin:
+            return processCgiInput(ev, *handler.cgi);
+        case FdHandler::Type::CgiStdout:
+            return processCgiOutput(ev, *handler.cgi);
+        case FdHandler::Type::CgiExit:
+            return reapCgi(handler.pid);
+        case FdHandler::Type::Client:
+            return processClient(*handler.client, ev);
+        case FdHandler::Type::None:
+            return;
+    }
 }
 
 void Server::processCgiInput(uint32_t ev, CGIData& cgiData)
@@ -133,19 +181,20 @@ void Server::processCgiOutput(uint32_t ev, CGIData& cgiData)
     return;
 }
 
-void Server::processClient(int fd, uint32_t ev)
+void Server::processClient(Client& client, uint32_t ev)
 {
-    auto itClient = m_clients.find(fd);
-    if (itClient == m_clients.end())
-        return;
-
-    Client& client = itClient->second;
+    int fd = client.socket();
 
     if (ev & (EPOLLHUP | EPOLLERR | EPOLLRDHUP))
         return removeClient(client);
 
     if (ev & EPOLLIN)
-        return readFromClient(client);
+    {
+        readFromClient(client);
+        // An edge-triggered EPOLLOUT left unhandled won't be reported again
+        if (!m_edgeTriggered || !m_clients.count(fd))
+            return;
+    }
 
     if (ev & EPOLLOUT)
         return writeToClient(client);
@@ -154,59 +203,112 @@ void Server::processClient(int fd, uint32_t ev)
 void Server::writeToClient(Client& client)
 {
     int fd = client.socket();
-    std::string& out = client.outBuffer();
+    OutputQueue& out = client.output();
+    bool progress = false;
 
-    while (!out.empty())
+    for (size_t i = 0; i < WRITE_BUDGET && !out.empty(); ++i)
     {
-        ssize_t sent = write(fd, out.c_str(), out.size());
+        ssize_t sent = out.flush(fd);
         if (sent > 0)
         {
-            out.erase(0, sent);
-        }
-        else
-        {
-            std::cerr << "send failed" << std::endl;
-            removeClient(client);
-            return;
+            progress = true;
+            continue;
         }
+
+        // Socket buffer is full, EPOLLOUT tells when to go on
+        if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return updateClientTimer(client, progress);
+        if (sent == -1 && errno == EINTR)
+            continue;
+
+        std::cerr << "send failed" << std::endl;
+        removeClient(client);
+        return;
+    }
+
+    if (!out.empty())
+    {
+        if (m_edgeTriggered)
+            m_pendingWrites.push_back(fd);
+        return updateClientTimer(client, progress);
     }
 
     disableEpollOut(fd);
     if (client.shouldClose())
     {
         DBG("[Server]: shouldClose");
-        removeClient(client);
+        return removeClient(client);
     }
+    // Responses that were ready while the buffer was busy
+    if (m_connMgr.clientState(fd).hasPendingResponse())
+        m_connMgr.markReady(fd);
+    updateClientTimer(client, progress);
 }
 
 void Server::addEndpoint(const NetworkEndpoint& endpoint)
 {
-    ServerSocket s(endpoint, QUEUE_SIZE);
+    ServerSocket s(endpoint, QUEUE_SIZE, m_reusePort);
     m_listeners.emplace(s.fd(), std::move(s));
 }
 
-void Server::addFdToEPoll(int socket, uint32_t events)
+void Server::setWakeupFd(int fd)
 {
-    t_event e;
-    e.data.fd = socket;
-    e.events = events;
+    m_wakeupfd = fd;
+}
 
-    int result = epoll_ctl(m_epfd, EPOLL_CTL_ADD, socket, &e);
-    if (result == -1)
-        throw std::runtime_error("epoll_ctl");
+void Server::addFdToPoller(int socket, uint32_t events)
+{
+    if (m_poller->add(socket, events) == -1)
+        throw std::runtime_error("poller add");
 }
 
-void Server::acceptNewClient(int listeningSocket, int epoll_fd)
+void Server::setHandler(int fd, FdHandler handler)
 {
-    sockaddr_in clientAddr;
-    socklen_t addrLen = sizeof(clientAddr);
+    if (static_cast<size_t>(fd) >= m_handlers.size())
+        m_handlers.resize(fd + 1);
+    m_handlers[fd] = handler;
+}
+
+void Server::clearHandler(int fd)
+{
+    if (fd >= 0 && static_cast<size_t>(fd) < m_handlers.size())
+        m_handlers[fd] = FdHandler();
+}
+
+void Server::closeCgiFd(int& fd)
+{
+    if (fd == -1)
+        return;
+
+    if (m_poller->remove(fd) == -1)
+        std::cerr << "poller DEL cgi pipe failed" << std::endl;
+    clearHandler(fd);
+    close(fd);
+    fd = -1;
+}
+
+// Drains the accept queue, so a burst of connections
+// costs one loop iteration instead of one per client
+void Server::acceptNewClients(int listeningSocket)
+{
+    for (size_t i = 0; i < ACCEPT_BUDGET; ++i)
+        if (!acceptNewClient(listeningSocket))
+            return;
+
+    if (m_edgeTriggered)
+        m_pendingAccepts.push_back(listeningSocket);
+}
 
-    int clientSocket
-        = accept(listeningSocket, (struct sockaddr*)&clientAddr, &addrLen);
+// Returns false once the accept queue is empty
+bool Server::acceptNewClient(int listeningSocket)
+{
+    int clientSocket = m_poller->acceptClient(listeningSocket);
     if (clientSocket == -1)
     {
-        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
-            return;
+        if (errno == EINTR || errno == ECONNABORTED)
+            return true;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return false;
         throw std::runtime_error("accept");
     }
 
@@ -215,23 +317,36 @@ void Server::acceptNewClient(int listeningSocket, int epoll_fd)
         std::cerr << "[Server] Connection rejected: too many clients"
                   << std::endl;
         close(clientSocket);
-        return;
+        return true;
     }
 
     FdGuard clientFd(clientSocket);
 
-    Socket::setNonBlockingAndCloexec(clientSocket);
-
     const NetworkEndpoint& ep = m_listeners.at(listeningSocket).endpoint();
 
-    m_clients.emplace(clientSocket,
-                      Client(clientSocket, epoll_fd, clientAddr, ep));
+    auto it = m_clients.emplace(clientSocket,
+                                Client(clientSocket, ep)).first;
 
     m_connMgr.addClient(clientSocket);
 
-    addFdToEPoll(clientSocket, EPOLLIN);
+    addFdToPoller(clientSocket, clientEvents());
+    setHandler(clientSocket, {FdHandler::Type::Client, &it->second, nullptr});
+
+    // The first request is waited for under client_header_timeout
+    Client& client = it->second;
+    client.timer().onExpire = [this, clientSocket]()
+    {
+        auto it = m_clients.find(clientSocket);
+        if (it == m_clients.end())
+            return;
+        DBG("Client " << clientSocket << " timed out");
+        removeClient(it->second);
+    };
+    client.setTimeoutPhase(Client::TimeoutPhase::Header);
+    m_timers.arm(client.timer(), m_timeouts.clientHeader);
 
     clientFd.release();
+    return true;
 }
 
 void Server::removeClient(Client& client)
@@ -241,21 +356,8 @@ void Server::removeClient(Client& client)
 
     for (auto& cgi : state.activeCGIs())
     {
-        if (cgi.fd_stdin != -1)
-        {
-            if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, cgi.fd_stdin, nullptr) == -1)
-                std::cerr << "epoll_ctl DEL cgi stdin failed" << std::endl;
-            close(cgi.fd_stdin);
-            cgi.fd_stdin = -1;
-        }
-
-        if (cgi.fd_stdout != -1)
-        {
-            if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, cgi.fd_stdout, nullptr) == -1)
-                std::cerr << "epoll_ctl DEL cgi stdout failed" << std::endl;
-            close(cgi.fd_stdout);
-            cgi.fd_stdout = -1;
-        }
+        closeCgiFd(cgi.fd_stdin);
+        closeCgiFd(cgi.fd_stdout);
 
         if (cgi.pid > 0)
         {
@@ -267,9 +369,9 @@ void Server::removeClient(Client& client)
 
     m_connMgr.removeClient(clientSocket);
 
-    if (m_epfd != -1
-        && epoll_ctl(m_epfd, EPOLL_CTL_DEL, clientSocket, nullptr) == -1)
-        std::cerr << "epoll_ctl DEL client failed" << std::endl;
+    if (m_poller && m_poller->remove(clientSocket) == -1)
+        std::cerr << "poller DEL client failed" << std::endl;
+    clearHandler(clientSocket);
 
     if (m_clients.erase(clientSocket) == 0)
         std::cerr << "Warning: tried to remove non-existent client "
@@ -282,129 +384,193 @@ void Server::readFromClient(Client& client)
 {
     int clientFd = client.socket();
     char buf[BUFFER_SIZE];
-    int n = read(clientFd, buf, sizeof(buf) - 1);
 
-    if (n > 0)
+    for (size_t i = 0; i < READ_BUDGET; ++i)
     {
-        buf[n] = '\0';
-        std::string data(buf, n);
+        ssize_t n = read(clientFd, buf, sizeof(buf));
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        if (n <= 0)
+            return removeClient(client);
 
-        m_connMgr.processData(client, data);
-    }
-    else
-    {
-        removeClient(client);
-        return;
+        m_connMgr.processData(client, std::string_view(buf, n));
+        registerStartedCgis();
+        updateClientTimer(client, true);
+
+        // A short read means the socket buffer is empty,
+        // no need to spend a syscall on hearing EAGAIN
+        if (static_cast<size_t>(n) < sizeof(buf))
+            return;
     }
+
+    if (m_edgeTriggered)
+        m_pendingReads.push_back(clientFd);
 }
 
 void Server::fillBuffer(Client& client)
 {
-    if (!client.outBuffer().empty())
+    if (!client.output().empty())
         return;
 
     ClientState& clientState = m_connMgr.clientState(client.socket());
 
     while (clientState.hasPendingResponse())
     {
-        const ResponseData& respData = clientState.frontResponse();
+        ResponseData& respData = clientState.frontResponse();
 
         if (!respData.isReady)
             break;
 
-        std::string respStr = respData.serialize();
-        client.appendToOutBuffer(respStr);
-        client.updateLastActivity();
+        // The body is handed over as it is, not copied behind the headers
+        client.output().push(respData.serializeHead());
+        client.output().push(std::move(respData.body));
+        client.output().push(respData.cachedBody);
+        client.output().push(respData.file);
+        client.output().push(respData.stream);
+        for (BodyPart& part : respData.parts)
+        {
+            client.output().push(std::move(part.data));
+            client.output().push(part.file);
+        }
         client.setShouldClose(respData.shouldClose);
 
         clientState.popFrontResponse();
+    }
+
+    if (client.output().empty())
+        return;
+    updateClientTimer(client, false);
 
+    // EPOLLOUT is always armed in edge-triggered mode, but its edge
+    // may be long gone, so the first write is attempted right away
+    if (m_edgeTriggered)
+        m_pendingWrites.push_back(client.socket());
+    else
         enableEpollOut(client.socket());
-    }
 }
 
-void Server::modifyFdInEpoll(int fd, uint32_t events)
+bool Server::hasPendingWork() const
 {
-    t_event conf;
-    conf.data.fd = fd;
-    conf.events = events;
-    if (epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &conf) == -1)
-        std::cerr << "epoll_ctl: EPOLL_CTL_MOD" << std::endl;
+    return !m_pendingAccepts.empty() || !m_pendingReads.empty()
+        || !m_pendingWrites.empty();
 }
 
-void Server::enableEpollOut(int clientFd)
+// Fds are looked up again: a client may have been removed since
+void Server::resumePendingWork()
 {
-    uint32_t events = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP | EPOLLOUT;
-    modifyFdInEpoll(clientFd, events);
+    if (!hasPendingWork())
+        return;
+
+    std::vector<int> accepts;
+    std::vector<int> reads;
+    std::vector<int> writes;
+    accepts.swap(m_pendingAccepts);
+    reads.swap(m_pendingReads);
+    writes.swap(m_pendingWrites);
+
+    for (int fd : accepts)
+        acceptNewClients(fd);
+
+    for (int fd : reads)
+    {
+        auto it = m_clients.find(fd);
+        if (it != m_clients.end())
+            readFromClient(it->second);
+    }
+
+    for (int fd : writes)
+    {
+        auto it = m_clients.find(fd);
+        if (it != m_clients.end())
+            writeToClient(it->second);
+    }
 }
 
-void Server::disableEpollOut(int clientFd)
+void Server::modifyFdInPoller(int fd, uint32_t events)
 {
-    uint32_t events = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP;
-    modifyFdInEpoll(clientFd, events);
+    if (m_poller->modify(fd, events) == -1)
+        std::cerr << "poller MOD failed" << std::endl;
 }
 
-int Server::createTimerFd(int interval_sec)
+// Edge-triggered clients are registered for EPOLLOUT once and for all,
+// which saves the epoll_ctl calls of toggling it for every response
+uint32_t Server::clientEvents() const
 {
-    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
-    if (tfd == -1)
-        throw std::runtime_error("timerfd_create failed");
-
-    itimerspec spec{};
-    spec.it_interval.tv_sec = interval_sec;
-    spec.it_value.tv_sec = interval_sec;
+    if (m_edgeTriggered)
+        return EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    return EPOLLIN;
+}
 
-    if (timerfd_settime(tfd, 0, &spec, NULL) == -1)
-        throw std::runtime_error("timerfd_settime failed");
+void Server::enableEpollOut(int clientFd)
+{
+    if (m_edgeTriggered)
+        return;
+    uint32_t events = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP | EPOLLOUT;
+    modifyFdInPoller(clientFd, events);
+}
 
-    return tfd;
+void Server::disableEpollOut(int clientFd)
+{
+    if (m_edgeTriggered)
+        return;
+    uint32_t events = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP;
+    modifyFdInPoller(clientFd, events);
 }
 
-void Server::checkClientTimeouts()
+// Header and keep-alive timeouts limit the whole wait, body and send
+// timeouts only the pause between two successful reads or writes
+void Server::updateClientTimer(Client& client, bool progress)
 {
-    std::vector<int> timedOutClients;
+    using Phase = Client::TimeoutPhase;
 
-    for (const auto& pair : m_clients)
-        if (pair.second.isTimedOut(std::chrono::seconds(TIMEOUT)))
-            timedOutClients.push_back(pair.first);
+    Phase phase = timeoutPhaseOf(client);
+    bool perOperation = (phase == Phase::Body || phase == Phase::Send);
+    if (phase == client.timeoutPhase() && !(progress && perOperation))
+        return;
 
-    for (int fd : timedOutClients)
+    client.setTimeoutPhase(phase);
+    switch (phase)
     {
-        auto it = m_clients.find(fd);
-        if (it != m_clients.end())
-        {
-            DBG("Client " << fd << " timed out");
-            removeClient(it->second);
-        }
+        case Phase::None:
+            return client.timer().disarm();
+        case Phase::Header:
+            return m_timers.arm(client.timer(), m_timeouts.clientHeader);
+        case Phase::Body:
+            return m_timers.arm(client.timer(), m_timeouts.clientBody);
+        case Phase::Send:
+            return m_timers.arm(client.timer(), m_timeouts.send);
+        case Phase::Keepalive:
+            return m_timers.arm(client.timer(), m_timeouts.keepalive);
     }
 }
 
-void Server::checkCGITimeouts()
+Client::TimeoutPhase Server::timeoutPhaseOf(Client& client)
 {
-    time_t now = time(NULL);
+    if (!client.output().empty())
+        return Client::TimeoutPhase::Send;
 
-    for (auto& [fd, client] : m_clients)
-    {
-        ClientState& state = m_connMgr.clientState(fd);
-        auto timedOut = state.getTimedOutCGIs(now, CGI_TIMEOUT);
+    // A response is still being made by a CGI, cgi_timeout covers it
+    ClientState& state = m_connMgr.clientState(client.socket());
+    if (state.hasPendingResponse())
+        return Client::TimeoutPhase::None;
 
-        for (CGIData* cgi : timedOut)
-        {
-            kill(cgi->pid, SIGKILL);
-            waitpid(cgi->pid, NULL, WNOHANG);
-
-            cleanupCgiFds(*cgi);
-
-            if (cgi->response)
-            {
-                RawResponse raw;
-                raw.addDefaultError(HttpStatusCode::GatewayTimeout);
-                *cgi->response = raw.toResponseData();
-                cgi->response->shouldClose = true;
-            }
-            state.removeCgi(cgi->pid);
-        }
+    switch (state.receivePhase())
+    {
+        case ClientState::ReceivePhase::Headers:
+            return Client::TimeoutPhase::Header;
+        case ClientState::ReceivePhase::Body:
+            return Client::TimeoutPhase::Body;
+        case ClientState::ReceivePhase::Idle:
+            break;
     }
+
+    // Nothing has been received yet on a new connection, and
+    // keep-alive only starts once a response has been sent
+    if (client.timeoutPhase() == Client::TimeoutPhase::Header)
+        return Client::TimeoutPhase::Header;
+    return Client::TimeoutPhase::Keepalive;
 }
 
 void Server::handleCgiTermination(CGIData& cgi)
@@ -420,23 +586,8 @@ void Server::handleCgiTermination(CGIData& cgi)
 
 void Server::cleanupCgiFds(CGIData& cgi)
 {
-    if (cgi.fd_stdout != -1)
-    {
-        if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, cgi.fd_stdout, NULL) == -1)
-            std::cerr << "epoll_ctl DEL cgi stdout failed" << std::endl;
-
-        close(cgi.fd_stdout);
-        cgi.fd_stdout = -1;
-    }
-
-    if (cgi.fd_stdin != -1)
-    {
-        if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, cgi.fd_stdin, NULL) == -1)
-            std::cerr << "epoll_ctl DEL cgi stdin failed" << std::endl;
-
-        close(cgi.fd_stdin);
-        cgi.fd_stdin = -1;
-    }
+    closeCgiFd(cgi.fd_stdout);
+    closeCgiFd(cgi.fd_stdin);
 }
 
 void Server::handleCgiStdin(CGIData& cgi)
@@ -446,15 +597,9 @@ void Server::handleCgiStdin(CGIData& cgi)
 
     size_t left = cgi.input.size() - cgi.input_sent;
     if (left == 0)
-    {
-        if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, cgi.fd_stdin, nullptr) == -1)
-            std::cerr << "epoll_ctl DEL cgi stdin failed" << std::endl;
-        close(cgi.fd_stdin);
-        cgi.fd_stdin = -1;
-        return;
-    }
+        return closeCgiFd(cgi.fd_stdin);
 
-    ssize_t n = write(cgi.fd_stdin, cgi.input.c_str() + cgi.input_sent, left);
+    ssize_t n = cgi.input.writeTo(cgi.fd_stdin, cgi.input_sent, left);
 
     if (n <= 0)
     {
@@ -476,17 +621,120 @@ void Server::handleCgiStdout(CGIData& cgi)
         return;
     }
 
-    if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, cgi.fd_stdout, nullptr) == -1)
-        std::cerr << "epoll_ctl DEL cgi stdout failed" << std::endl;
-    close(cgi.fd_stdout);
-    cgi.fd_stdout = -1;
+    closeCgiFd(cgi.fd_stdout);
+}
+
+// The process is reaped once its pidfd reports the exit,
+// by then it is no longer an active CGI of its client
+void Server::handleCgiTimeout(CGIData& cgi, int clientFd)
+{
+    DBG("CGI " << cgi.pid << " timed out");
+    kill(cgi.pid, SIGKILL);
+    cleanupCgiFds(cgi);
+
+    if (cgi.response)
+    {
+        RawResponse raw;
+        raw.addDefaultError(HttpStatusCode::GatewayTimeout);
+        *cgi.response = raw.toResponseData();
+        cgi.response->shouldClose = true;
+    }
+    m_connMgr.clientState(clientFd).removeCgi(cgi.pid);
+    m_connMgr.markReady(clientFd);
+}
+
+void Server::registerStartedCgis()
+{
+    for (CGIData* cgi : m_connMgr.takeStartedCgis())
+    {
+        if (cgi->fd_stdout != -1)
+        {
+            if (m_poller->add(cgi->fd_stdout, EPOLLIN | EPOLLRDHUP) == -1)
+                std::cerr << "poller ADD cgi stdout failed" << std::endl;
+            setHandler(cgi->fd_stdout,
+                       {FdHandler::Type::CgiStdout, nullptr, cgi});
+        }
+
+        if (cgi->fd_stdin != -1)
+        {
+            if (m_poller->add(cgi->fd_stdin, EPOLLOUT) == -1)
+                std::cerr << "poller ADD cgi stdin failed" << std::endl;
+            setHandler(cgi->fd_stdin,
+                       {FdHandler::Type::CgiStdin, nullptr, cgi});
+        }
+
+        int clientFd = m_connMgr.cgiOwner(cgi->pid);
+        cgi->timer.onExpire = [this, cgi, clientFd]()
+        { handleCgiTimeout(*cgi, clientFd); };
+        m_timers.arm(cgi->timer, m_timeouts.cgi);
+
+        watchCgiExit(cgi->pid);
+    }
+}
+
+// Only our own children are waited for: with several reactors in one
+// process waitpid(-1) would steal the CGIs of the other reactors. The
+// pidfd outlives the client, so killed CGIs don't stay zombies either.
+void Server::watchCgiExit(pid_t pid)
+{
+    int pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (pidfd == -1)
+    {
+        m_unwatchedCgis.push_back(pid);
+        return;
+    }
+
+    if (m_poller->add(pidfd, EPOLLIN) == -1)
+    {
+        close(pidfd);
+        m_unwatchedCgis.push_back(pid);
+        return;
+    }
+    setHandler(pidfd, {FdHandler::Type::CgiExit, nullptr, nullptr, pid});
+    m_cgiExitFds[pid] = pidfd;
 }
 
-void Server::reapDeadCgis()
+void Server::reapCgi(pid_t pid)
 {
     int status;
-    pid_t pid;
+    pid_t result = waitpid(pid, &status, WNOHANG);
+    if (result == 0 || (result == -1 && errno == EINTR))
+        return;
+
+    auto it = m_cgiExitFds.find(pid);
+    if (it != m_cgiExitFds.end())
+    {
+        if (m_poller->remove(it->second) == -1)
+            std::cerr << "poller DEL cgi pidfd failed" << std::endl;
+        clearHandler(it->second);
+        close(it->second);
+        m_cgiExitFds.erase(it);
+    }
 
-    while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+    if (result == pid)
         m_connMgr.onCgiExited(*this, pid, status);
+    else
+        m_connMgr.forgetCgi(pid);
+}
+
+void Server::reapUnwatchedCgis()
+{
+    for (size_t i = 0; i < m_unwatchedCgis.size();)
+    {
+        pid_t pid = m_unwatchedCgis[i];
+        int status;
+        pid_t result = waitpid(pid, &status, WNOHANG);
+        if (result == 0 || (result == -1 && errno == EINTR))
+        {
+            ++i;
+            continue;
+        }
+
+        m_unwatchedCgis[i] = m_unwatchedCgis.back();
+        m_unwatchedCgis.pop_back();
+        if (result == pid)
+            m_connMgr.onCgiExited(*this, pid, status);
+        else
+            m_connMgr.forgetCgi(pid);
+    }
 }
@@ -6,33 +6,58 @@
 # include <iostream>
 # include <unordered_map>
 # include <stdexcept>
-# include <sys/epoll.h>
 # include <errno.h>
-# include <csignal> // for g_running
+# include <atomic> // for g_running
+# include <csignal>
 # include <unordered_set>
 # include <vector>
 # include <memory>
-# include <sys/timerfd.h>
 # include <sys/wait.h>
+# include <sys/syscall.h>
+# include <unistd.h>
 
 # include "Client.hpp"
 # include "Config.hpp"
 # include "NetworkEndpoint.hpp"
 # include "ServerSocket.hpp"
 # include "ConnectionManager.hpp"
+# include "Poller.hpp"
+# include "TimerWheel.hpp"
+# include "Timeouts.hpp"
 # include "ClientState.hpp"
 # include "FdGuard.hpp"
+# include "HttpDate.hpp"
 # include "debug.hpp"
 
-typedef struct epoll_event t_event;
+extern std::atomic<bool> g_running;
 
-extern volatile std::sig_atomic_t g_running;
+// What an fd stands for, so that an event reaches its handler
+// with a single index instead of a search
+struct FdHandler
+{
+    enum class Type
+    {
+        None,
+        Wakeup,
+        Listener,
+        Client,
+        CgiStdin,
+        CgiStdout,
+        CgiExit // pidfd of a CGI process
+    };
+
+    Type type = Type::None;
+    Client* client = nullptr;
+    CGIData* cgi = nullptr;
+    pid_t pid = -1;
+};
 
 class Server
 {
     // Construction and destruction
   public:
-    Server(const Config& config);
+    Server(const Config& config, bool reusePort = false);
+    Server(const Config& config, const std::vector<ServerSocket>& listeners);
     ~Server();
 
     // Class specific features
@@ -42,46 +67,74 @@ class Server
     static constexpr int QUEUE_SIZE = 100;
     static constexpr int MAX_EVENTS = 50;
     static constexpr size_t BUFFER_SIZE = 8192;
-    static constexpr size_t TIMEOUT = 60;
-    static constexpr int CGI_TIMEOUT = 20;
+    // Max syscalls spent on one fd per loop iteration,
+    // so a single busy connection can't starve the others
+    static constexpr size_t ACCEPT_BUDGET = 64;
+    static constexpr size_t READ_BUDGET = 16;
+    static constexpr size_t WRITE_BUDGET = 16;
     // Methods
     void run(void);
     void addEndpoint(const NetworkEndpoint& endpoint);
+    void setWakeupFd(int fd);
     void removeClient(Client& client);
-    int createTimerFd(int interval_sec);
-    void checkClientTimeouts();
-    void checkCGITimeouts();
     void cleanupCgiFds(CGIData& cgi);
+    void handleCgiTermination(CGIData& cgi);
 
   private:
     // Properties
-    int m_epfd = -1; // event poll fd
-    int m_timerfd = -1;
+    std::unique_ptr<Poller> m_poller;
+    std::vector<FdHandler> m_handlers; // indexed by fd
+    int m_wakeupfd = -1; // not owned, shared between reactors
+    bool m_reusePort = false;
+    bool m_sharedListeners = false;
+    bool m_edgeTriggered = false;
+    EventBackend m_eventBackend = EventBackend::Epoll;
+    Timeouts m_timeouts;
+    TimerWheel m_timers;
+    // Edge-triggered mode only: fds whose budget ran out before EAGAIN,
+    // the poller won't report them again so they are resumed by hand
+    std::vector<int> m_pendingAccepts;
+    std::vector<int> m_pendingReads;
+    std::vector<int> m_pendingWrites;
     std::unordered_map<int, ServerSocket> m_listeners;
     std::unordered_map<int, Client> m_clients;
     ConnectionManager m_connMgr;
+    // CGI processes are reaped when their pidfd becomes readable; only
+    // those without one (kernels before 5.3) are checked on every loop
+    std::unordered_map<pid_t, int> m_cgiExitFds;
+    std::vector<pid_t> m_unwatchedCgis;
     // Methods
-    void createEpoll();
-    void createTimer();
-    void addFdToEPoll(int socket, uint32_t events);
+    void createPoller();
+    void addFdToPoller(int socket, uint32_t events);
+    void setHandler(int fd, FdHandler handler);
+    void clearHandler(int fd);
+    void closeCgiFd(int& fd);
     void monitorEvents();
     void processEvent(const t_event& event);
-    void processTimer();
     void processCgiInput(uint32_t ev, CGIData& cgiData);
     void processCgiOutput(uint32_t ev, CGIData& cgiData);
-    void processClient(int fd, uint32_t ev);
-    void acceptNewClient(int listeningSocket, int epoll_fd);
+    void processClient(Client& client, uint32_t ev);
+    void acceptNewClients(int listeningSocket);
+    bool acceptNewClient(int listeningSocket);
+    bool hasPendingWork() const;
+    void resumePendingWork();
 
     void readFromClient(Client& client);
     void writeToClient(Client& client);
     void fillBuffer(Client& client);
+    void updateClientTimer(Client& client, bool progress);
+    Client::TimeoutPhase timeoutPhaseOf(Client& client);
 
-    void handleCgiTermination(CGIData& cgi);
     void handleCgiStdin(CGIData& cgi);
     void handleCgiStdout(CGIData& cgi);
-    void reapDeadCgis();
+    void handleCgiTimeout(CGIData& cgi, int clientFd);
+    void registerStartedCgis();
+    void watchCgiExit(pid_t pid);
+    void reapCgi(pid_t pid);
+    void reapUnwatchedCgis();
 
-    void modifyFdInEpoll(int fd, uint32_t events);
+    void modifyFdInPoller(int fd, uint32_t events);
+    uint32_t clientEvents() const;
     void enableEpollOut(int clientFd);
     void disableEpollOut(int clientFd);
 };
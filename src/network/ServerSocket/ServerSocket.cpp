@@ -3,7 +3,8 @@
 // -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
 
 // Default constructor
-ServerSocket::ServerSocket(const NetworkEndpoint& endpoint, int queueSize)
+ServerSocket::ServerSocket(const NetworkEndpoint& endpoint, int queueSize,
+                           bool reusePort)
   : Socket()
   , m_endpoint(endpoint)
 {
@@ -13,6 +14,12 @@ ServerSocket::ServerSocket(const NetworkEndpoint& endpoint, int queueSize)
     if (setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == -1)
         throw std::runtime_error("setsockopt");
 
+    // Lets several reactors bind the same endpoint,
+    // the kernel then balances incoming connections between them
+    if (reusePort
+        && setsockopt(m_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == -1)
+        throw std::runtime_error("setsockopt");
+
     t_sockaddr_in addr;
     fillAddressInfo(addr, endpoint);
 
@@ -22,6 +29,13 @@ ServerSocket::ServerSocket(const NetworkEndpoint& endpoint, int queueSize)
         throw std::runtime_error("listen");
 }
 
+// Adopts an already listening socket
+ServerSocket::ServerSocket(int fd, const NetworkEndpoint& endpoint)
+  : Socket(fd)
+  , m_endpoint(endpoint)
+{
+}
+
 // Move constructor
 ServerSocket::ServerSocket(ServerSocket&& other) noexcept
   : Socket(std::move(other))
@@ -55,6 +69,16 @@ const NetworkEndpoint& ServerSocket::endpoint() const
     return m_endpoint;
 }
 
+// Another descriptor for the same listening socket, so every owner
+// can close its copy independently
+ServerSocket ServerSocket::duplicate() const
+{
+    int fd = fcntl(m_fd, F_DUPFD_CLOEXEC, 0);
+    if (fd == -1)
+        throw std::runtime_error("dup");
+    return ServerSocket(fd, m_endpoint);
+}
+
 void ServerSocket::fillAddressInfo(t_sockaddr_in& addr,
                                    const NetworkEndpoint& e)
 {
@@ -16,7 +16,8 @@ class ServerSocket : public Socket
 {
     // Construction and destruction
   public:
-    ServerSocket(const NetworkEndpoint& endpoint, int queueSize);
+    ServerSocket(const NetworkEndpoint& endpoint, int queueSize,
+                 bool reusePort = false);
     ServerSocket(const ServerSocket& other) = delete;
     ServerSocket& operator=(const ServerSocket& other) = delete;
     ServerSocket(ServerSocket&& other) noexcept;
@@ -26,8 +27,11 @@ class ServerSocket : public Socket
     // Class specific features
     NetworkEndpoint& endpoint();
     const NetworkEndpoint& endpoint() const;
+    ServerSocket duplicate() const;
 
   private:
+    // Construction
+    ServerSocket(int fd, const NetworkEndpoint& endpoint);
     // Properties
     NetworkEndpoint m_endpoint;
     // Methods
@@ -0,0 +1,195 @@
+#include "TimerWheel.hpp"
+
+// -----------------------------TIMER NODE-------------------------------------
+
+TimerNode::TimerNode(const TimerNode& other)
+  : onExpire(other.onExpire)
+{
+}
+
+// Only the callback is copied, the node keeps its own place in the wheel
+TimerNode& TimerNode::operator=(const TimerNode& other)
+{
+    if (this != &other)
+        onExpire = other.onExpire;
+    return *this;
+}
+
+TimerNode::~TimerNode()
+{
+    disarm();
+}
+
+bool TimerNode::isArmed() const
+{
+    return m_wheel != nullptr;
+}
+
+void TimerNode::disarm()
+{
+    if (!m_wheel)
+        return;
+
+    if (--m_wheel->m_armed == 0)
+        m_wheel->m_earliestTick = UINT64_MAX;
+    TimerWheel::unlink(*this);
+    m_wheel = nullptr;
+}
+
+// -----------------------CONSTRUCTION AND DESTRUCTION-------------------------
+
+TimerWheel::TimerWheel()
+  : m_slots(SLOTS)
+  , m_currentTick(nowMs() / TICK_MS)
+{
+    for (auto& head : m_slots)
+        head.m_prev = head.m_next = &head;
+    m_firing.m_prev = m_firing.m_next = &m_firing;
+}
+
+// Nodes may outlive the wheel, they must not point into it anymore
+TimerWheel::~TimerWheel()
+{
+    for (auto& head : m_slots)
+        while (head.m_next != &head)
+            head.m_next->disarm();
+    while (m_firing.m_next != &m_firing)
+        m_firing.m_next->disarm();
+}
+
+// ---------------------------METHODS-----------------------------
+
+// Re-arming an armed node just moves it
+void TimerWheel::arm(TimerNode& node, uint64_t delayMs)
+{
+    node.disarm();
+
+    // An empty wheel isn't advanced, its clock may be far behind
+    if (empty())
+        m_currentTick = std::max(m_currentTick, nowMs() / TICK_MS);
+
+    // Rounded up: a timer never fires early
+    uint64_t ticks = (delayMs + TICK_MS - 1) / TICK_MS;
+    node.m_expiresTick = m_currentTick + (ticks > 0 ? ticks : 1);
+    node.m_wheel = this;
+    link(m_slots[node.m_expiresTick % SLOTS], node);
+    ++m_armed;
+    m_earliestTick = std::min(m_earliestTick, node.m_expiresTick);
+}
+
+void TimerWheel::advance(uint64_t nowMs)
+{
+    uint64_t targetTick = nowMs / TICK_MS;
+    if (targetTick <= m_currentTick)
+        return;
+
+    // After a long stall every slot is due at most once
+    if (targetTick - m_currentTick >= SLOTS)
+    {
+        for (auto& head : m_slots)
+            collectDue(head, targetTick);
+    }
+    else
+    {
+        for (uint64_t tick = m_currentTick + 1; tick <= targetTick; ++tick)
+            collectDue(m_slots[tick % SLOTS], tick);
+    }
+
+    m_currentTick = targetTick;
+    fire();
+
+    // Disarmed timers leave the bound behind, it's only looked for
+    // again once it has passed
+    if (m_earliestTick <= m_currentTick)
+        m_earliestTick = empty() ? UINT64_MAX : findEarliestTick();
+}
+
+bool TimerWheel::empty() const
+{
+    return m_armed == 0;
+}
+
+// Poll timeout until the earliest timer is due, -1 with none armed.
+// It may be early when that timer was disarmed, never late
+int TimerWheel::nextTimeoutMs() const
+{
+    if (empty())
+        return -1;
+
+    uint64_t dueMs = m_earliestTick * TICK_MS;
+    uint64_t now = nowMs();
+    if (dueMs <= now)
+        return 0;
+    return static_cast<int>(std::min<uint64_t>(dueMs - now, INT_MAX));
+}
+
+uint64_t TimerWheel::nowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void TimerWheel::link(TimerNode& head, TimerNode& node)
+{
+    node.m_prev = head.m_prev;
+    node.m_next = &head;
+    head.m_prev->m_next = &node;
+    head.m_prev = &node;
+}
+
+void TimerWheel::unlink(TimerNode& node)
+{
+    node.m_prev->m_next = node.m_next;
+    node.m_next->m_prev = node.m_prev;
+    node.m_prev = node.m_next = nullptr;
+}
+
+void TimerWheel::collectDue(TimerNode& head, uint64_t tick)
+{
+    TimerNode* node = head.m_next;
+    while (node != &head)
+    {
+        TimerNode* next = node->m_next;
+        if (node->m_expiresTick <= tick)
+        {
+            unlink(*node);
+            link(m_firing, *node);
+        }
+        node = next;
+    }
+}
+
+// The first slot holding a timer of the coming revolution has the
+// earliest one; without any, it's the smallest of the later ones
+uint64_t TimerWheel::findEarliestTick() const
+{
+    uint64_t earliest = UINT64_MAX;
+    for (uint64_t tick = m_currentTick + 1; tick <= m_currentTick + SLOTS; ++tick)
+    {
+        const TimerNode& head = m_slots[tick % SLOTS];
+        for (const TimerNode* node = head.m_next; node != &head;
+             node = node->m_next)
+        {
+            if (node->m_expiresTick == tick)
+                return tick;
+            earliest = std::min(earliest, node->m_expiresTick);
+        }
+    }
+    return earliest;
+}
+
+// Callbacks may disarm or destroy any node, including the one that
+// is firing, so the list is re-read after every call
+void TimerWheel::fire()
+{
+    while (m_firing.m_next != &m_firing)
+    {
+        TimerNode& node = *m_firing.m_next;
+        node.disarm();
+
+        std::function<void()> callback = node.onExpire;
+        if (callback)
+            callback();
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#ifndef TIMERWHEEL_HPP
+# define TIMERWHEEL_HPP
+
+# include <algorithm>
+# include <chrono>
+# include <climits>
+# include <cstdint>
+# include <functional>
+# include <vector>
+
+class TimerWheel;
+
+// Intrusive timer, embedded in the object it belongs to. A node unlinks
+// itself when destroyed, and copies are never armed, so owners stay
+// freely copyable and movable.
+struct TimerNode
+{
+    // Construction and destruction
+    TimerNode() = default;
+    TimerNode(const TimerNode& other);
+    TimerNode& operator=(const TimerNode& other);
+    ~TimerNode();
+
+    // Methods
+    bool isArmed() const;
+    void disarm();
+
+    // Properties
+    std::function<void()> onExpire;
+
+  private:
+    friend class TimerWheel;
+
+    TimerNode* m_prev = nullptr;
+    TimerNode* m_next = nullptr;
+    TimerWheel* m_wheel = nullptr;
+    uint64_t m_expiresTick = 0;
+};
+
+// Hashed timing wheel: arming and disarming are O(1), and every tick
+// only looks at the timers of its own slot. Timers further away than
+// one revolution stay in their slot until their tick comes.
+// The wheel isn't turned tick by tick: the poll timeout runs to the
+// earliest expiry, so idle connections don't wake the reactor.
+class TimerWheel
+{
+    // Construction and destruction
+  public:
+    TimerWheel();
+    TimerWheel(const TimerWheel& other) = delete;
+    TimerWheel& operator=(const TimerWheel& other) = delete;
+    TimerWheel(TimerWheel&& other) noexcept = delete;
+    TimerWheel& operator=(TimerWheel&& other) noexcept = delete;
+    ~TimerWheel();
+
+    // Class specific features
+  public:
+    // Constants
+    static constexpr uint64_t TICK_MS = 100;
+    static constexpr size_t SLOTS = 512;
+    // Methods
+    void arm(TimerNode& node, uint64_t delayMs);
+    void advance(uint64_t nowMs);
+    bool empty() const;
+    int nextTimeoutMs() const;
+
+    static uint64_t nowMs();
+
+  private:
+    // Properties
+    std::vector<TimerNode> m_slots; // list heads
+    TimerNode m_firing;
+    uint64_t m_currentTick;
+    size_t m_armed = 0;
+    uint64_t m_earliestTick = UINT64_MAX; // no timer expires before it
+    // Methods
+    static void link(TimerNode& head, TimerNode& node);
+    static void unlink(TimerNode& node);
+    void collectDue(TimerNode& head, uint64_t tick);
+    uint64_t findEarliestTick() const;
+    void fire();
+
+    friend struct TimerNode;
+};
+
+#endif
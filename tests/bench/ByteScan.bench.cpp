@@ -0,0 +1,96 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include "ByteScan.hpp"
+
+// Build with `make bench`, run ./runbench
+// Each scan runs on its own input for a fixed number of rounds and is
+// compared with std::string_view::find on the same input.
+
+namespace
+{
+    volatile size_t g_sink;
+
+    double nsPerScan(const std::function<size_t()>& scan, size_t rounds)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; ++i)
+            g_sink = scan();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / rounds;
+    }
+
+    void report(const char* name, size_t bytes, size_t rounds,
+                const std::function<size_t()>& baseline,
+                const std::function<size_t()>& scan)
+    {
+        double base = nsPerScan(baseline, rounds);
+        std::printf("  %-28s %8zu B  std %9.1f ns", name, bytes, base);
+        for (ByteScan::Level level : ByteScan::supportedLevels())
+        {
+            ByteScan::setLevel(level);
+            std::printf("  %s %9.1f ns", ByteScan::levelName(level),
+                        nsPerScan(scan, rounds));
+        }
+        std::printf("\n");
+    }
+
+    std::string browserRequest()
+    {
+        return "GET /static/app/main.css?v=42 HTTP/1.1\r\n"
+               "Host: www.example.com\r\n"
+               "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:128.0) "
+               "Gecko/20100101 Firefox/128.0\r\n"
+               "Accept: text/css,*/*;q=0.1\r\n"
+               "Accept-Language: en-US,en;q=0.5\r\n"
+               "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+               "Referer: https://www.example.com/\r\n"
+               "Connection: keep-alive\r\n"
+               "Cookie: session=8f14e45fceea167a5a36dedd4bea2543; theme=dark\r\n"
+               "Sec-Fetch-Dest: style\r\n"
+               "Sec-Fetch-Mode: no-cors\r\n"
+               "Sec-Fetch-Site: same-origin\r\n"
+               "If-Modified-Since: Tue, 01 Oct 2024 10:00:00 GMT\r\n"
+               "\r\n";
+    }
+}
+
+int main()
+{
+    const ByteScan::Level best = ByteScan::level();
+
+    const std::string head = browserRequest();
+    const std::string headerLine
+        = "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:128.0)";
+    const std::string uri(1024, 'a');
+    // An uploaded binary file: every byte value shows up, '\r' included
+    std::string body(1 << 20, '\0');
+    uint32_t seed = 42;
+    for (char& c : body)
+        c = static_cast<char>((seed = seed * 1664525 + 1013904223) >> 24);
+    const std::string boundary = "\r\n------WebKitFormBoundary7MA4YWxkTrZu0gW";
+    body.replace(body.size() - boundary.size(), boundary.size(), boundary);
+
+    std::printf("ByteScan, widest kernel: %s\n", ByteScan::levelName(best));
+
+    report("header end (request head)", head.size(), 1000000,
+           [&] { return std::string_view(head).find("\r\n\r\n"); },
+           [&] { return ByteScan::findHeaderEnd(head); });
+    report("colon (header line)", headerLine.size(), 1000000,
+           [&] { return std::string_view(headerLine).find(':', 11); },
+           [&] { return ByteScan::find(headerLine, ':', 11); });
+    report("control (request head)", head.size(), 1000000,
+           [&] { return std::string_view(head).find_first_of(std::string_view("\0\x7f", 2)); },
+           [&] { return ByteScan::findControl(head); });
+    report("percent (uri)", uri.size(), 200000,
+           [&] { return std::string_view(uri).find('%'); },
+           [&] { return ByteScan::find(uri, '%'); });
+    report("boundary (1 MiB body)", body.size(), 200,
+           [&] { return std::string_view(body).find(boundary); },
+           [&] { return ByteScan::find(body, boundary); });
+
+    ByteScan::setLevel(best);
+    return 0;
+}
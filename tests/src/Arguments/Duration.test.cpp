@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "Duration.hpp"
+
+// ------------------------ CONSTRUCTION TESTS -----------------------
+TEST(DurationTest, DefaultConstructor)
+{
+    Duration d;
+    EXPECT_EQ(d.milliseconds(), 0u);
+}
+
+TEST(DurationTest, NumberWithoutUnitIsSeconds)
+{
+    Duration d("75");
+    EXPECT_EQ(d.milliseconds(), 75000u);
+}
+
+TEST(DurationTest, ConstructWithUnits)
+{
+    EXPECT_EQ(Duration("500ms").milliseconds(), 500u);
+    EXPECT_EQ(Duration("30s").milliseconds(), 30000u);
+    EXPECT_EQ(Duration("5m").milliseconds(), 300000u);
+    EXPECT_EQ(Duration("1h").milliseconds(), 3600000u);
+    EXPECT_EQ(Duration("1d").milliseconds(), 86400000u);
+}
+
+TEST(DurationTest, ConstructFromInvalidStringEmpty)
+{
+    EXPECT_THROW(Duration(""), std::invalid_argument);
+}
+
+TEST(DurationTest, ConstructFromInvalidUnit)
+{
+    EXPECT_THROW(Duration("10x"), std::invalid_argument);
+    EXPECT_THROW(Duration("10sec"), std::invalid_argument);
+}
+
+TEST(DurationTest, ConstructFromInvalidNumber)
+{
+    EXPECT_THROW(Duration("s"), std::invalid_argument);
+    EXPECT_THROW(Duration("-5s"), std::invalid_argument);
+    EXPECT_THROW(Duration("1.5s"), std::invalid_argument);
+}
+
+// ------------------------ COPY / MOVE TESTS -----------------------
+TEST(DurationTest, CopyAndMove)
+{
+    Duration d("2m");
+    Duration copy(d);
+    EXPECT_EQ(copy.milliseconds(), 120000u);
+
+    Duration moved(std::move(copy));
+    EXPECT_EQ(moved.milliseconds(), 120000u);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "ByteRange.hpp"
+
+using ByteRanges::Result;
+
+TEST(ByteRangeTest, IgnoresMissingOrForeignUnits)
+{
+    std::vector<ByteRange> ranges;
+    EXPECT_EQ(ByteRanges::parse("", 100, ranges), Result::Ignored);
+    EXPECT_EQ(ByteRanges::parse("items=0-5", 100, ranges), Result::Ignored);
+    EXPECT_EQ(ByteRanges::parse("bytes=", 100, ranges), Result::Ignored);
+}
+
+TEST(ByteRangeTest, IgnoresMalformedSpecs)
+{
+    std::vector<ByteRange> ranges;
+    EXPECT_EQ(ByteRanges::parse("bytes=5", 100, ranges), Result::Ignored);
+    EXPECT_EQ(ByteRanges::parse("bytes=9-5", 100, ranges), Result::Ignored);
+    EXPECT_EQ(ByteRanges::parse("bytes=a-5", 100, ranges), Result::Ignored);
+    EXPECT_EQ(ByteRanges::parse("bytes=0-1, x", 100, ranges), Result::Ignored);
+    EXPECT_EQ(ByteRanges::parse("bytes=--5", 100, ranges), Result::Ignored);
+}
+
+TEST(ByteRangeTest, SingleRanges)
+{
+    std::vector<ByteRange> ranges;
+
+    ASSERT_EQ(ByteRanges::parse("bytes=0-9", 100, ranges), Result::Satisfiable);
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].first, 0);
+    EXPECT_EQ(ranges[0].last, 9);
+    EXPECT_EQ(ranges[0].length(), 10u);
+
+    ASSERT_EQ(ByteRanges::parse("bytes=90-", 100, ranges), Result::Satisfiable);
+    EXPECT_EQ(ranges[0].first, 90);
+    EXPECT_EQ(ranges[0].last, 99);
+
+    ASSERT_EQ(ByteRanges::parse("bytes=-10", 100, ranges), Result::Satisfiable);
+    EXPECT_EQ(ranges[0].first, 90);
+    EXPECT_EQ(ranges[0].last, 99);
+}
+
+TEST(ByteRangeTest, ClampsToTheFile)
+{
+    std::vector<ByteRange> ranges;
+
+    ASSERT_EQ(ByteRanges::parse("bytes=50-500", 100, ranges), Result::Satisfiable);
+    EXPECT_EQ(ranges[0].last, 99);
+
+    ASSERT_EQ(ByteRanges::parse("bytes=-500", 100, ranges), Result::Satisfiable);
+    EXPECT_EQ(ranges[0].first, 0);
+}
+
+TEST(ByteRangeTest, MultipleRanges)
+{
+    std::vector<ByteRange> ranges;
+
+    ASSERT_EQ(ByteRanges::parse("bytes=0-0, 10-19 ,-1", 100, ranges),
+              Result::Satisfiable);
+    ASSERT_EQ(ranges.size(), 3u);
+    EXPECT_EQ(ranges[1].first, 10);
+    EXPECT_EQ(ranges[2].first, 99);
+}
+
+TEST(ByteRangeTest, Unsatisfiable)
+{
+    std::vector<ByteRange> ranges;
+
+    EXPECT_EQ(ByteRanges::parse("bytes=100-", 100, ranges), Result::Unsatisfiable);
+    EXPECT_EQ(ByteRanges::parse("bytes=-0", 100, ranges), Result::Unsatisfiable);
+    EXPECT_EQ(ByteRanges::parse("bytes=0-", 0, ranges), Result::Unsatisfiable);
+
+    // Only the satisfiable ones are kept
+    ASSERT_EQ(ByteRanges::parse("bytes=200-300, 0-4", 100, ranges),
+              Result::Satisfiable);
+    EXPECT_EQ(ranges.size(), 1u);
+}
+
+TEST(ByteRangeTest, TooManyRangesAreIgnored)
+{
+    std::vector<ByteRange> ranges;
+    std::string header = "bytes=0-0";
+    for (size_t i = 1; i <= ByteRanges::MAX_RANGES; ++i)
+        header += "," + std::to_string(i) + "-" + std::to_string(i);
+
+    EXPECT_EQ(ByteRanges::parse(header, 100, ranges), Result::Ignored);
+}
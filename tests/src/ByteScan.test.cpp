@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "ByteScan.hpp"
+
+// Every kernel the CPU has must agree with std::string_view::find
+class ByteScanTest : public ::testing::TestWithParam<ByteScan::Level>
+{
+  protected:
+    ByteScan::Level saved = ByteScan::level();
+
+    void SetUp() override { ByteScan::setLevel(GetParam()); }
+    void TearDown() override { ByteScan::setLevel(saved); }
+
+    static size_t findControlSlow(std::string_view data, size_t from)
+    {
+        for (size_t i = from; i < data.size(); ++i)
+        {
+            unsigned char c = data[i];
+            if ((c < 0x20 && c != '\t') || c == 0x7f)
+                return i;
+        }
+        return ByteScan::npos;
+    }
+};
+
+TEST_P(ByteScanTest, FindsAtEveryOffset)
+{
+    for (size_t size = 0; size < 80; ++size)
+    {
+        for (size_t at = 0; at < size; ++at)
+        {
+            std::string data(size, 'a');
+            data[at] = ':';
+            EXPECT_EQ(ByteScan::find(data, ':'), at);
+            EXPECT_EQ(ByteScan::find(data, ':', at + 1), ByteScan::npos);
+
+            if (at + 4 <= size)
+            {
+                data.replace(at, 4, "\r\n\r\n");
+                EXPECT_EQ(ByteScan::findHeaderEnd(data), at) << size << " " << at;
+                EXPECT_EQ(ByteScan::find(data, "\r\n\r\n"), at);
+                EXPECT_EQ(ByteScan::findControl(data), at);
+            }
+        }
+    }
+}
+
+TEST_P(ByteScanTest, MatchesTheStandardLibrary)
+{
+    std::mt19937 rng(42);
+    const std::string alphabet = "ab-\r\n:%\t\x7f\x80\xff";
+    const std::string needles[] = {"--b", "\r\n--ab", "a", "", "ab-ab-ab-ab-ab-ab-ab"};
+
+    for (int round = 0; round < 2000; ++round)
+    {
+        std::string data(rng() % 200, '\0');
+        for (char& c : data)
+            c = alphabet[rng() % alphabet.size()];
+        size_t from = data.empty() ? 0 : rng() % (data.size() + 1);
+        std::string_view view(data);
+
+        EXPECT_EQ(ByteScan::find(view, ':', from), view.find(':', from));
+        EXPECT_EQ(ByteScan::findHeaderEnd(view, from), view.find("\r\n\r\n", from));
+        EXPECT_EQ(ByteScan::findControl(view, from), findControlSlow(view, from));
+        for (const std::string& needle : needles)
+            EXPECT_EQ(ByteScan::find(view, needle, from), view.find(needle, from))
+                << "needle '" << needle << "' from " << from;
+    }
+}
+
+TEST_P(ByteScanTest, ControlCharacters)
+{
+    EXPECT_EQ(ByteScan::findControl("text/html;\tq=0.9"), ByteScan::npos);
+    EXPECT_EQ(ByteScan::findControl("caf\xc3\xa9"), ByteScan::npos);
+    EXPECT_EQ(ByteScan::findControl(std::string("a\0b", 3)), 1u);
+    EXPECT_EQ(ByteScan::findControl("ab\x7f"), 2u);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Kernels, ByteScanTest, ::testing::ValuesIn(ByteScan::supportedLevels()),
+    [](const ::testing::TestParamInfo<ByteScan::Level>& info) {
+        return std::string(ByteScan::levelName(info.param));
+    });
@@ -613,3 +613,16 @@ TEST_F(ConfigTest, RequestContext_RandomPage_Site2Local)
         .hasNoUploadStore()
         .hasNoCgiHandlers();
 }
+
+TEST_F(ConfigTest, BodySettings_MatchRequestContext)
+{
+    BodySettings settings = config->bodySettings(NetworkEndpoint(8080), "site1.local", "/kapouet");
+    EXPECT_EQ(settings.maxSize, 20ul * 1024 * 1024);
+    EXPECT_EQ(settings.bufferSize, 16ul * 1024);
+    EXPECT_EQ(settings.tempPath, "/tmp");
+    EXPECT_EQ(config->bodySettings(NetworkEndpoint(9090), "site2.local", "/profile").maxSize, 20ul * 1024 * 1024);
+
+    for (const char* uri : {"/", "/upload", "/list/x", "/oldpage"})
+        EXPECT_EQ(config->bodySettings(NetworkEndpoint(8080), "site1.local", uri).maxSize,
+                  config->createRequestContext(NetworkEndpoint(8080), "site1.local", uri).client_max_body_size);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "TempFile/TempFile.hpp"
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include "ErrorPages.hpp"
+
+class ErrorPagesTest : public TempFileTest
+{
+  protected:
+    ErrorPagesTest() : TempFileTest("not here") {}
+
+    ErrorPages pages;
+};
+
+TEST_F(ErrorPagesTest, DefaultPagesAreRenderedOnce)
+{
+    CachedResponse page = ErrorPages::defaultPage(HttpStatusCode::NotFound);
+    ASSERT_TRUE(page.headers && page.body);
+    EXPECT_NE(page.body->find("<title>404 Not Found</title>"), std::string::npos);
+    EXPECT_NE(page.headers->find("Content-Length: "
+                                 + std::to_string(page.body->size()) + "\r\n"),
+              std::string::npos);
+
+    EXPECT_EQ(ErrorPages::defaultPage(HttpStatusCode::NotFound).body, page.body);
+}
+
+TEST_F(ErrorPagesTest, ServesTheFileFromMemory)
+{
+    pages.add(0, "/404.html", path, "text/html");
+
+    CachedResponse page = pages.customPage(0, "/404.html");
+    ASSERT_TRUE(page.body);
+    EXPECT_EQ(*page.body, "not here");
+    EXPECT_NE(page.headers->find("Content-Type: text/html\r\n"), std::string::npos);
+
+    EXPECT_EQ(pages.customPage(0, "/404.html").body, page.body);
+    EXPECT_FALSE(pages.customPage(0, "/500.html").body);
+    EXPECT_FALSE(pages.customPage(1, "/404.html").body);
+}
+
+TEST_F(ErrorPagesTest, GzipVariantIsBuiltWithThePage)
+{
+    writeFile(std::string(200, 'x'));
+    pages.add(0, "/404.html", path, "text/plain");
+
+    CachedResponse page = pages.customPage(0, "/404.html");
+    ASSERT_TRUE(page.gzipped);
+    EXPECT_EQ(page.mimeType, "text/plain");
+    EXPECT_LT(page.gzipped->body->size(), page.body->size());
+    EXPECT_NE(page.gzipped->headers->find(
+                  "Content-Length: " + std::to_string(page.gzipped->body->size())
+                  + "\r\nContent-Encoding: gzip\r\n"),
+              std::string::npos);
+}
+
+TEST_F(ErrorPagesTest, RereadsAChangedFile)
+{
+    pages.add(0, "/404.html", path, "text/html");
+    CachedResponse before = pages.customPage(0, "/404.html");
+
+    writeFile("gone for good");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    CachedResponse after = pages.customPage(0, "/404.html");
+    ASSERT_TRUE(after.body);
+    EXPECT_EQ(*after.body, "gone for good");
+    EXPECT_EQ(*before.body, "not here"); // in-flight responses keep theirs
+}
+
+TEST_F(ErrorPagesTest, MissingFileIsNotServed)
+{
+    pages.add(0, "/missing.html", path + ".missing", "text/html");
+    EXPECT_FALSE(pages.customPage(0, "/missing.html").body);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <fstream>
+#include <unistd.h>
+#include <zlib.h>
+#include "TempFile/TempFile.hpp"
+#include "GzipEncoder.hpp"
+#include "GzipFileStream.hpp"
+
+static std::string gunzip(const std::string& data)
+{
+    z_stream stream{};
+    EXPECT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+
+    std::string out;
+    char buf[16384];
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = data.size();
+    int ret;
+    do
+    {
+        stream.next_out = reinterpret_cast<Bytef*>(buf);
+        stream.avail_out = sizeof(buf);
+        ret = inflate(&stream, Z_NO_FLUSH);
+        out.append(buf, sizeof(buf) - stream.avail_out);
+    } while (ret == Z_OK);
+    EXPECT_EQ(ret, Z_STREAM_END);
+
+    inflateEnd(&stream);
+    return out;
+}
+
+// Undoes the chunked framing, and checks it on the way
+static std::string unchunk(const std::string& data)
+{
+    std::string out;
+    size_t pos = 0;
+    while (true)
+    {
+        size_t eol = data.find("\r\n", pos);
+        EXPECT_NE(eol, std::string::npos);
+        size_t size = std::stoul(data.substr(pos, eol - pos), nullptr, 16);
+        pos = eol + 2;
+        if (size == 0)
+        {
+            EXPECT_EQ(data.substr(pos), "\r\n");
+            return out;
+        }
+        out += data.substr(pos, size);
+        pos += size;
+        EXPECT_EQ(data.substr(pos, 2), "\r\n");
+        pos += 2;
+    }
+}
+
+static std::string sample(size_t size)
+{
+    std::string text;
+    while (text.size() < size)
+        text += "<li>entry " + std::to_string(text.size() % 97) + "</li>\n";
+    return text.substr(0, size);
+}
+
+TEST(GzipEncoderTest, CompressRoundTrips)
+{
+    const std::string text = sample(10000);
+    const std::string compressed = GzipEncoder::compress(text, 6);
+
+    EXPECT_LT(compressed.size(), text.size());
+    EXPECT_EQ(gunzip(compressed), text);
+}
+
+TEST(GzipEncoderTest, IncrementalEqualsWhole)
+{
+    const std::string text = sample(50000);
+    GzipEncoder encoder(1);
+
+    std::string compressed;
+    for (size_t i = 0; i < text.size(); i += 777)
+        compressed += encoder.update(text.data() + i,
+                                     std::min<size_t>(777, text.size() - i));
+    compressed += encoder.finish();
+
+    EXPECT_EQ(gunzip(compressed), text);
+}
+
+TEST(GzipFileStreamTest, ProducesAChunkedGzipBody)
+{
+    const std::string text = sample(3 * GzipFileStream::READ_SIZE + 5);
+    TempFile tmp(text);
+    int fd = open(tmp.path().c_str(), O_RDONLY);
+    ASSERT_NE(fd, -1);
+
+    FileBody file;
+    file.fd = std::make_shared<FdGuard>(fd);
+    file.offset = 5;
+    file.length = text.size() - 5;
+
+    GzipFileStream stream(file, 1);
+    std::string body;
+    std::string piece;
+    while (!stream.finished())
+    {
+        ASSERT_TRUE(stream.next(piece));
+        ASSERT_FALSE(piece.empty());
+        body += piece;
+    }
+
+    EXPECT_EQ(gunzip(unchunk(body)), text.substr(5));
+}
+
+TEST(GzipFileStreamTest, FailsOnATruncatedFile)
+{
+    TempFile tmp;
+    int fd = open(tmp.path().c_str(), O_RDONLY);
+    ASSERT_NE(fd, -1);
+
+    FileBody file;
+    file.fd = std::make_shared<FdGuard>(fd);
+    file.length = 100; // the file is empty
+
+    GzipFileStream stream(file, 1);
+    std::string piece;
+    EXPECT_FALSE(stream.next(piece));
+    EXPECT_EQ(errno, EIO);
+}
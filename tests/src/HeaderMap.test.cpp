@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "HeaderMap.hpp"
+#include <cctype>
+#include <vector>
+
+TEST(HeaderMapTest, EveryWellKnownNameHasItsOwnId)
+{
+    for (size_t i = 0; i < HeaderMap::KNOWN; ++i)
+    {
+        std::string lowered(HeaderMap::NAMES[i]);
+        for (char& c : lowered)
+            c = std::tolower(static_cast<unsigned char>(c));
+
+        EXPECT_EQ(HeaderMap::idOf(HeaderMap::NAMES[i]), static_cast<HeaderMap::Id>(i));
+        EXPECT_EQ(HeaderMap::idOf(lowered), static_cast<HeaderMap::Id>(i));
+    }
+    EXPECT_EQ(HeaderMap::idOf("X-Custom"), HeaderMap::Id::Other);
+    EXPECT_EQ(HeaderMap::idOf("Hosts"), HeaderMap::Id::Other);
+    EXPECT_EQ(HeaderMap::idOf(""), HeaderMap::Id::Other);
+}
+
+TEST(HeaderMapTest, LookupIgnoresCase)
+{
+    HeaderMap headers;
+    headers["content-TYPE"] = "text/html";
+    headers["X-Custom"] = "1";
+
+    EXPECT_EQ(headers.get("Content-Type"), "text/html");
+    EXPECT_EQ(headers.get("x-custom"), "1");
+    EXPECT_EQ(headers.count("CONTENT-type"), 1u);
+    EXPECT_EQ(headers.get("Host"), "");
+    EXPECT_EQ(headers.find("Host"), headers.end());
+
+    // Setting an existing name replaces its value
+    headers["Content-Type"] = "text/plain";
+    headers["x-CUSTOM"] = "2";
+    EXPECT_EQ(headers.size(), 2u);
+    EXPECT_EQ(headers.get("content-type"), "text/plain");
+    EXPECT_EQ(headers.get("X-Custom"), "2");
+}
+
+TEST(HeaderMapTest, KeepsInsertionOrderAndCanonicalNames)
+{
+    HeaderMap headers;
+    headers["x-first"] = "a";
+    headers["content-length"] = "3";
+    headers["HOST"] = "example.com";
+
+    std::vector<std::string> names;
+    for (const auto& [name, value] : headers)
+        names.push_back(name);
+    EXPECT_EQ(names, (std::vector<std::string>{"x-first", "Content-Length", "Host"}));
+}
+
+TEST(HeaderMapTest, EraseKeepsTheOtherSlotsValid)
+{
+    HeaderMap headers;
+    headers["Date"] = "d";
+    headers["X-One"] = "1";
+    headers["Server"] = "s";
+    headers["Content-Length"] = "0";
+
+    EXPECT_EQ(headers.erase("date"), 1u);
+    EXPECT_EQ(headers.erase("Date"), 0u);
+    EXPECT_EQ(headers.size(), 3u);
+    EXPECT_EQ(headers.get("Server"), "s");
+    EXPECT_EQ(headers.get("Content-Length"), "0");
+    EXPECT_EQ(headers.get("x-one"), "1");
+
+    EXPECT_EQ(headers.erase("X-ONE"), 1u);
+    EXPECT_EQ(headers.get("Server"), "s");
+    EXPECT_EQ(headers.find("Content-Length")->second, "0");
+
+    headers["Date"] = "again";
+    EXPECT_EQ(headers.begin()->first, "Server");
+    EXPECT_EQ(headers.get("Date"), "again");
+
+    headers.clear();
+    EXPECT_TRUE(headers.empty());
+    EXPECT_EQ(headers.count("Server"), 0u);
+}
+
+TEST(HeaderMapTest, ViewsConvertToAnOwnedMap)
+{
+    std::string block = "x-first: a";
+    HeaderViewMap views;
+    views[std::string_view(block).substr(0, 7)] = std::string_view(block).substr(9);
+    views["content-length"] = "3";
+
+    HeaderMap owned(views);
+    block.assign(block.size(), '?');
+
+    EXPECT_EQ(owned.size(), 2u);
+    EXPECT_EQ(owned.get("X-First"), "a");
+    EXPECT_EQ(owned.begin()->first, "x-first");
+    EXPECT_EQ(owned.get("Content-Length"), "3");
+    owned.erase("x-first");
+    EXPECT_EQ(owned.get("content-length"), "3");
+}
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+#include "HttpDate.hpp"
+
+TEST(HttpDateTest, FormatsAndParsesImfFixdate)
+{
+    EXPECT_EQ(HttpDate::format(784111777), "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    std::time_t parsed = 0;
+    ASSERT_TRUE(HttpDate::parse("Sun, 06 Nov 1994 08:49:37 GMT", parsed));
+    EXPECT_EQ(parsed, 784111777);
+    EXPECT_FALSE(HttpDate::parse("Sunday, 06-Nov-94 08:49:37 GMT", parsed));
+}
+
+TEST(HttpDateTest, CachedDateFollowsRefresh)
+{
+    HttpDate::refresh(784111777);
+    const std::string& date = HttpDate::cached();
+    EXPECT_EQ(date, "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    // Same second: the string is reused, not reformatted
+    HttpDate::refresh(784111777);
+    EXPECT_EQ(&HttpDate::cached(), &date);
+    EXPECT_EQ(HttpDate::cached(), "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    HttpDate::refresh(784111778);
+    EXPECT_EQ(HttpDate::cached(), "Sun, 06 Nov 1994 08:49:38 GMT");
+
+    HttpDate::refresh(std::time(nullptr));
+}
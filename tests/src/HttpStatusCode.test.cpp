@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "HttpStatusCode.hpp"
+#include "ResponseData.hpp"
+
+TEST(StatusLineTest, RendersKnownCodes)
+{
+    EXPECT_EQ(statusLine(HttpStatusCode::OK), "HTTP/1.1 200 OK\r\n");
+    EXPECT_EQ(statusLine(HttpStatusCode::Continue), "HTTP/1.1 100 Continue\r\n");
+    EXPECT_EQ(statusLine(HttpStatusCode::NetworkAuthenticationRequired),
+              "HTTP/1.1 511 Network Authentication Required\r\n");
+}
+
+TEST(StatusLineTest, MatchesReasonPhrases)
+{
+    for (int code = 100; code < 600; ++code)
+    {
+        HttpStatusCode status = static_cast<HttpStatusCode>(code);
+        std::string_view line = statusLine(status);
+        if (line.empty())
+            continue;
+        EXPECT_EQ(line, "HTTP/1.1 " + std::to_string(code) + " "
+                            + codeToText(status) + "\r\n");
+    }
+}
+
+TEST(StatusLineTest, UnknownCodesHaveNoLine)
+{
+    EXPECT_TRUE(statusLine(HttpStatusCode::None).empty());
+    EXPECT_TRUE(statusLine(static_cast<HttpStatusCode>(299)).empty());
+}
+
+TEST(StatusLineTest, SerializedHeadStartsWithStatusLine)
+{
+    ResponseData data;
+    data.statusCode = 404;
+    data.statusText = "Not Found";
+    data.addHeader("Content-Length", "0");
+    EXPECT_EQ(data.serializeHead(),
+              "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+
+    data.statusCode = 299;
+    data.statusText = "Custom";
+    EXPECT_EQ(data.serializeHead(),
+              "HTTP/1.1 299 Custom\r\nContent-Length: 0\r\n\r\n");
+}
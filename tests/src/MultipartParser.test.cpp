@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+#include "MultipartParser.hpp"
+#include <dirent.h>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const std::string BODY
+        = "preamble\r\n"
+          "--XyZ\r\n"
+          "Content-Disposition: form-data; name=\"title\"\r\n"
+          "\r\n"
+          "not a file\r\n"
+          "--XyZ\r\n"
+          "Content-Disposition: form-data; name=\"files[]\"; filename=\"a.txt\"\r\n"
+          "Content-Type: text/plain\r\n"
+          "\r\n"
+          "line one\r\n--XyNot the boundary\r\n\r\n--X\r\r\n"
+          "--XyZ\r\n"
+          "Content-Disposition: form-data; name=\"files[]\"; filename=\"b.bin\"\r\n"
+          "\r\n"
+          "\r\n"
+          "--XyZ--\r\n"
+          "epilogue";
+    const std::string A_CONTENTS = "line one\r\n--XyNot the boundary\r\n\r\n--X\r";
+
+    std::string readFile(const std::string& path)
+    {
+        std::string contents;
+        int fd = open(path.c_str(), O_RDONLY);
+        char buf[4096];
+        ssize_t n;
+        while (fd != -1 && (n = read(fd, buf, sizeof(buf))) > 0)
+            contents.append(buf, n);
+        if (fd != -1)
+            close(fd);
+        return contents;
+    }
+
+    bool exists(const std::string& path)
+    {
+        struct stat st;
+        return stat(path.c_str(), &st) == 0;
+    }
+
+    void writeFile(const std::string& path, const std::string& contents)
+    {
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ssize_t written = write(fd, contents.data(), contents.size());
+        (void)written;
+        close(fd);
+    }
+
+    size_t entryCount(const std::string& dir)
+    {
+        size_t count = 0;
+        DIR* d = opendir(dir.c_str());
+        while (dirent* entry = d ? readdir(d) : nullptr)
+            if (std::string(entry->d_name) != "." && std::string(entry->d_name) != "..")
+                ++count;
+        if (d)
+            closedir(d);
+        return count;
+    }
+
+    class MultipartParserTest : public ::testing::Test
+    {
+      protected:
+        std::string store;
+
+        void SetUp() override
+        {
+            char name[] = "/tmp/webserv_multipart_XXXXXX";
+            ASSERT_NE(mkdtemp(name), nullptr);
+            store = name;
+        }
+
+        void TearDown() override
+        {
+            unlink((store + "/a.txt").c_str());
+            unlink((store + "/b.bin").c_str());
+            rmdir(store.c_str());
+        }
+    };
+}
+
+TEST(MultipartParserStatic, ExtractBoundary)
+{
+    EXPECT_EQ(MultipartParser::extractBoundary("multipart/form-data; boundary=abc"), "abc");
+    EXPECT_EQ(MultipartParser::extractBoundary(
+        "multipart/form-data; boundary=\"----WebKitFormBoundary7sX\""), "----WebKitFormBoundary7sX");
+    EXPECT_EQ(MultipartParser::extractBoundary("multipart/form-data; boundary=abc; charset=utf-8"), "abc");
+    EXPECT_EQ(MultipartParser::extractBoundary("multipart/form-data"), "");
+}
+
+TEST_F(MultipartParserTest, WritesOnlyTheFileParts)
+{
+    {
+        MultipartParser parser("XyZ", store);
+        parser.feed(BODY);
+
+        EXPECT_TRUE(parser.isDone());
+        EXPECT_EQ(parser.savedFiles(), (std::vector<std::string>{store + "/a.txt", store + "/b.bin"}));
+    }
+    EXPECT_EQ(readFile(store + "/a.txt"), A_CONTENTS);
+    EXPECT_EQ(readFile(store + "/b.bin"), "");
+}
+
+// A delimiter may be split anywhere between two reads
+TEST_F(MultipartParserTest, SplitAtEveryPosition)
+{
+    for (size_t split = 0; split <= BODY.size(); ++split)
+    {
+        MultipartParser parser("XyZ", store);
+        parser.feed(std::string_view(BODY).substr(0, split));
+        parser.feed(std::string_view(BODY).substr(split));
+
+        ASSERT_TRUE(parser.isDone()) << "split at " << split;
+        ASSERT_EQ(readFile(store + "/a.txt"), A_CONTENTS) << "split at " << split;
+    }
+}
+
+TEST_F(MultipartParserTest, ByteByByte)
+{
+    MultipartParser parser("XyZ", store);
+    for (char c : BODY)
+        parser.feed(std::string_view(&c, 1));
+
+    EXPECT_TRUE(parser.isDone());
+    EXPECT_EQ(readFile(store + "/a.txt"), A_CONTENTS);
+}
+
+TEST_F(MultipartParserTest, BoundaryRightAtTheStart)
+{
+    MultipartParser parser("XyZ", store);
+    parser.feed("--XyZ\r\n"
+                "Content-Disposition: form-data; name=\"f\"; filename=\"a.txt\"\r\n"
+                "\r\n"
+                "data\r\n"
+                "--XyZ--");
+
+    EXPECT_TRUE(parser.isDone());
+    EXPECT_EQ(readFile(store + "/a.txt"), "data");
+}
+
+TEST_F(MultipartParserTest, IncompleteUploadLeavesNoFiles)
+{
+    {
+        MultipartParser parser("XyZ", store);
+        parser.feed(BODY.substr(0, BODY.find("--XyZ--")));
+        EXPECT_FALSE(parser.isDone());
+        EXPECT_TRUE(exists(store + "/a.txt"));
+    }
+    EXPECT_FALSE(exists(store + "/a.txt"));
+    EXPECT_FALSE(exists(store + "/b.bin"));
+}
+
+TEST_F(MultipartParserTest, Malformed)
+{
+    MultipartParser garbage("XyZ", store);
+    garbage.feed("--XyZ\r\n\r\ndata\r\n--XyZ!\r\n");
+    EXPECT_TRUE(garbage.isMalformed());
+    EXPECT_FALSE(garbage.isDone());
+
+    MultipartParser hugeHeaders("XyZ", store);
+    hugeHeaders.feed("--XyZ\r\nX-Big: ");
+    hugeHeaders.feed(std::string(MultipartParser::MAX_PART_HEADERS, 'a'));
+    EXPECT_TRUE(hugeHeaders.isMalformed());
+}
+
+TEST_F(MultipartParserTest, MissingUploadStore)
+{
+    MultipartParser parser("XyZ", store + "/missing");
+    parser.feed(BODY);
+    EXPECT_TRUE(parser.hasFailed());
+    EXPECT_FALSE(parser.isDone());
+}
+
+TEST_F(MultipartParserTest, PartIsOnlyVisibleOnceComplete)
+{
+    MultipartParser parser("XyZ", store);
+    size_t dataStart = BODY.find("line one");
+    parser.feed(BODY.substr(0, dataStart + 4));
+
+    EXPECT_FALSE(exists(store + "/a.txt"));
+    EXPECT_EQ(entryCount(store), 0u);
+
+    parser.feed(BODY.substr(dataStart + 4));
+    EXPECT_TRUE(parser.isDone());
+    EXPECT_EQ(entryCount(store), 2u);
+}
+
+TEST_F(MultipartParserTest, AbortedUploadKeepsAnExistingFile)
+{
+    writeFile(store + "/a.txt", "already there");
+    {
+        MultipartParser parser("XyZ", store);
+        parser.feed(BODY.substr(0, BODY.find("--X\r\r\n")));
+        EXPECT_FALSE(parser.isDone());
+    }
+    EXPECT_EQ(readFile(store + "/a.txt"), "already there");
+    EXPECT_EQ(entryCount(store), 1u);
+}
+
+TEST_F(MultipartParserTest, CompleteUploadReplacesAnExistingFile)
+{
+    writeFile(store + "/a.txt", "already there");
+    {
+        MultipartParser parser("XyZ", store);
+        parser.feed(BODY);
+        EXPECT_TRUE(parser.isDone());
+    }
+    EXPECT_EQ(readFile(store + "/a.txt"), A_CONTENTS);
+    EXPECT_EQ(entryCount(store), 2u);
+}
+
+// A complete part waits for the rest of the form before it replaces
+// anything: a cut off upload leaves existing files as they were
+TEST_F(MultipartParserTest, AbortAfterAFirstCompletePartKeepsTheExistingFile)
+{
+    writeFile(store + "/a.txt", "already there");
+    {
+        MultipartParser parser("XyZ", store);
+        parser.feed(BODY.substr(0, BODY.find("--XyZ--")));
+        EXPECT_FALSE(parser.isDone());
+        EXPECT_EQ(readFile(store + "/a.txt"), "already there");
+    }
+    EXPECT_EQ(readFile(store + "/a.txt"), "already there");
+    EXPECT_FALSE(exists(store + "/b.bin"));
+    EXPECT_EQ(entryCount(store), 1u);
+}
+
+TEST_F(MultipartParserTest, MalformedLaterPartKeepsTheExistingFile)
+{
+    writeFile(store + "/a.txt", "already there");
+    {
+        MultipartParser parser("XyZ", store);
+        size_t secondPart = BODY.find("--XyZ\r\nContent-Disposition: form-data; name=\"files[]\"; filename=\"b.bin\"");
+        parser.feed(BODY.substr(0, secondPart + 5));
+        parser.feed("garbage");
+        EXPECT_TRUE(parser.isMalformed());
+    }
+    EXPECT_EQ(readFile(store + "/a.txt"), "already there");
+    EXPECT_EQ(entryCount(store), 1u);
+}
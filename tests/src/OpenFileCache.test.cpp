@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "TempFile/TempFile.hpp"
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include "OpenFileCache.hpp"
+
+class OpenFileCacheTest : public TempFileTest
+{
+  protected:
+    OpenFileCacheTest() : TempFileTest("hello") {}
+
+    OpenFileCache cache;
+
+    OpenFileCache::Settings enabled(size_t validMs = 60000, size_t minUses = 1,
+                                    bool cacheErrors = false)
+    {
+        OpenFileCache::Settings settings;
+        settings.maxEntries = 2;
+        settings.validMs = validMs;
+        settings.minUses = minUses;
+        settings.cacheErrors = cacheErrors;
+        return settings;
+    }
+};
+
+TEST_F(OpenFileCacheTest, DisabledByDefault)
+{
+    FileInfo info = cache.stat(path);
+    EXPECT_TRUE(info.exists);
+    EXPECT_TRUE(info.isFile);
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.open(path).length, 5u);
+}
+
+TEST_F(OpenFileCacheTest, SharesTheFdOfAHotFile)
+{
+    cache.configure(enabled());
+
+    FileBody first = cache.open(path);
+    FileBody second = cache.open(path);
+    EXPECT_EQ(first.length, 5u);
+    EXPECT_EQ(first.fd, second.fd);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST_F(OpenFileCacheTest, KeepsTheFdAfterMinUses)
+{
+    cache.configure(enabled(60000, 2));
+
+    FileBody first = cache.open(path);
+    FileBody second = cache.open(path);
+    FileBody third = cache.open(path);
+    EXPECT_NE(first.fd, second.fd);
+    EXPECT_EQ(second.fd, third.fd);
+}
+
+TEST_F(OpenFileCacheTest, ServesStaleDataUntilRevalidated)
+{
+    cache.configure(enabled(50));
+    EXPECT_EQ(cache.open(path).length, 5u);
+
+    writeFile("hello world");
+    EXPECT_EQ(cache.open(path).length, 5u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(cache.open(path).length, 11u);
+}
+
+TEST_F(OpenFileCacheTest, MissingFilesOnlyCachedWithErrors)
+{
+    std::string missing = path + "_missing";
+
+    cache.configure(enabled());
+    EXPECT_FALSE(cache.stat(missing).exists);
+    EXPECT_EQ(cache.size(), 0u);
+
+    cache.configure(enabled(60000, 1, true));
+    EXPECT_FALSE(cache.stat(missing).exists);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_THROW(cache.open(missing), std::runtime_error);
+}
+
+TEST_F(OpenFileCacheTest, InvalidateForgetsThePath)
+{
+    cache.configure(enabled());
+    cache.stat(path);
+    cache.invalidate(path);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(OpenFileCacheTest, EvictsLeastRecentlyUsed)
+{
+    cache.configure(enabled());
+    cache.stat(path);
+    cache.stat("/tmp");
+    cache.stat(path);
+    cache.stat("/");
+    EXPECT_EQ(cache.size(), 2u);
+
+    // 'path' was used last before '/', so '/tmp' went away
+    unlink(path.c_str());
+    EXPECT_TRUE(cache.stat(path).exists);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "TempFile/TempFile.hpp"
+#include "OutputQueue.hpp"
+#include "FileReader.hpp"
+
+class OutputQueueTest : public ::testing::Test
+{
+  protected:
+    int fds[2] = {-1, -1};
+
+    void SetUp() override
+    {
+        ASSERT_EQ(pipe(fds), 0);
+        fcntl(fds[1], F_SETFL, O_NONBLOCK);
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    }
+
+    void TearDown() override
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    std::string readAll()
+    {
+        std::string data;
+        char buf[65536];
+        ssize_t n;
+        while ((n = read(fds[0], buf, sizeof(buf))) > 0)
+            data.append(buf, n);
+        return data;
+    }
+};
+
+TEST_F(OutputQueueTest, EmptyByDefault)
+{
+    OutputQueue out;
+    EXPECT_TRUE(out.empty());
+    EXPECT_EQ(out.size(), 0u);
+}
+
+TEST_F(OutputQueueTest, EmptyBuffersAreSkipped)
+{
+    OutputQueue out;
+    out.push(std::string());
+    EXPECT_TRUE(out.empty());
+}
+
+TEST_F(OutputQueueTest, SegmentsAreSentInOrder)
+{
+    OutputQueue out;
+    out.push("HTTP/1.1 200 OK\r\n\r\n");
+    out.push(std::string("body"));
+    out.push("tail");
+    EXPECT_EQ(out.size(), 27u);
+
+    EXPECT_EQ(out.flush(fds[1]), 27);
+    EXPECT_TRUE(out.empty());
+    EXPECT_EQ(readAll(), "HTTP/1.1 200 OK\r\n\r\nbodytail");
+}
+
+TEST_F(OutputQueueTest, PartialWritesResumeWhereTheyStopped)
+{
+    std::string big(1 << 20, '\0');
+    for (size_t i = 0; i < big.size(); ++i)
+        big[i] = static_cast<char>('a' + i % 26);
+
+    OutputQueue out;
+    out.push("head");
+    out.push(std::string(big));
+    out.push("end");
+
+    std::string received;
+    while (!out.empty())
+    {
+        ssize_t sent = out.flush(fds[1]);
+        if (sent == -1)
+        {
+            ASSERT_EQ(errno, EAGAIN);
+        }
+        received += readAll();
+    }
+    received += readAll();
+
+    EXPECT_EQ(received, "head" + big + "end");
+}
+
+TEST_F(OutputQueueTest, MoreSegmentsThanOneWritev)
+{
+    OutputQueue out;
+    std::string expected;
+    for (size_t i = 0; i < OutputQueue::MAX_IOV * 2 + 1; ++i)
+    {
+        out.push(std::to_string(i) + ",");
+        expected += std::to_string(i) + ",";
+    }
+
+    while (!out.empty())
+        ASSERT_GT(out.flush(fds[1]), 0);
+    EXPECT_EQ(readAll(), expected);
+}
+
+TEST_F(OutputQueueTest, FileBodyIsSentBetweenBuffers)
+{
+    std::string contents(200000, 'x');
+    contents += "file end";
+
+    // Removed once opened
+    FileBody file = FileReader::openFile(TempFile(contents).path());
+    EXPECT_EQ(file.length, contents.size());
+
+    OutputQueue out;
+    out.push("head");
+    out.push(file);
+    out.push("tail");
+    EXPECT_EQ(out.size(), contents.size() + 8);
+
+    std::string received;
+    while (!out.empty())
+    {
+        ssize_t sent = out.flush(fds[1]);
+        if (sent == -1)
+        {
+            ASSERT_EQ(errno, EAGAIN);
+        }
+        received += readAll();
+    }
+    received += readAll();
+
+    EXPECT_EQ(received, "head" + contents + "tail");
+}
+
+class PiecesStream : public BodyStream
+{
+  public:
+    explicit PiecesStream(std::vector<std::string> pieces)
+      : m_pieces(std::move(pieces))
+    {
+    }
+
+    bool finished() const override { return m_next == m_pieces.size(); }
+
+    bool next(std::string& out) override
+    {
+        out = m_pieces[m_next++];
+        return true;
+    }
+
+  private:
+    std::vector<std::string> m_pieces;
+    size_t m_next = 0;
+};
+
+TEST_F(OutputQueueTest, StreamsAreAskedWhenTheirTurnComes)
+{
+    OutputQueue out;
+    auto stream = std::make_shared<PiecesStream>(
+        std::vector<std::string>{"one ", "two ", "three"});
+    out.push("head ");
+    out.push(stream);
+    out.push(" tail");
+    EXPECT_FALSE(out.empty());
+
+    while (!out.empty())
+        ASSERT_GT(out.flush(fds[1]), 0);
+    EXPECT_TRUE(stream->finished());
+    EXPECT_EQ(readAll(), "head one two three tail");
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "Poller.hpp"
+
+// Same expectations for every backend, io_uring falls back to epoll
+// where the kernel doesn't provide it
+class PollerTest : public ::testing::TestWithParam<EventBackend>
+{
+  protected:
+    int fds[2] = {-1, -1};
+
+    void SetUp() override { ASSERT_EQ(pipe(fds), 0); }
+
+    void TearDown() override
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+};
+
+TEST_P(PollerTest, ReportsReadableFd)
+{
+    std::unique_ptr<Poller> poller = Poller::create(GetParam());
+    t_event events[4];
+
+    ASSERT_EQ(poller->add(fds[0], EPOLLIN), 0);
+    EXPECT_EQ(poller->wait(events, 4, 0), 0);
+
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+    ASSERT_EQ(poller->wait(events, 4, 1000), 1);
+    EXPECT_EQ(events[0].data.fd, fds[0]);
+    EXPECT_TRUE(events[0].events & EPOLLIN);
+}
+
+TEST_P(PollerTest, LevelTriggeredReportsAgainUntilDrained)
+{
+    std::unique_ptr<Poller> poller = Poller::create(GetParam());
+    t_event events[4];
+    char c;
+
+    ASSERT_EQ(poller->add(fds[0], EPOLLIN), 0);
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+
+    ASSERT_EQ(poller->wait(events, 4, 1000), 1);
+    ASSERT_EQ(poller->wait(events, 4, 1000), 1);
+
+    ASSERT_EQ(read(fds[0], &c, 1), 1);
+    EXPECT_EQ(poller->wait(events, 4, 0), 0);
+}
+
+TEST_P(PollerTest, EdgeTriggeredReportsOnlyNewData)
+{
+    std::unique_ptr<Poller> poller = Poller::create(GetParam());
+    t_event events[4];
+
+    ASSERT_EQ(poller->add(fds[0], EPOLLIN | EPOLLET), 0);
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+
+    ASSERT_EQ(poller->wait(events, 4, 1000), 1);
+    EXPECT_EQ(poller->wait(events, 4, 0), 0);
+
+    ASSERT_EQ(write(fds[1], "y", 1), 1);
+    EXPECT_EQ(poller->wait(events, 4, 1000), 1);
+}
+
+TEST_P(PollerTest, ModifyAndRemove)
+{
+    std::unique_ptr<Poller> poller = Poller::create(GetParam());
+    t_event events[4];
+
+    ASSERT_EQ(poller->add(fds[1], EPOLLIN), 0);
+    EXPECT_EQ(poller->wait(events, 4, 0), 0);
+
+    ASSERT_EQ(poller->modify(fds[1], EPOLLOUT), 0);
+    ASSERT_EQ(poller->wait(events, 4, 1000), 1);
+    EXPECT_TRUE(events[0].events & EPOLLOUT);
+
+    ASSERT_EQ(poller->remove(fds[1]), 0);
+    EXPECT_EQ(poller->wait(events, 4, 0), 0);
+    EXPECT_EQ(poller->remove(fds[1]), -1);
+}
+
+// A response toggles EPOLLOUT on and off, the events follow every change
+TEST_P(PollerTest, ModifyTogglesEvents)
+{
+    std::unique_ptr<Poller> poller = Poller::create(GetParam());
+    t_event events[4];
+
+    ASSERT_EQ(poller->add(fds[1], EPOLLIN), 0);
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(poller->modify(fds[1], EPOLLIN | EPOLLOUT), 0);
+        ASSERT_EQ(poller->wait(events, 4, 1000), 1);
+        EXPECT_TRUE(events[0].events & EPOLLOUT);
+
+        ASSERT_EQ(poller->modify(fds[1], EPOLLIN), 0);
+        EXPECT_EQ(poller->wait(events, 4, 0), 0);
+    }
+}
+
+TEST_P(PollerTest, AcceptsConnectionsOnListener)
+{
+    std::unique_ptr<Poller> poller = Poller::create(GetParam());
+    t_event events[4];
+
+    int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    ASSERT_NE(listener, -1);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(bind(listener, reinterpret_cast<sockaddr*>(&addr), len), 0);
+    ASSERT_EQ(listen(listener, 8), 0);
+    ASSERT_EQ(getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len), 0);
+
+    ASSERT_EQ(poller->addListener(listener, EPOLLIN), 0);
+    EXPECT_EQ(poller->wait(events, 4, 0), 0);
+    EXPECT_EQ(poller->acceptClient(listener), -1);
+
+    int clients[2];
+    for (int& client : clients)
+    {
+        client = socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_EQ(connect(client, reinterpret_cast<sockaddr*>(&addr), len), 0);
+    }
+
+    // Both connections can be taken after one event
+    int accepted[2] = {-1, -1};
+    ASSERT_GE(poller->wait(events, 4, 1000), 1);
+    EXPECT_EQ(events[0].data.fd, listener);
+    for (int& fd : accepted)
+    {
+        for (int tries = 0; fd == -1 && tries < 100; ++tries)
+        {
+            fd = poller->acceptClient(listener);
+            if (fd == -1)
+            {
+                EXPECT_EQ(errno, EAGAIN);
+                poller->wait(events, 4, 10);
+            }
+        }
+        EXPECT_NE(fd, -1);
+    }
+    EXPECT_EQ(poller->acceptClient(listener), -1);
+    EXPECT_EQ(poller->wait(events, 4, 0), 0);
+
+    ASSERT_EQ(write(clients[0], "x", 1), 1);
+    char c;
+    EXPECT_EQ(read(accepted[0], &c, 1), 1);
+
+    EXPECT_EQ(poller->remove(listener), 0);
+    for (int fd : clients)
+        close(fd);
+    for (int fd : accepted)
+        close(fd);
+    close(listener);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, PollerTest,
+                         ::testing::Values(EventBackend::Epoll,
+                                           EventBackend::IoUring));
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "RequestBody.hpp"
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    std::string readFile(const std::string& path)
+    {
+        std::string contents;
+        int fd = open(path.c_str(), O_RDONLY);
+        char buf[4096];
+        ssize_t n;
+        while (fd != -1 && (n = read(fd, buf, sizeof(buf))) > 0)
+            contents.append(buf, n);
+        if (fd != -1)
+            close(fd);
+        return contents;
+    }
+
+    std::string tempDir()
+    {
+        char name[] = "/tmp/webserv_bodytest_XXXXXX";
+        return mkdtemp(name) ? name : "/tmp";
+    }
+}
+
+TEST(RequestBodyTest, StaysInMemoryUpToTheBufferSize)
+{
+    RequestBody body;
+    body.setSpooling(10, "/tmp");
+    body.append("Hello");
+    body.append("World");
+
+    EXPECT_FALSE(body.isSpooled());
+    EXPECT_EQ(body.memory(), "HelloWorld");
+    EXPECT_EQ(body, "HelloWorld");
+}
+
+TEST(RequestBodyTest, SpillsToDiskPastTheBufferSize)
+{
+    RequestBody body;
+    body.setSpooling(10, "/tmp");
+    body.append("Hello");
+    body.append("World!");
+
+    ASSERT_TRUE(body.isSpooled());
+    EXPECT_TRUE(body.memory().empty());
+    EXPECT_EQ(body.size(), 11u);
+    EXPECT_EQ(body.str(), "HelloWorld!");
+
+    char buf[4];
+    EXPECT_EQ(body.read(5, buf, sizeof(buf)), 4u);
+    EXPECT_EQ(std::string(buf, 4), "Worl");
+    EXPECT_EQ(body.read(9, buf, sizeof(buf)), 2u);
+
+    // Moving hands the file over
+    RequestBody moved = std::move(body);
+    EXPECT_TRUE(moved.isSpooled());
+    EXPECT_FALSE(body.isSpooled());
+    EXPECT_EQ(moved, "HelloWorld!");
+
+    moved.clear();
+    EXPECT_FALSE(moved.isSpooled());
+    EXPECT_TRUE(moved.empty());
+}
+
+TEST(RequestBodyTest, ReservingPastTheBufferSpoolsRightAway)
+{
+    RequestBody body;
+    body.setSpooling(10, "/tmp");
+    body.reserve(11);
+    EXPECT_TRUE(body.isSpooled());
+
+    RequestBody small;
+    small.setSpooling(10, "/tmp");
+    small.reserve(10);
+    EXPECT_FALSE(small.isSpooled());
+}
+
+TEST(RequestBodyTest, WritesToAPipeFromMemoryAndFromDisk)
+{
+    for (size_t bufferSize : {SIZE_MAX, size_t(0)})
+    {
+        RequestBody body;
+        body.setSpooling(bufferSize, "/tmp");
+        body.append("0123456789");
+        EXPECT_EQ(body.isSpooled(), bufferSize == 0);
+
+        int fds[2];
+        ASSERT_EQ(pipe(fds), 0);
+        EXPECT_EQ(body.writeTo(fds[1], 2, 5), 5);
+        EXPECT_EQ(body.writeTo(fds[1], 7, 100), 3);
+        EXPECT_EQ(body.writeTo(fds[1], 10, 100), 0);
+        close(fds[1]);
+
+        char buf[16];
+        EXPECT_EQ(read(fds[0], buf, sizeof(buf)), 8);
+        EXPECT_EQ(std::string(buf, 8), "23456789");
+        close(fds[0]);
+    }
+}
+
+TEST(RequestBodyTest, SavedSpooledBodyIsLinkedNotCopied)
+{
+    std::string dir = tempDir();
+    std::string path = dir + "/upload.bin";
+
+    RequestBody body;
+    body.setSpooling(0, dir);
+    body.append("file contents");
+    ASSERT_TRUE(body.isSpooled());
+    body.saveAs(path);
+
+    EXPECT_EQ(readFile(path), "file contents");
+    struct stat saved, spooled;
+    ASSERT_EQ(stat(path.c_str(), &saved), 0);
+    ASSERT_EQ(fstat(body.fd(), &spooled), 0);
+    EXPECT_EQ(saved.st_ino, spooled.st_ino);
+
+    // Still there once the body is gone
+    body.clear();
+    EXPECT_EQ(readFile(path), "file contents");
+
+    RequestBody inMemory;
+    inMemory.append("replaced");
+    inMemory.saveAs(path);
+    EXPECT_EQ(readFile(path), "replaced");
+
+    unlink(path.c_str());
+    rmdir(dir.c_str());
+}
@@ -382,7 +382,7 @@ TEST(RawRequestTest, ChunkedMissingNullTerminator)
 		"Host: localhost\r\n"
 		"Transfer-Encoding: chunked\r\n"
 		"\r\n"
-		"B\r\nHello World\n\r"
+		"B\r\nHello World\r\n"
 	);
 
 	rawReq.parse();
@@ -618,7 +618,7 @@ TEST(RawRequestTest, ContentLengthBodyIncrementalNotEnough)
 
 	EXPECT_FALSE(rawReq.isBodyDone());
 	EXPECT_FALSE(done);
-	EXPECT_NE(rawReq.body(), body);
+	EXPECT_EQ(rawReq.body(), body); // received so far, written in place
 }
 
 TEST(RawRequestTest, ContentLengthBodyIncremental)
@@ -666,3 +666,330 @@ TEST(RawRequestTest, ContentLengthBodyIncrementalTooMuch)
 	EXPECT_EQ(rawReq.body(), "Hello World");
 }
 
+
+TEST(RawRequestTest, HeadersArrivingByteByByte)
+{
+	RawRequest rawReq;
+	const std::string request =
+		"GET /path/page?x=1 HTTP/1.1\r\n"
+		"Host: example.com:8080\r\n"
+		"Accept:\t text/html\r\n"
+		"\r\n"
+		"GET";
+
+	// The terminator straddles segments on every possible boundary
+	for (size_t i = 0; i < request.size(); ++i)
+	{
+		rawReq.appendTempBuffer(std::string(1, request[i]));
+		rawReq.parse();
+		if (rawReq.isRequestDone())
+			break;
+	}
+
+	EXPECT_TRUE(rawReq.isRequestDone());
+	EXPECT_FALSE(rawReq.isBadRequest());
+	EXPECT_EQ(rawReq.method(), HttpMethod::GET);
+	EXPECT_EQ(rawReq.uri(), "/path/page");
+	EXPECT_EQ(rawReq.query(), "x=1");
+	EXPECT_EQ(rawReq.host(), "example.com");
+	EXPECT_EQ(rawReq.header("Accept"), "text/html");
+	EXPECT_EQ(rawReq.tempBuffer(), "");
+}
+
+TEST(RawRequestTest, BareLineFeedsAndLeftovers)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"GET / HTTP/1.0\n"
+		"Connection: close\n"
+		"\r\n\r\n"
+		"NEXT"
+	);
+
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_FALSE(rawReq.isBadRequest());
+	EXPECT_EQ(rawReq.httpVersion(), "HTTP/1.0");
+	EXPECT_TRUE(rawReq.shouldClose());
+	EXPECT_EQ(rawReq.takeTempBuffer(), "NEXT");
+	EXPECT_EQ(rawReq.tempBuffer(), "");
+}
+
+// The headers point into the received block, not into the buffer that
+// keeps being reused for the body and the next request
+TEST(RawRequestTest, HeadersOutliveTheReceiveBuffer)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /submit HTTP/1.1\r\n"
+		"Host: example.com\r\n"
+		"X-Trace: abc\r\n"
+		"Content-Length: 4\r\n\r\n"
+		"da"
+	);
+	EXPECT_FALSE(rawReq.parse());
+	rawReq.appendTempBuffer("taGET / HTTP/1.1\r\nX-Trace: overwritten\r\n\r\n");
+	EXPECT_TRUE(rawReq.parse());
+	rawReq.setTempBuffer(std::string(256, 'x'));
+
+	RawRequest moved = std::move(rawReq);
+	EXPECT_EQ(moved.header("x-trace"), "abc");
+	EXPECT_EQ(moved.header("Host"), "example.com");
+
+	RequestData data = moved.takeRequestData();
+	moved = RawRequest();
+	EXPECT_EQ(data.getHeader("X-Trace"), "abc");
+	EXPECT_EQ(data.getHeader("Content-Length"), "4");
+}
+
+TEST(RawRequestTest, ControlCharacterInHeader)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"GET / HTTP/1.1\r\n"
+		"Host: localhost\r\n"
+		"X-Evil: a\rb\r\n"
+		"\r\n"
+	);
+
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_TRUE(rawReq.isBadRequest());
+}
+
+TEST(RawRequestTest, ChunkedBodyArrivingByteByByte)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Host: localhost\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"\r\n"
+	);
+	EXPECT_FALSE(rawReq.parse());
+
+	const std::string body =
+		"5;name=value\r\nHello\r\n"
+		"1A\r\n abcdefghijklmnopqrstuvwxy\r\n"
+		"0\r\n"
+		"Checksum: 42\r\n"
+		"\r\n"
+		"GET /next HTTP/1.1\r\n";
+	size_t end = body.find("GET");
+	for (size_t i = 0; i < end; ++i)
+	{
+		rawReq.appendTempBuffer(std::string(1, body[i]));
+		EXPECT_EQ(rawReq.parse(), i + 1 == end);
+	}
+	rawReq.appendTempBuffer(body.substr(end));
+
+	EXPECT_FALSE(rawReq.isBadRequest());
+	EXPECT_EQ(rawReq.body(), "Hello abcdefghijklmnopqrstuvwxy");
+	EXPECT_EQ(rawReq.tempBuffer(), "GET /next HTTP/1.1\r\n");
+}
+
+TEST(RawRequestTest, ChunkedBodyOverTheLimit)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"\r\n"
+		"4\r\nabcd\r\n"
+	);
+	ASSERT_TRUE(rawReq.parseHeaderPart());
+	rawReq.setMaxBodySize(6);
+	EXPECT_FALSE(rawReq.parse());
+
+	// Rejected from the chunk size, before its data arrives
+	rawReq.appendTempBuffer("3\r\n");
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_TRUE(rawReq.isBodyTooLarge());
+	EXPECT_FALSE(rawReq.isBadRequest());
+	EXPECT_TRUE(rawReq.shouldClose());
+	EXPECT_TRUE(rawReq.tempBuffer().empty());
+}
+
+TEST(RawRequestTest, ChunkSizeOverflow)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"\r\n"
+		"11111111111111111111\r\n"
+	);
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_TRUE(rawReq.isBadRequest());
+}
+
+TEST(RawRequestTest, ContentLengthBodyGoesStraightToTheBody)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /submit HTTP/1.1\r\n"
+		"Content-Length: 40\r\n"
+		"\r\n"
+	);
+	EXPECT_FALSE(rawReq.parse());
+
+	rawReq.appendTempBuffer(std::string(20, 'a'));
+	EXPECT_TRUE(rawReq.tempBuffer().empty());
+	const char* storage = rawReq.body().memory().data();
+
+	rawReq.appendTempBuffer(std::string(20, 'b') + "GET / HTTP/1.1\r\n");
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_EQ(rawReq.body().memory().data(), storage); // reserved once, never regrown
+	EXPECT_EQ(rawReq.tempBuffer(), "GET / HTTP/1.1\r\n");
+
+	RequestData data = rawReq.takeRequestData();
+	EXPECT_EQ(data.body.memory().data(), storage); // moved, not copied
+	EXPECT_EQ(data.body, std::string(20, 'a') + std::string(20, 'b'));
+}
+
+TEST(RawRequestTest, AnnouncedBodyPastTheBufferIsSpooledFromTheStart)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Content-Length: 40\r\n"
+		"\r\n"
+	);
+	ASSERT_TRUE(rawReq.parseHeaderPart());
+	BodySettings settings;
+	settings.bufferSize = 16;
+	settings.tempPath = "/tmp";
+	rawReq.setBodySettings(settings);
+
+	rawReq.appendTempBuffer(std::string(20, 'a'));
+	EXPECT_TRUE(rawReq.body().isSpooled());
+	EXPECT_TRUE(rawReq.body().memory().empty());
+
+	rawReq.appendTempBuffer(std::string(20, 'b'));
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_EQ(rawReq.body(), std::string(20, 'a') + std::string(20, 'b'));
+	EXPECT_TRUE(rawReq.takeRequestData().body.isSpooled());
+}
+
+TEST(RawRequestTest, ChunkedBodySpillsToDiskPastTheBuffer)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"\r\n"
+	);
+	ASSERT_TRUE(rawReq.parseHeaderPart());
+	BodySettings settings;
+	settings.bufferSize = 8;
+	rawReq.setBodySettings(settings);
+
+	rawReq.appendTempBuffer("5\r\nHello\r\n");
+	EXPECT_FALSE(rawReq.body().isSpooled());
+	rawReq.appendTempBuffer("6\r\n World\r\n0\r\n\r\n");
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_TRUE(rawReq.body().isSpooled());
+	EXPECT_EQ(rawReq.body(), "Hello World");
+}
+
+TEST(RawRequestTest, BodyThatCantBeSpooledIsAServerError)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Content-Length: 40\r\n"
+		"\r\n"
+	);
+	ASSERT_TRUE(rawReq.parseHeaderPart());
+	BodySettings settings;
+	settings.bufferSize = 16;
+	settings.tempPath = "/nonexistent/webserv_body_temp";
+	rawReq.setBodySettings(settings);
+
+	rawReq.appendTempBuffer(std::string(20, 'a'));
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_TRUE(rawReq.isServerError());
+	EXPECT_FALSE(rawReq.isBadRequest());
+	EXPECT_TRUE(rawReq.shouldClose());
+	EXPECT_TRUE(rawReq.tempBuffer().empty());
+}
+
+TEST(RawRequestTest, AnnouncedBodyOverTheLimit)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Content-Length: 1000\r\n"
+		"\r\n"
+		"first bytes"
+	);
+	ASSERT_TRUE(rawReq.parseHeaderPart());
+	rawReq.setMaxBodySize(999);
+
+	// Refused before the body is read
+	EXPECT_TRUE(rawReq.isBodyTooLarge());
+	EXPECT_TRUE(rawReq.isRequestDone());
+	EXPECT_TRUE(rawReq.shouldClose());
+	EXPECT_TRUE(rawReq.tempBuffer().empty());
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_TRUE(rawReq.body().empty());
+}
+
+TEST(RawRequestTest, AnnouncedBodyWithinTheLimit)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Content-Length: 5\r\n"
+		"\r\n"
+	);
+	ASSERT_TRUE(rawReq.parseHeaderPart());
+	rawReq.setMaxBodySize(5);
+	EXPECT_FALSE(rawReq.isBodyTooLarge());
+
+	rawReq.appendTempBuffer("Hello");
+	EXPECT_TRUE(rawReq.parse());
+	EXPECT_EQ(rawReq.body(), "Hello");
+}
+
+TEST(RawRequestTest, ExpectContinue)
+{
+	RawRequest withBody;
+	withBody.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Expect: 100-Continue\r\n"
+		"Content-Length: 5\r\n"
+		"\r\n"
+	);
+	ASSERT_TRUE(withBody.parseHeaderPart());
+	EXPECT_TRUE(withBody.expectsContinue());
+
+	RawRequest noBody;
+	noBody.appendTempBuffer(
+		"GET / HTTP/1.1\r\n"
+		"Expect: 100-continue\r\n"
+		"\r\n"
+	);
+	ASSERT_TRUE(noBody.parseHeaderPart());
+	EXPECT_FALSE(noBody.expectsContinue());
+
+	RawRequest oldVersion;
+	oldVersion.appendTempBuffer(
+		"POST /upload HTTP/1.0\r\n"
+		"Expect: 100-continue\r\n"
+		"Content-Length: 5\r\n"
+		"\r\n"
+	);
+	ASSERT_TRUE(oldVersion.parseHeaderPart());
+	EXPECT_FALSE(oldVersion.expectsContinue());
+}
+
+TEST(RawRequestTest, InvalidContentLengthIsRejectedWithTheHeaders)
+{
+	RawRequest rawReq;
+	rawReq.appendTempBuffer(
+		"POST /upload HTTP/1.1\r\n"
+		"Content-Length: -4\r\n"
+		"\r\n"
+	);
+	EXPECT_TRUE(rawReq.parseHeaderPart());
+	EXPECT_TRUE(rawReq.isBadRequest());
+}
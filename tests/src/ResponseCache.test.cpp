@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "TempFile/TempFile.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include "ResponseCache.hpp"
+#include "FileUtils.hpp"
+
+class ResponseCacheTest : public TempFileTest
+{
+  protected:
+    ResponseCacheTest() : TempFileTest("hello") {}
+
+    ResponseCache cache;
+    const std::string headers = "Content-Length: 5\r\n\r\n";
+
+    FileBody open() { return open(path); }
+
+    FileInfo info() const { return info(path); }
+
+    FileInfo info(const std::string& filePath) const
+    {
+        return FileUtils::getFileInfo(filePath);
+    }
+
+    FileBody open(const std::string& filePath)
+    {
+        FileBody file;
+        int fd = ::open(filePath.c_str(), O_RDONLY);
+        file.fd = std::make_shared<FdGuard>(fd);
+        file.length = lseek(fd, 0, SEEK_END);
+        return file;
+    }
+
+    ResponseCache::Settings enabled(size_t maxBytes = 1024,
+                                    size_t maxFileSize = 64)
+    {
+        ResponseCache::Settings settings;
+        settings.maxBytes = maxBytes;
+        settings.maxFileSize = maxFileSize;
+        return settings;
+    }
+};
+
+TEST_F(ResponseCacheTest, DisabledByDefault)
+{
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_EQ(cache.insert(path, open(), info(), headers), nullptr);
+    EXPECT_EQ(cache.lookup(path, info()), nullptr);
+    EXPECT_EQ(cache.misses(), 0u);
+}
+
+TEST_F(ResponseCacheTest, ServesTheSameBuffersOnAHit)
+{
+    cache.configure(enabled());
+
+    EXPECT_EQ(cache.lookup(path, info()), nullptr);
+    const CachedResponse* inserted = cache.insert(path, open(), info(), headers);
+    ASSERT_NE(inserted, nullptr);
+    EXPECT_EQ(*inserted->body, "hello");
+    EXPECT_EQ(*inserted->headers, headers);
+
+    const CachedResponse* hit = cache.lookup(path, info());
+    ASSERT_NE(hit, nullptr);
+    EXPECT_EQ(hit->body, inserted->body);
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 1u);
+    EXPECT_EQ(cache.bytes(), headers.size() + 5);
+}
+
+TEST_F(ResponseCacheTest, DropsAChangedFile)
+{
+    cache.configure(enabled());
+    ASSERT_NE(cache.insert(path, open(), info(), headers), nullptr);
+
+    writeFile("hello, world");
+    EXPECT_EQ(cache.lookup(path, info()), nullptr);
+    EXPECT_EQ(cache.bytes(), 0u);
+}
+
+// The validators sent come from the caller's stat, the body must match
+// them, even when that stat is older than the file on disk
+TEST_F(ResponseCacheTest, OnlyServesTheVersionTheCallerSaw)
+{
+    cache.configure(enabled());
+    const FileInfo before = info();
+    ASSERT_NE(cache.insert(path, open(), before, headers), nullptr);
+    ASSERT_NE(cache.lookup(path, before), nullptr);
+
+    writeFile("hello, world");
+    const FileInfo after = info();
+    EXPECT_EQ(cache.insert(path, open(), before, headers), nullptr);
+    EXPECT_EQ(cache.lookup(path, after), nullptr);
+
+    const CachedResponse* fresh = cache.insert(path, open(), after, headers);
+    ASSERT_NE(fresh, nullptr);
+    EXPECT_EQ(*fresh->body, "hello, world");
+    EXPECT_EQ(cache.lookup(path, before), nullptr);
+}
+
+TEST_F(ResponseCacheTest, InFlightResponsesOutliveTheEntry)
+{
+    cache.configure(enabled());
+    std::shared_ptr<const std::string> body
+        = cache.insert(path, open(), info(), headers)->body;
+
+    cache.invalidate(path);
+    EXPECT_EQ(*body, "hello");
+}
+
+TEST_F(ResponseCacheTest, SkipsFilesOverTheLimit)
+{
+    cache.configure(enabled(1024, 4));
+    EXPECT_EQ(cache.insert(path, open(), info(), headers), nullptr);
+    EXPECT_EQ(cache.bytes(), 0u);
+}
+
+TEST_F(ResponseCacheTest, EvictsTheLeastRecentlyUsed)
+{
+    const size_t entryBytes = headers.size() + 5;
+    cache.configure(enabled(2 * entryBytes));
+
+    TempFile otherFile("12345");
+    TempFile thirdFile("abcde");
+    const std::string& other = otherFile.path();
+    const std::string& third = thirdFile.path();
+
+    ASSERT_NE(cache.insert(path, open(), info(), headers), nullptr);
+    ASSERT_NE(cache.insert(other, open(other), info(other), headers), nullptr);
+    ASSERT_NE(cache.lookup(path, info()), nullptr); // 'other' is now the oldest
+    ASSERT_NE(cache.insert(third, open(third), info(third), headers), nullptr);
+
+    EXPECT_NE(cache.lookup(path, info()), nullptr);
+    EXPECT_NE(cache.lookup(third, info(third)), nullptr);
+    EXPECT_EQ(cache.lookup(other, info(other)), nullptr);
+    EXPECT_LE(cache.bytes(), 2 * entryBytes);
+}
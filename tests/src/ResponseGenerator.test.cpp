@@ -7,6 +7,8 @@
 #include "HttpStatusCode.hpp"
 #include "Client.hpp"
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 
 // Test fixture
 class ResponseGeneratorTest : public ::testing::Test
@@ -40,6 +42,30 @@ TEST_F(ResponseGeneratorTest, BadRequest)
     EXPECT_EQ(resp.isInternalRedirect(), false);
 }
 
+TEST_F(ResponseGeneratorTest, BodyThatCantBeStoredIsAServerError)
+{
+    RawRequest rawReq;
+    rawReq.appendTempBuffer(
+        "POST /upload HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n");
+    ASSERT_TRUE(rawReq.parseHeaderPart());
+    BodySettings settings;
+    settings.bufferSize = 0;
+    settings.tempPath = "/nonexistent/webserv_body_temp";
+    rawReq.setBodySettings(settings);
+    rawReq.appendTempBuffer("5\r\nHello\r\n0\r\n\r\n");
+    ASSERT_TRUE(rawReq.parse());
+
+    ctx.upload_store = "./assets/www/site0/uploads";
+    ctx.allowed_methods = {HttpMethod::POST};
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::InternalServerError);
+}
+
 TEST_F(ResponseGeneratorTest, ExternalRedirection)
 {
     RawRequest rawReq;
@@ -403,6 +429,66 @@ TEST_F(ResponseGeneratorTest, PostUploadMissingDirectory)
     EXPECT_FALSE(FileUtils::getFileInfo(nonExistentDir).exists);
 }
 
+TEST_F(ResponseGeneratorTest, PostMultipartUploadIsStreamedToTheStore)
+{
+    const std::string store = "./assets/www/site0/uploads";
+    const std::string part = "--XyZ\r\n"
+        "Content-Disposition: form-data; name=\"f\"; filename=\"streamed_upload.txt\"\r\n"
+        "\r\n"
+        "streamed contents\r\n"
+        "--XyZ--\r\n";
+
+    RawRequest rawReq;
+    rawReq.appendTempBuffer(
+        "POST /upload HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Content-Type: multipart/form-data; boundary=XyZ\r\n"
+        "Content-Length: " + std::to_string(part.size()) + "\r\n"
+        "\r\n");
+    ASSERT_TRUE(rawReq.parseHeaderPart());
+
+    ctx.upload_store = store;
+    ctx.allowed_methods = {HttpMethod::POST};
+    ASSERT_TRUE(ResponseGenerator::isUpload(rawReq.method(), rawReq.uri(), ctx));
+    rawReq.streamBodyTo(UploadModule::createMultipartParser(
+        rawReq.header("Content-Type"), store));
+
+    rawReq.appendTempBuffer(part.substr(0, 60));
+    rawReq.appendTempBuffer(part.substr(60));
+    ASSERT_TRUE(rawReq.parse());
+    EXPECT_TRUE(rawReq.body().memory().empty()); // never kept
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::Created);
+    std::ifstream file(store + "/streamed_upload.txt");
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(contents, "streamed contents");
+    std::filesystem::remove(store + "/streamed_upload.txt");
+}
+
+TEST_F(ResponseGeneratorTest, PostMultipartUploadWithoutClosingDelimiter)
+{
+    const std::string store = "./assets/www/site0/uploads";
+
+    RawRequest rawReq;
+    rawReq.setMethod(HttpMethod::POST);
+    rawReq.setUri("/upload");
+    rawReq.addHeader("Content-Type", "multipart/form-data; boundary=XyZ");
+    rawReq.setBody("--XyZ\r\n"
+        "Content-Disposition: form-data; name=\"f\"; filename=\"cut_upload.txt\"\r\n"
+        "\r\n"
+        "cut short");
+
+    ctx.upload_store = store;
+    ctx.allowed_methods = {HttpMethod::POST};
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::BadRequest);
+    EXPECT_FALSE(FileUtils::getFileInfo(store + "/cut_upload.txt").exists);
+}
+
 TEST_F(ResponseGeneratorTest, PipelinedRequestsConnectionKeepAliveAndClose)
 {
     // // First request (keep-alive)
@@ -442,3 +528,382 @@ TEST_F(ResponseGeneratorTest, PipelinedRequestsConnectionKeepAliveAndClose)
     EXPECT_TRUE(resp2.hasHeader("Connection"));
     EXPECT_EQ(resp2.header("Connection"), "close");
 }
+
+TEST_F(ResponseGeneratorTest, StaticFileHasValidators)
+{
+    RawRequest rawReq;
+    rawReq.setMethod(HttpMethod::GET);
+    rawReq.setUri("/index.html");
+
+    ctx.resolved_path = "./assets/www/site1/index.html";
+    ctx.allowed_methods = {HttpMethod::GET};
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::OK);
+    EXPECT_TRUE(resp.hasHeader("ETag"));
+    EXPECT_TRUE(resp.hasHeader("Last-Modified"));
+}
+
+TEST_F(ResponseGeneratorTest, IfNoneMatchGivesNotModified)
+{
+    RawRequest first;
+    first.setMethod(HttpMethod::GET);
+    first.setUri("/index.html");
+
+    ctx.resolved_path = "./assets/www/site1/index.html";
+    ctx.allowed_methods = {HttpMethod::GET};
+
+    ResponseGenerator::genResponse(first, ctx, resp, cgiRes);
+    const std::string etag = resp.header("ETag");
+
+    RawRequest second;
+    second.setMethod(HttpMethod::GET);
+    second.setUri("/index.html");
+    second.addHeader("If-None-Match", "\"other\", W/" + etag);
+
+    RawResponse resp2;
+    ResponseGenerator::genResponse(second, ctx, resp2, cgiRes);
+
+    EXPECT_EQ(resp2.statusCode(), HttpStatusCode::NotModified);
+    EXPECT_EQ(resp2.header("ETag"), etag);
+    EXPECT_FALSE(resp2.toResponseData().file.isSet());
+    EXPECT_TRUE(resp2.toResponseData().body.empty());
+}
+
+TEST_F(ResponseGeneratorTest, StaleETagGivesFullResponse)
+{
+    RawRequest rawReq;
+    rawReq.setMethod(HttpMethod::GET);
+    rawReq.setUri("/index.html");
+    rawReq.addHeader("If-None-Match", "\"stale\"");
+    // Ignored, If-None-Match is there
+    rawReq.addHeader("If-Modified-Since", "Fri, 01 Jan 2100 00:00:00 GMT");
+
+    ctx.resolved_path = "./assets/www/site1/index.html";
+    ctx.allowed_methods = {HttpMethod::GET};
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::OK);
+}
+
+TEST_F(ResponseGeneratorTest, IfModifiedSince)
+{
+    ctx.resolved_path = "./assets/www/site1/";
+    ctx.allowed_methods = {HttpMethod::GET};
+    ctx.index_files = {"index.html"};
+
+    RawRequest later;
+    later.setMethod(HttpMethod::GET);
+    later.setUri("/");
+    later.addHeader("If-Modified-Since", "Fri, 01 Jan 2100 00:00:00 GMT");
+    ResponseGenerator::genResponse(later, ctx, resp, cgiRes);
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::NotModified);
+
+    RawRequest earlier;
+    earlier.setMethod(HttpMethod::GET);
+    earlier.setUri("/");
+    earlier.addHeader("If-Modified-Since", "Thu, 01 Jan 1970 00:00:00 GMT");
+    RawResponse resp2;
+    ResponseGenerator::genResponse(earlier, ctx, resp2, cgiRes);
+    EXPECT_EQ(resp2.statusCode(), HttpStatusCode::OK);
+
+    RawRequest malformed;
+    malformed.setMethod(HttpMethod::GET);
+    malformed.setUri("/");
+    malformed.addHeader("If-Modified-Since", "yesterday");
+    RawResponse resp3;
+    ResponseGenerator::genResponse(malformed, ctx, resp3, cgiRes);
+    EXPECT_EQ(resp3.statusCode(), HttpStatusCode::OK);
+}
+
+TEST_F(ResponseGeneratorTest, SingleRange)
+{
+    RawRequest rawReq;
+    rawReq.setMethod(HttpMethod::GET);
+    rawReq.setUri("/index.html");
+    rawReq.addHeader("Range", "bytes=0-9");
+
+    ctx.resolved_path = "./assets/www/site1/index.html";
+    ctx.allowed_methods = {HttpMethod::GET};
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::PartialContent);
+    EXPECT_EQ(resp.header("Content-Range").compare(0, 10, "bytes 0-9/"), 0);
+
+    ResponseData data = resp.toResponseData();
+    EXPECT_EQ(data.file.offset, 0);
+    EXPECT_EQ(data.file.length, 10u);
+    EXPECT_EQ(data.getHeader("Content-Length"), "10");
+}
+
+TEST_F(ResponseGeneratorTest, MultipleRanges)
+{
+    RawRequest rawReq;
+    rawReq.setMethod(HttpMethod::GET);
+    rawReq.setUri("/index.html");
+    rawReq.addHeader("Range", "bytes=0-9,20-29");
+
+    ctx.resolved_path = "./assets/www/site1/index.html";
+    ctx.allowed_methods = {HttpMethod::GET};
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::PartialContent);
+
+    ResponseData data = resp.toResponseData();
+    EXPECT_EQ(data.getHeader("Content-Type").compare(0, 31,
+              "multipart/byteranges; boundary="), 0);
+    ASSERT_EQ(data.parts.size(), 3u);
+    EXPECT_EQ(data.parts[1].file.offset, 20);
+    EXPECT_FALSE(data.parts[2].file.isSet());
+
+    size_t length = 0;
+    for (const BodyPart& part : data.parts)
+        length += part.data.size() + part.file.length;
+    EXPECT_EQ(data.getHeader("Content-Length"), std::to_string(length));
+}
+
+TEST_F(ResponseGeneratorTest, RangeNotSatisfiable)
+{
+    RawRequest rawReq;
+    rawReq.setMethod(HttpMethod::GET);
+    rawReq.setUri("/index.html");
+    rawReq.addHeader("Range", "bytes=100000000-");
+
+    ctx.resolved_path = "./assets/www/site1/index.html";
+    ctx.allowed_methods = {HttpMethod::GET};
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::RangeNotSatisfiable);
+    EXPECT_EQ(resp.header("Content-Range").compare(0, 8, "bytes */"), 0);
+}
+
+TEST_F(ResponseGeneratorTest, IfRangeMismatchSendsEverything)
+{
+    RawRequest rawReq;
+    rawReq.setMethod(HttpMethod::GET);
+    rawReq.setUri("/index.html");
+    rawReq.addHeader("Range", "bytes=0-9");
+    rawReq.addHeader("If-Range", "\"old\"");
+
+    ctx.resolved_path = "./assets/www/site1/index.html";
+    ctx.allowed_methods = {HttpMethod::GET};
+
+    ResponseGenerator::genResponse(rawReq, ctx, resp, cgiRes);
+
+    EXPECT_EQ(resp.statusCode(), HttpStatusCode::OK);
+    EXPECT_EQ(resp.header("Accept-Ranges"), "bytes");
+}
+
+class GzipStaticTest : public ResponseGeneratorTest
+{
+  protected:
+    std::string dir;
+
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/gzipstatic_test_XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        dir = tmpl;
+        std::ofstream(dir + "/app.js") << "plain";
+        std::ofstream(dir + "/app.js.gz") << "gz";
+        std::ofstream(dir + "/app.js.br") << "br";
+        std::ofstream(dir + "/lone.js") << "lone";
+
+        ctx.allowed_methods = {HttpMethod::GET};
+        ctx.gzip_static = GzipStatic::On;
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    RawResponse get(const std::string& file, const std::string& acceptEncoding)
+    {
+        RawRequest rawReq;
+        rawReq.setMethod(HttpMethod::GET);
+        rawReq.setUri("/" + file);
+        if (!acceptEncoding.empty())
+            rawReq.addHeader("Accept-Encoding", acceptEncoding);
+
+        ctx.resolved_path = dir + "/" + file;
+        RawResponse rawResp;
+        ResponseGenerator::genResponse(rawReq, ctx, rawResp, cgiRes);
+        return rawResp;
+    }
+};
+
+TEST_F(GzipStaticTest, PrefersBrotliThenGzip)
+{
+    RawResponse br = get("app.js", "gzip, deflate, br");
+    EXPECT_EQ(br.header("Content-Encoding"), "br");
+    EXPECT_EQ(br.header("Vary"), "Accept-Encoding");
+    EXPECT_EQ(br.toResponseData().file.length, 2u);
+    EXPECT_EQ(br.toResponseData().getHeader("Content-Type"),
+              FileUtils::detectMimeType(dir + "/app.js"));
+
+    RawResponse gz = get("app.js", "gzip, br;q=0");
+    EXPECT_EQ(gz.header("Content-Encoding"), "gzip");
+}
+
+TEST_F(GzipStaticTest, PlainWhenNotAccepted)
+{
+    RawResponse plain = get("app.js", "");
+    EXPECT_FALSE(plain.hasHeader("Content-Encoding"));
+    EXPECT_EQ(plain.header("Vary"), "Accept-Encoding");
+    EXPECT_EQ(plain.toResponseData().file.length, 5u);
+
+    RawResponse lone = get("lone.js", "gzip");
+    EXPECT_FALSE(lone.hasHeader("Content-Encoding"));
+    EXPECT_FALSE(lone.hasHeader("Vary"));
+}
+
+TEST_F(GzipStaticTest, AlwaysSendsGzip)
+{
+    ctx.gzip_static = GzipStatic::Always;
+
+    RawResponse gz = get("app.js", "");
+    EXPECT_EQ(gz.header("Content-Encoding"), "gzip");
+}
+
+TEST_F(GzipStaticTest, OffIgnoresSiblings)
+{
+    ctx.gzip_static = GzipStatic::Off;
+
+    RawResponse plain = get("app.js", "gzip, br");
+    EXPECT_FALSE(plain.hasHeader("Content-Encoding"));
+    EXPECT_FALSE(plain.hasHeader("Vary"));
+}
+
+TEST(AcceptEncodingTest, QValuesAndWildcard)
+{
+    using ResponseGenerator::acceptsEncoding;
+
+    EXPECT_TRUE(acceptsEncoding("gzip", "gzip"));
+    EXPECT_TRUE(acceptsEncoding("deflate, GZIP;q=0.5", "gzip"));
+    EXPECT_FALSE(acceptsEncoding("gzip;q=0", "gzip"));
+    EXPECT_FALSE(acceptsEncoding("", "gzip"));
+    EXPECT_TRUE(acceptsEncoding("*", "br"));
+    EXPECT_FALSE(acceptsEncoding("*, br;q=0", "br"));
+    EXPECT_FALSE(acceptsEncoding("*;q=0", "gzip"));
+}
+
+class GzipTest : public ResponseGeneratorTest
+{
+  protected:
+    void SetUp() override
+    {
+        ctx.allowed_methods = {HttpMethod::GET};
+        ctx.gzip.enabled = true;
+        ctx.gzip.types = {"text/css"};
+    }
+
+    ResponseData get(const std::string& path, const std::string& acceptEncoding,
+                     const std::string& ifNoneMatch = "")
+    {
+        RawRequest rawReq;
+        rawReq.setMethod(HttpMethod::GET);
+        rawReq.setUri("/");
+        if (!acceptEncoding.empty())
+            rawReq.addHeader("Accept-Encoding", acceptEncoding);
+        if (!ifNoneMatch.empty())
+            rawReq.addHeader("If-None-Match", ifNoneMatch);
+
+        ctx.resolved_path = path;
+        RawResponse rawResp;
+        ResponseGenerator::genResponse(rawReq, ctx, rawResp, cgiRes);
+        return rawResp.toResponseData();
+    }
+};
+
+TEST_F(GzipTest, FilesAreStreamedChunked)
+{
+    ResponseData data = get("./assets/www/site1/index.html", "gzip");
+
+    EXPECT_EQ(data.getHeader("Content-Encoding"), "gzip");
+    EXPECT_EQ(data.getHeader("Transfer-Encoding"), "chunked");
+    EXPECT_EQ(data.getHeader("Vary"), "Accept-Encoding");
+    EXPECT_FALSE(data.hasHeader("Content-Length"));
+    EXPECT_FALSE(data.hasHeader("Accept-Ranges"));
+    EXPECT_EQ(data.getHeader("ETag").compare(0, 2, "W/"), 0);
+    EXPECT_TRUE(data.stream != nullptr);
+    EXPECT_FALSE(data.file.isSet());
+}
+
+TEST_F(GzipTest, InMemoryBodiesKeepAContentLength)
+{
+    ctx.autoindex_enabled = true;
+    ctx.index_files = {};
+    ctx.gzip.minLength = 1;
+    ResponseData data = get("./assets/www/site1/", "gzip");
+
+    EXPECT_EQ(data.getHeader("Content-Encoding"), "gzip");
+    EXPECT_EQ(data.getHeader("Content-Length"), std::to_string(data.body.size()));
+    EXPECT_EQ(data.body.compare(0, 2, "\x1f\x8b"), 0);
+}
+
+TEST_F(GzipTest, NotCompressedWhenNotWanted)
+{
+    EXPECT_FALSE(get("./assets/www/site1/index.html", "").hasHeader("Content-Encoding"));
+    EXPECT_FALSE(get("./assets/www/site1/index.html", "gzip;q=0").hasHeader("Content-Encoding"));
+
+    ctx.gzip.minLength = 1000000;
+    EXPECT_FALSE(get("./assets/www/site1/index.html", "gzip").hasHeader("Content-Encoding"));
+
+    ctx.gzip.minLength = 20;
+    ctx.gzip.types = {};
+    EXPECT_FALSE(get("./assets/www/site1/style.css", "gzip").hasHeader("Content-Encoding"));
+    ctx.gzip.types = {"text/css"};
+    EXPECT_TRUE(get("./assets/www/site1/style.css", "gzip").hasHeader("Content-Encoding"));
+}
+
+TEST_F(GzipTest, ErrorPagesUseTheirPrebuiltVariant)
+{
+    ResponseData data = get("./assets/www/site1/missing.html", "gzip");
+    EXPECT_EQ(data.statusCode, 404);
+    ASSERT_TRUE(data.cachedHeaders && data.cachedBody);
+    EXPECT_NE(data.cachedHeaders->find("Content-Encoding: gzip\r\n"),
+              std::string::npos);
+    EXPECT_EQ(data.cachedBody->compare(0, 2, "\x1f\x8b"), 0);
+    EXPECT_EQ(data.cachedBody,
+              ErrorPages::defaultPage(HttpStatusCode::NotFound).gzipped->body);
+
+    ResponseData plain = get("./assets/www/site1/missing.html", "");
+    ASSERT_TRUE(plain.cachedHeaders);
+    EXPECT_EQ(plain.cachedHeaders->find("Content-Encoding"), std::string::npos);
+
+    ctx.gzip.minLength = 1000000;
+    data = get("./assets/www/site1/missing.html", "gzip");
+    EXPECT_EQ(data.cachedBody, ErrorPages::defaultPage(HttpStatusCode::NotFound).body);
+}
+
+// RFC 7232, 4.1: the 304 has the validators the 200 would have had
+TEST_F(GzipTest, NotModifiedMatchesTheVariant)
+{
+    const std::string path = "./assets/www/site1/index.html";
+
+    ResponseData gzipped = get(path, "gzip");
+    const std::string weak = gzipped.getHeader("ETag");
+    ASSERT_EQ(weak.compare(0, 2, "W/"), 0);
+
+    ResponseData notModified = get(path, "gzip", weak);
+    EXPECT_EQ(notModified.statusCode, 304);
+    EXPECT_EQ(notModified.getHeader("ETag"), weak);
+    EXPECT_EQ(notModified.getHeader("Vary"), "Accept-Encoding");
+
+    ResponseData plain = get(path, "");
+    const std::string strong = plain.getHeader("ETag");
+    EXPECT_EQ(strong, weak.substr(2));
+    EXPECT_EQ(plain.getHeader("Vary"), "Accept-Encoding");
+
+    ResponseData plainNotModified = get(path, "", strong);
+    EXPECT_EQ(plainNotModified.statusCode, 304);
+    EXPECT_EQ(plainNotModified.getHeader("ETag"), strong);
+    EXPECT_EQ(plainNotModified.getHeader("Vary"), "Accept-Encoding");
+
+    // Not a type gzip applies to: nothing varies
+    ctx.gzip.types = {};
+    EXPECT_FALSE(get("./assets/www/site1/style.css", "gzip").hasHeader("Vary"));
+}
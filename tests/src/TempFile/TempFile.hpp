@@ -0,0 +1,70 @@
+#pragma once
+
+#ifndef TEMPFILE_HPP
+# define TEMPFILE_HPP
+
+# include <gtest/gtest.h>
+# include <fstream>
+# include <memory>
+# include <string>
+# include <unistd.h>
+
+// A file in /tmp with the given contents, removed when it goes out of
+// scope
+class TempFile
+{
+  public:
+    explicit TempFile(const std::string& contents = "")
+    {
+        char tmpl[] = "/tmp/webserv_test_XXXXXX";
+        int fd = mkstemp(tmpl);
+        EXPECT_NE(fd, -1);
+        if (fd != -1)
+            close(fd);
+        m_path = tmpl;
+        write(contents);
+    }
+
+    TempFile(const TempFile& other) = delete;
+    TempFile& operator=(const TempFile& other) = delete;
+    ~TempFile() { unlink(m_path.c_str()); }
+
+    const std::string& path() const { return m_path; }
+
+    void write(const std::string& contents) const
+    {
+        std::ofstream(m_path, std::ios::binary | std::ios::trunc) << contents;
+    }
+
+  private:
+    std::string m_path;
+};
+
+// Fixture owning a TempFile, created with the given contents before
+// each test and removed after it
+class TempFileTest : public ::testing::Test
+{
+  protected:
+    std::string path;
+
+    explicit TempFileTest(std::string initialContents = "")
+      : m_initialContents(std::move(initialContents))
+    {
+    }
+
+    void SetUp() override
+    {
+        m_file = std::make_unique<TempFile>(m_initialContents);
+        path = m_file->path();
+    }
+
+    void TearDown() override { m_file.reset(); }
+
+    void writeFile(const std::string& contents) { m_file->write(contents); }
+
+  private:
+    std::string m_initialContents;
+    std::unique_ptr<TempFile> m_file;
+};
+
+#endif
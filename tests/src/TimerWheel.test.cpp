@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include "TimerWheel.hpp"
+
+// Time is simulated: advance() is given instants relative to creation
+class TimerWheelTest : public ::testing::Test
+{
+  protected:
+    TimerWheel wheel;
+    uint64_t start = TimerWheel::nowMs();
+};
+
+TEST_F(TimerWheelTest, FiresOnlyOnceDue)
+{
+    int fired = 0;
+    TimerNode node;
+    node.onExpire = [&fired]() { ++fired; };
+
+    wheel.arm(node, 500);
+    EXPECT_FALSE(wheel.empty());
+    EXPECT_GT(wheel.nextTimeoutMs(), 300);
+    EXPECT_LE(wheel.nextTimeoutMs(), 500);
+
+    wheel.advance(start + 300);
+    EXPECT_EQ(fired, 0);
+
+    wheel.advance(start + 700);
+    EXPECT_EQ(fired, 1);
+    EXPECT_FALSE(node.isArmed());
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.nextTimeoutMs(), -1);
+}
+
+TEST_F(TimerWheelTest, DisarmedTimerDoesNotFire)
+{
+    int fired = 0;
+    TimerNode node;
+    node.onExpire = [&fired]() { ++fired; };
+
+    wheel.arm(node, 100);
+    node.disarm();
+    wheel.advance(start + 1000);
+    EXPECT_EQ(fired, 0);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, RearmingPostponesExpiry)
+{
+    int fired = 0;
+    TimerNode node;
+    node.onExpire = [&fired]() { ++fired; };
+
+    wheel.arm(node, 500);
+    wheel.advance(start + 400);
+    wheel.arm(node, 500);
+    wheel.advance(start + 700);
+    EXPECT_EQ(fired, 0);
+
+    wheel.advance(start + 1100);
+    EXPECT_EQ(fired, 1);
+}
+
+TEST_F(TimerWheelTest, TimerLongerThanOneRevolution)
+{
+    int fired = 0;
+    TimerNode node;
+    node.onExpire = [&fired]() { ++fired; };
+
+    uint64_t revolution = TimerWheel::TICK_MS * TimerWheel::SLOTS;
+    wheel.arm(node, revolution * 2 + 300);
+
+    for (uint64_t t = 0; t <= revolution * 2; t += TimerWheel::TICK_MS)
+        wheel.advance(start + t);
+    EXPECT_EQ(fired, 0);
+
+    wheel.advance(start + revolution * 2 + 500);
+    EXPECT_EQ(fired, 1);
+}
+
+// An idle keep-alive connection doesn't wake the reactor every tick
+TEST_F(TimerWheelTest, TimeoutRunsToTheEarliestExpiry)
+{
+    TimerNode near;
+    TimerNode far;
+
+    wheel.arm(far, 60000);
+    EXPECT_GT(wheel.nextTimeoutMs(), 59000);
+    EXPECT_LE(wheel.nextTimeoutMs(), 60000);
+
+    wheel.arm(near, 200);
+    EXPECT_LE(wheel.nextTimeoutMs(), 200);
+
+    // Still the bound until it has passed, then the far timer again
+    near.disarm();
+    EXPECT_LE(wheel.nextTimeoutMs(), 200);
+    wheel.advance(start + 300);
+    EXPECT_TRUE(far.isArmed());
+    EXPECT_GT(wheel.nextTimeoutMs(), 59000);
+}
+
+TEST_F(TimerWheelTest, DestroyedNodeLeavesTheWheel)
+{
+    auto node = std::make_unique<TimerNode>();
+    wheel.arm(*node, 100);
+    node.reset();
+    EXPECT_TRUE(wheel.empty());
+    wheel.advance(start + 1000);
+}
+
+TEST_F(TimerWheelTest, CallbackMayDestroyOtherDueTimers)
+{
+    int fired = 0;
+    auto first = std::make_unique<TimerNode>();
+    auto second = std::make_unique<TimerNode>();
+
+    first->onExpire = [&]() { ++fired; second.reset(); };
+    second->onExpire = [&]() { ++fired; first.reset(); };
+    wheel.arm(*first, 100);
+    wheel.arm(*second, 100);
+
+    wheel.advance(start + 500);
+    EXPECT_EQ(fired, 1);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, CopiesAreNotArmed)
+{
+    TimerNode node;
+    node.onExpire = []() {};
+    wheel.arm(node, 100);
+
+    TimerNode copy(node);
+    EXPECT_TRUE(node.isArmed());
+    EXPECT_FALSE(copy.isArmed());
+    EXPECT_TRUE(static_cast<bool>(copy.onExpire));
+}
@@ -1117,3 +1117,382 @@ TEST(ValidatorTest, LimitExceptOutsideOfLocation)
 
     EXPECT_THROW(Validator::validate(rootNode), DirectiveContextException);
 }
+
+TEST(ValidatorTest, ValidArgumentsForWorkerThreads)
+{
+    for (const char* arg : {"4", "auto"})
+    {
+        auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+        auto workerThreads
+            = createSimpleDirective(Directives::WORKER_THREADS, {arg});
+        auto http = createBlockDirective(Directives::HTTP);
+        auto server = createBlockDirective(Directives::SERVER);
+
+        http->addDirective(std::move(server));
+        global->addDirective(std::move(workerThreads));
+        global->addDirective(std::move(http));
+
+        std::unique_ptr<Directive>& rootNode
+            = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+        EXPECT_NO_THROW(Validator::validate(rootNode));
+    }
+}
+
+TEST(ValidatorTest, InvalidArgumentsForWorkerThreads)
+{
+    for (const char* arg : {"0", "-2", "many"})
+    {
+        auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+        auto workerThreads
+            = createSimpleDirective(Directives::WORKER_THREADS, {arg});
+        auto http = createBlockDirective(Directives::HTTP);
+        auto server = createBlockDirective(Directives::SERVER);
+
+        http->addDirective(std::move(server));
+        global->addDirective(std::move(workerThreads));
+        global->addDirective(std::move(http));
+
+        std::unique_ptr<Directive>& rootNode
+            = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+        EXPECT_THROW(Validator::validate(rootNode), InvalidArgumentException);
+    }
+}
+
+TEST(ValidatorTest, WorkerThreadsOutsideOfGlobalContext)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+    auto workerThreads
+        = createSimpleDirective(Directives::WORKER_THREADS, {"2"});
+
+    http->addDirective(std::move(workerThreads));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), DirectiveContextException);
+}
+
+TEST(ValidatorTest, ValidArgumentsForWorkerProcesses)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto workerProcesses
+        = createSimpleDirective(Directives::WORKER_PROCESSES, {"auto"});
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(workerProcesses));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_NO_THROW(Validator::validate(rootNode));
+}
+
+TEST(ValidatorTest, WorkerProcessesOutsideOfGlobalContext)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+    auto workerProcesses
+        = createSimpleDirective(Directives::WORKER_PROCESSES, {"4"});
+
+    server->addDirective(std::move(workerProcesses));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), DirectiveContextException);
+}
+
+TEST(ValidatorTest, InvalidArgumentsForEdgeTriggered)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto edgeTriggered
+        = createSimpleDirective(Directives::EDGE_TRIGGERED, {"yes"});
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(edgeTriggered));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), InvalidArgumentException);
+}
+
+TEST(ValidatorTest, InvalidArgumentsForEventBackend)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto eventBackend
+        = createSimpleDirective(Directives::EVENT_BACKEND, {"kqueue"});
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(eventBackend));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), InvalidArgumentException);
+}
+
+TEST(ValidatorTest, ValidTimeouts)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(
+        createSimpleDirective(Directives::CLIENT_HEADER_TIMEOUT, {"10s"}));
+    http->addDirective(
+        createSimpleDirective(Directives::CLIENT_BODY_TIMEOUT, {"500ms"}));
+    http->addDirective(createSimpleDirective(Directives::SEND_TIMEOUT, {"1m"}));
+    http->addDirective(
+        createSimpleDirective(Directives::KEEPALIVE_TIMEOUT, {"75"}));
+    http->addDirective(createSimpleDirective(Directives::CGI_TIMEOUT, {"20s"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_NO_THROW(Validator::validate(rootNode));
+}
+
+TEST(ValidatorTest, InvalidArgumentsForTimeout)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(
+        createSimpleDirective(Directives::KEEPALIVE_TIMEOUT, {"10 seconds"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), InvalidArgumentException);
+}
+
+TEST(ValidatorTest, TimeoutInServerContext)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    server->addDirective(createSimpleDirective(Directives::CGI_TIMEOUT, {"5s"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), DirectiveContextException);
+}
+
+TEST(ValidatorTest, ValidOpenFileCache)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(
+        createSimpleDirective(Directives::OPEN_FILE_CACHE, {"1000"}));
+    http->addDirective(
+        createSimpleDirective(Directives::OPEN_FILE_CACHE_VALID, {"30s"}));
+    http->addDirective(
+        createSimpleDirective(Directives::OPEN_FILE_CACHE_MIN_USES, {"2"}));
+    http->addDirective(
+        createSimpleDirective(Directives::OPEN_FILE_CACHE_ERRORS, {"on"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_NO_THROW(Validator::validate(rootNode));
+}
+
+TEST(ValidatorTest, InvalidArgumentsForOpenFileCache)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(createSimpleDirective(Directives::OPEN_FILE_CACHE, {"0"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), InvalidArgumentException);
+}
+
+TEST(ValidatorTest, ValidResponseCache)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(
+        createSimpleDirective(Directives::RESPONSE_CACHE, {"10m"}));
+    http->addDirective(
+        createSimpleDirective(Directives::RESPONSE_CACHE_MAX_FILE, {"128k"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_NO_THROW(Validator::validate(rootNode));
+}
+
+TEST(ValidatorTest, ResponseCacheOutsideHttp)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    server->addDirective(
+        createSimpleDirective(Directives::RESPONSE_CACHE, {"10m"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), DirectiveContextException);
+}
+
+TEST(ValidatorTest, ValidGzipStatic)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+    auto location = createBlockDirective(Directives::LOCATION, {"/assets/"});
+
+    http->addDirective(createSimpleDirective(Directives::GZIP_STATIC, {"on"}));
+    location->addDirective(
+        createSimpleDirective(Directives::GZIP_STATIC, {"always"}));
+    server->addDirective(std::move(location));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_NO_THROW(Validator::validate(rootNode));
+}
+
+TEST(ValidatorTest, InvalidArgumentsForGzipStatic)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    server->addDirective(
+        createSimpleDirective(Directives::GZIP_STATIC, {"sometimes"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), InvalidArgumentException);
+}
+
+TEST(ValidatorTest, ValidGzip)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(createSimpleDirective(Directives::GZIP, {"on"}));
+    http->addDirective(createSimpleDirective(
+        Directives::GZIP_TYPES, {"text/css", "application/json"}));
+    http->addDirective(
+        createSimpleDirective(Directives::GZIP_MIN_LENGTH, {"1k"}));
+    server->addDirective(
+        createSimpleDirective(Directives::GZIP_COMP_LEVEL, {"9"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_NO_THROW(Validator::validate(rootNode));
+}
+
+TEST(ValidatorTest, InvalidArgumentsForGzipCompLevel)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(
+        createSimpleDirective(Directives::GZIP_COMP_LEVEL, {"10"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), InvalidArgumentException);
+}
+
+TEST(ValidatorTest, ValidBodyBuffering)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+    auto location = createBlockDirective(Directives::LOCATION, {"/upload"});
+
+    http->addDirective(
+        createSimpleDirective(Directives::CLIENT_BODY_BUFFER_SIZE, {"16k"}));
+    server->addDirective(
+        createSimpleDirective(Directives::CLIENT_BODY_TEMP_PATH, {"/tmp"}));
+    location->addDirective(
+        createSimpleDirective(Directives::CLIENT_BODY_BUFFER_SIZE, {"1M"}));
+    server->addDirective(std::move(location));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_NO_THROW(Validator::validate(rootNode));
+}
+
+TEST(ValidatorTest, InvalidArgumentsForClientBodyBufferSize)
+{
+    auto global = createBlockDirective(Directives::GLOBAL_CONTEXT);
+    auto http = createBlockDirective(Directives::HTTP);
+    auto server = createBlockDirective(Directives::SERVER);
+
+    http->addDirective(
+        createSimpleDirective(Directives::CLIENT_BODY_BUFFER_SIZE, {"lots"}));
+    http->addDirective(std::move(server));
+    global->addDirective(std::move(http));
+
+    std::unique_ptr<Directive>& rootNode
+        = reinterpret_cast<std::unique_ptr<Directive>&>(global);
+
+    EXPECT_THROW(Validator::validate(rootNode), InvalidArgumentException);
+}